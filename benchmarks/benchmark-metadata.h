@@ -282,6 +282,10 @@ namespace LinBox {
 #ifdef HAVE_CXX11
 #include <unordered_map>
 #endif
+#include <fstream>
+#include <thread>
+#include <ctime>
+#include <sys/utsname.h>
 
 namespace LinBox {
 
@@ -293,7 +297,7 @@ namespace LinBox {
 	class FieldMetaData ;
 	// class SolutionMetaData ;
 	class AlgorithmMetaData ;
-	class EnvrironmentMetaData ;
+	class EnvironmentMetaData ;
 	class BenchmarkMetaData ;
 
 	//! Field metadata
@@ -387,17 +391,99 @@ namespace LinBox {
 
 	} ; // MatrixMetaData
 
-	//! Environment metadata;
+	/*! Environment metadata.
+	 * The machine, the compiler and the build options the timings depend
+	 * on, to be recorded with them (keys of benchmarks/README).
+	 */
 	class EnvironmentMetaData : public MetaData {
 		void initMetadata()
 		{
 			// Machine
+			char date[32];
+			time_t now = time(NULL);
+			strftime(date, sizeof(date), "%Y%b%d", localtime(&now));
+			addValue("date", std::string(date));
+			struct utsname u;
+			if (uname(&u) == 0) {
+				addValue("computer", std::string(u.nodename)+" "+u.sysname+" "+u.release+" "+u.machine);
+			}
+			else
+				addValue("computer");
+			addValue("cpu", cpuModel());
+			addValue("cores", std::thread::hardware_concurrency());
+
 			// compiler
+#ifdef __VERSION__
+			addValue("compiler", std::string(__VERSION__));
+#else
+			addValue("compiler");
+#endif
+			addValue("build", buildOptions());
+		}
+
+		// model name of the first processor (Linux only)
+		static std::string cpuModel()
+		{
+			std::ifstream cpuinfo("/proc/cpuinfo");
+			std::string line;
+			while (std::getline(cpuinfo, line))
+				if (line.compare(0,10,"model name") == 0 && line.find(':') != std::string::npos) {
+					std::string m = line.substr(line.find(':')+1);
+					size_t b = m.find_first_not_of(' ');
+					return (b == std::string::npos) ? std::string("N/A") : m.substr(b);
+				}
+			return "N/A";
+		}
+
+		static std::string buildOptions()
+		{
+			std::string o;
+#ifdef __OPTIMIZE__
+			o += "optimized ";
+#endif
+#ifdef NDEBUG
+			o += "NDEBUG ";
+#endif
+#ifdef __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+			o += "AVX512F ";
+#endif
+#ifdef __LINBOX_HAVE_AVX_INSTRUCTIONS2
+			o += "AVX2 ";
+#endif
+#ifdef __LINBOX_HAVE_SSE4_1_INSTRUCTIONS
+			o += "SSE4.1 ";
+#endif
+#ifdef __LINBOX_USE_OPENMP
+			o += "OpenMP ";
+#endif
+			return o.empty() ? std::string("-") : o.substr(0,o.size()-1);
 		}
+
 	public :
 		EnvironmentMetaData()
 		{
+			setIds("environment");
+			initMetadata();
+			hash();
+		}
+
+		//! some label of the sources (a version, a commit)
+		EnvironmentMetaData(const std::string & version)
+		{
+			setIds("environment");
+			initMetadata();
+			addValue("version", version);
+			hash();
 		}
+
+		void hash()
+		{
+			setHash(hasher(getLocalString()));
+		}
+
+		//! key/value pairs, in order
+		const svector_t & keywords() const { return getKeys(); }
+		const svector_t & values() const { return getVals(); }
 	}; // EnvironmentMetaData
 
 	//! Benchmark metadata;
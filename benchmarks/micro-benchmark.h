@@ -0,0 +1,411 @@
+/* Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file benchmarks/micro-benchmark.h
+ * @ingroup benchmarks
+ * @brief Runner of micro-benchmarks: repetitions, warm-up, percentiles, CSV/JSON output.
+ *
+ * A case is a kernel run \c iter times in a row. Its number of
+ * iterations is increased until a sample lasts at least the minimum time,
+ * then after some warm-up samples the case is timed \c repetitions times:
+ * the statistics are those of the time per iteration over the samples.
+ *
+ * The CSV output follows benchmarks/README (metadata, \c end, column
+ * labels, one line per case) and can be read back by
+ * MicroBenchmark::readCSV to compare two versions (see compare()).
+ */
+
+#ifndef __LINBOX_benchmarks_micro_benchmark_H
+#define __LINBOX_benchmarks_micro_benchmark_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <sys/utsname.h>
+
+namespace LinBox
+{
+
+	/// keeps the computation of v from being optimized away
+	template<class T>
+	inline void benchmarkKeep (const T &v)
+	{
+#if defined(__GNUC__)
+		asm volatile("" : : "g"(&v) : "memory");
+#else
+		static volatile const void *sink;
+		sink = &v;
+#endif
+	}
+
+	/// statistics of the times by iteration (in ns) of the samples of a case
+	struct MicroBenchmarkStats {
+		MicroBenchmarkStats () :
+			iterations(0), repetitions(0), min(0), p10(0), median(0), p90(0), max(0), mean(0), stddev(0)
+		{}
+
+		uint64_t    iterations; //!< iterations by sample
+		size_t     repetitions; //!< number of samples
+		double min, p10, median, p90, max, mean, stddev;
+
+		/// percentile q (in [0,1]) of sorted values, linear interpolation
+		static double percentile (const std::vector<double> &sorted, double q)
+		{
+			if (sorted.empty()) return 0;
+			double pos = q*(double)(sorted.size()-1);
+			size_t i = (size_t)pos;
+			if (i+1 >= sorted.size()) return sorted.back();
+			return sorted[i] + (pos-(double)i)*(sorted[i+1]-sorted[i]);
+		}
+
+		/// quantile 0.975 of the Student distribution with df degrees of freedom
+		static double student975 (size_t df)
+		{
+			static const double t[] = { 0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+				2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+				2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+			if (df == 0) return 0;
+			if (df <= 30) return t[df];
+			return 1.960 + 2.4/(double)df;
+		}
+
+		/// half width of the 95% confidence interval of the mean
+		double ci95 () const
+		{
+			return (repetitions > 1) ? student975(repetitions-1)*stddev/std::sqrt((double)repetitions) : 0;
+		}
+
+		void compute (std::vector<double> t)
+		{
+			repetitions = t.size();
+			if (t.empty()) return;
+			std::sort(t.begin(), t.end());
+			min = t.front();
+			max = t.back();
+			p10 = percentile(t, 0.1);
+			median = percentile(t, 0.5);
+			p90 = percentile(t, 0.9);
+			double s = 0, s2 = 0;
+			for (size_t i = 0; i < t.size(); ++i) s += t[i];
+			mean = s/(double)t.size();
+			for (size_t i = 0; i < t.size(); ++i) s2 += (t[i]-mean)*(t[i]-mean);
+			stddev = (t.size() > 1) ? std::sqrt(s2/(double)(t.size()-1)) : 0;
+		}
+	};
+
+	/** \brief Registers and times the cases of a micro-benchmark suite.
+	 \code
+	 MicroBenchmark B("field kernels");
+	 B.add("dot", "n=1000", 1000, [&](uint64_t iter) {
+	 	for (uint64_t i = 0; i < iter; ++i) benchmarkKeep(VD.dot(r,x,y));
+	 });
+	 B.run();
+	 B.writeCSV(std::cout);
+	 \endcode
+	 */
+	class MicroBenchmark {
+	public:
+		typedef std::function<void(uint64_t)> Kernel; //!< runs its argument iterations
+
+		struct Case {
+			std::string          name; //!< e.g. "FieldAXPY/Modular<double>"
+			std::string        params; //!< e.g. "n=1000"
+			double              items; //!< work by iteration (items/s is reported), 0 if none
+			Kernel             kernel;
+			MicroBenchmarkStats stats;
+		};
+
+		size_t          repetitions; //!< timed samples by case
+		size_t               warmup; //!< untimed samples by case
+		double              minTime; //!< minimal duration of a sample (s)
+		std::string          filter; //!< only the cases whose name contains it are run
+
+		MicroBenchmark (const std::string &problem) :
+			repetitions(10), warmup(1), minTime(0.01), _problem(problem)
+		{}
+
+		void add (const std::string &name, const std::string &params, double items, const Kernel &kernel)
+		{
+			Case c;
+			c.name = name; c.params = params; c.items = items; c.kernel = kernel;
+			_cases.push_back(c);
+		}
+
+		/// metadata written with the results (key, value)
+		void addMetaData (const std::string &key, const std::string &value) { _meta.push_back(std::make_pair(key,value)); }
+
+		const std::vector<Case> &cases () const { return _cases; }
+
+		bool selected (const Case &c) const { return filter.empty() || (c.name+" "+c.params).find(filter) != std::string::npos; }
+
+		/// runs the selected cases, one line by case on log
+		void run (std::ostream &log = std::cout)
+		{
+			for (size_t k = 0; k < _cases.size(); ++k) {
+				Case &c = _cases[k];
+				if (!selected(c)) continue;
+				uint64_t iter = 1;
+				for (double t = sample(c, iter); t < minTime && iter < ((uint64_t)1 << 40); t = sample(c, iter)) {
+					// aim at 1.5 minTime directly when the sample is long enough to be measured
+					if (t > minTime/100)
+						iter = std::max(2*iter, (uint64_t)(1.5*minTime/t*(double)iter));
+					else
+						iter *= 10;
+				}
+				for (size_t w = 0; w < warmup; ++w) sample(c, iter);
+				std::vector<double> t(repetitions);
+				for (size_t r = 0; r < repetitions; ++r)
+					t[r] = sample(c, iter)*1e9/(double)iter;
+				c.stats.compute(t);
+				c.stats.iterations = iter;
+				log << std::left << std::setw(48) << (c.name+" "+c.params) << std::right
+				    << std::fixed << std::setprecision(1) << std::setw(14) << c.stats.median << " ns"
+				    << "  [" << c.stats.p10 << ", " << c.stats.p90 << "]"
+				    << std::setw(10) << iter << " it" << std::endl;
+			}
+		}
+
+		/// CSV in the format of benchmarks/README
+		std::ostream &writeCSV (std::ostream &os) const
+		{
+			os << "problem, " << _problem << std::endl;
+			std::vector<std::pair<std::string,std::string> > m = environment();
+			for (size_t i = 0; i < m.size(); ++i)
+				os << m[i].first << ", " << m[i].second << std::endl;
+			os << "end, metadata" << std::endl;
+			os << "name, params, iterations, repetitions, min, p10, median, p90, max, mean, stddev, items/s, ci95" << std::endl;
+			os << std::defaultfloat << std::setprecision(6);
+			for (size_t k = 0; k < _cases.size(); ++k) {
+				const Case &c = _cases[k];
+				const MicroBenchmarkStats &s = c.stats;
+				if (!s.repetitions) continue;
+				os << c.name << ", " << c.params << ", " << s.iterations << ", " << s.repetitions << ", "
+				   << s.min << ", " << s.p10 << ", " << s.median << ", " << s.p90 << ", "
+				   << s.max << ", " << s.mean << ", " << s.stddev << ", ";
+				if (c.items > 0) os << c.items*1e9/s.median; else os << "-";
+				os << ", " << s.ci95() << std::endl;
+			}
+			return os;
+		}
+
+		/// JSON, close to the output of Google Benchmark
+		std::ostream &writeJSON (std::ostream &os) const
+		{
+			os << "{" << std::endl << "  \"context\": {" << std::endl;
+			os << "    \"problem\": \"" << escape(_problem) << "\"";
+			std::vector<std::pair<std::string,std::string> > m = environment();
+			for (size_t i = 0; i < m.size(); ++i)
+				os << "," << std::endl << "    \"" << escape(m[i].first) << "\": \"" << escape(m[i].second) << "\"";
+			os << std::endl << "  }," << std::endl << "  \"benchmarks\": [";
+			os << std::defaultfloat << std::setprecision(6);
+			bool first = true;
+			for (size_t k = 0; k < _cases.size(); ++k) {
+				const Case &c = _cases[k];
+				const MicroBenchmarkStats &s = c.stats;
+				if (!s.repetitions) continue;
+				os << (first ? "" : ",") << std::endl << "    {\"name\": \"" << escape(c.name)
+				   << "\", \"params\": \"" << escape(c.params)
+				   << "\", \"iterations\": " << s.iterations << ", \"repetitions\": " << s.repetitions
+				   << ", \"time_unit\": \"ns\", \"min\": " << s.min << ", \"p10\": " << s.p10
+				   << ", \"median\": " << s.median << ", \"p90\": " << s.p90 << ", \"max\": " << s.max
+				   << ", \"mean\": " << s.mean << ", \"stddev\": " << s.stddev << ", \"ci95\": " << s.ci95();
+				if (c.items > 0) os << ", \"items_per_second\": " << c.items*1e9/s.median;
+				os << "}";
+				first = false;
+			}
+			os << std::endl << "  ]" << std::endl << "}" << std::endl;
+			return os;
+		}
+
+		/** reads the cases of a CSV written by writeCSV.
+		 * @return false if the file has no metadata/column labels
+		 */
+		static bool readCSV (std::istream &is, std::map<std::string,MicroBenchmarkStats> &res)
+		{
+			std::string line;
+			bool body = false, labels = false;
+			while (std::getline(is, line)) {
+				if (line.empty() || line.compare(0,2,"//") == 0) continue;
+				std::vector<std::string> f = split(line);
+				if (!body) {
+					if (!f.empty() && f[0] == "end") body = true;
+					continue;
+				}
+				if (!labels) { labels = true; continue; }
+				if (f.size() < 11) continue;
+				MicroBenchmarkStats s;
+				s.iterations = std::strtoull(f[2].c_str(), NULL, 10);
+				s.repetitions = (size_t)std::strtoul(f[3].c_str(), NULL, 10);
+				double *v[] = { &s.min, &s.p10, &s.median, &s.p90, &s.max, &s.mean, &s.stddev };
+				for (size_t i = 0; i < 7; ++i) *v[i] = std::strtod(f[4+i].c_str(), NULL);
+				res[f[0]+" "+f[1]] = s;
+			}
+			return labels;
+		}
+
+		/** compares the cases with a baseline read by readCSV.
+		 * A case regresses when its median is more than threshold (e.g.
+		 * 0.05) slower and the spreads [p10,p90] of both runs are
+		 * disjoint, so that noisy cases do not fail the comparison.
+		 * @return the number of regressions
+		 */
+		size_t compare (const std::map<std::string,MicroBenchmarkStats> &base, double threshold, std::ostream &os) const
+		{
+			size_t bad = 0;
+			for (size_t k = 0; k < _cases.size(); ++k) {
+				const Case &c = _cases[k];
+				if (!c.stats.repetitions) continue;
+				std::map<std::string,MicroBenchmarkStats>::const_iterator it = base.find(c.name+" "+c.params);
+				if (it == base.end()) continue;
+				double ratio = c.stats.median/it->second.median;
+				bool slower = ratio > 1+threshold && c.stats.p10 > it->second.p90;
+				bool faster = ratio < 1/(1+threshold) && c.stats.p90 < it->second.p10;
+				os << std::left << std::setw(48) << (c.name+" "+c.params) << std::right
+				   << std::fixed << std::setprecision(3) << std::setw(8) << ratio
+				   << (slower ? "  REGRESSION" : (faster ? "  improvement" : "")) << std::endl;
+				if (slower) ++bad;
+			}
+			return bad;
+		}
+
+		/** compares the mean times with a baseline read by readCSV.
+		 * For the long cases (a few samples of one iteration): a case
+		 * regresses when its mean is more than threshold slower and the
+		 * difference is significant (Welch's t-test at 95%). The 95%
+		 * confidence interval of the difference is reported.
+		 * @return the number of regressions
+		 */
+		size_t compareMeans (const std::map<std::string,MicroBenchmarkStats> &base, double threshold, std::ostream &os) const
+		{
+			size_t bad = 0;
+			for (size_t k = 0; k < _cases.size(); ++k) {
+				const Case &c = _cases[k];
+				const MicroBenchmarkStats &a = c.stats;
+				if (!a.repetitions) continue;
+				std::map<std::string,MicroBenchmarkStats>::const_iterator it = base.find(c.name+" "+c.params);
+				if (it == base.end() || it->second.mean <= 0) continue;
+				const MicroBenchmarkStats &b = it->second;
+				double va = a.stddev*a.stddev/(double)a.repetitions, vb = b.stddev*b.stddev/(double)b.repetitions;
+				double se = std::sqrt(va+vb), diff = a.mean-b.mean;
+				// Welch-Satterthwaite degrees of freedom
+				size_t df = 1;
+				if (se > 0 && a.repetitions > 1 && b.repetitions > 1)
+					df = (size_t)std::max(1.0, (va+vb)*(va+vb)/(va*va/(double)(a.repetitions-1)+vb*vb/(double)(b.repetitions-1)));
+				double h = MicroBenchmarkStats::student975(df)*se;
+				bool slower = diff > threshold*b.mean && diff-h > 0;
+				bool faster = -diff > threshold*b.mean && diff+h < 0;
+				os << std::left << std::setw(48) << (c.name+" "+c.params) << std::right
+				   << std::fixed << std::setprecision(1) << std::setw(8) << 100*diff/b.mean << "% ["
+				   << 100*(diff-h)/b.mean << "%, " << 100*(diff+h)/b.mean << "%]"
+				   << (slower ? "  REGRESSION" : (faster ? "  improvement" : "")) << std::endl;
+				if (slower) ++bad;
+			}
+			return bad;
+		}
+
+	protected:
+		std::string                                          _problem;
+		std::vector<Case>                                      _cases;
+		std::vector<std::pair<std::string,std::string> >        _meta;
+
+		// duration (s) of iter iterations
+		static double sample (Case &c, uint64_t iter)
+		{
+			std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+			c.kernel(iter);
+			std::chrono::duration<double> d = std::chrono::steady_clock::now() - t0;
+			return d.count();
+		}
+
+		std::vector<std::pair<std::string,std::string> > environment () const
+		{
+			std::vector<std::pair<std::string,std::string> > m;
+			char date[32];
+			time_t now = time(NULL);
+			strftime(date, sizeof(date), "%Y%b%d", localtime(&now));
+			m.push_back(std::make_pair("date", std::string(date)));
+			struct utsname u;
+			if (uname(&u) == 0)
+				m.push_back(std::make_pair("computer", std::string(u.nodename)+" "+u.sysname+" "+u.release+" "+u.machine));
+			std::ostringstream s;
+			s << std::thread::hardware_concurrency() << " hardware threads";
+			m.push_back(std::make_pair("comment", s.str()));
+			m.push_back(std::make_pair("threads", std::string("1")));
+			m.push_back(std::make_pair("time unit", std::string("ns by iteration")));
+			std::ostringstream r;
+			r << repetitions << " samples of at least " << minTime << " s after " << warmup << " warm-up samples";
+			m.push_back(std::make_pair("repetitions", r.str()));
+			// the added metadata replace the default values
+			for (size_t i = 0; i < _meta.size(); ++i) {
+				size_t j = 0;
+				while (j < m.size() && m[j].first != _meta[i].first) ++j;
+				if (j < m.size()) m[j].second = _meta[i].second;
+				else m.push_back(_meta[i]);
+			}
+			return m;
+		}
+
+		static std::vector<std::string> split (const std::string &line)
+		{
+			std::vector<std::string> f;
+			std::istringstream is(line);
+			std::string s;
+			while (std::getline(is, s, ',')) {
+				size_t b = s.find_first_not_of(" \t"), e = s.find_last_not_of(" \t\r");
+				f.push_back(b == std::string::npos ? std::string() : s.substr(b, e-b+1));
+			}
+			return f;
+		}
+
+		static std::string escape (const std::string &s)
+		{
+			std::string r;
+			for (size_t i = 0; i < s.size(); ++i) {
+				if (s[i] == '"' || s[i] == '\\') r += '\\';
+				r += s[i];
+			}
+			return r;
+		}
+	};
+
+} // LinBox
+
+#endif // __LINBOX_benchmarks_micro_benchmark_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -41,6 +41,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/perf-counters.h"
 #include "linbox/blackbox/archetype.h"
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/vector/vector-domain.h"
@@ -65,6 +66,7 @@ public:
 		linbox_check( M2.coldim() == M3.rowdim());
 		linbox_check( M1.coldim() == M3.coldim());
 
+		LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, M3.coldim());
 		MatrixDomain<Field> MD(F);
 		typename Block::ColIterator        p1 = M1.colBegin();
 		typename Block::ConstColIterator   p3 = M3.colBegin();
@@ -76,16 +78,19 @@ public:
 
 	static void mul (const Field& F,
 			 Block &M1, const SparseMatrix<Field,SparseMatrixFormat::TPL> &M2, const Block& M3) {
+		LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, M3.coldim());
 		M2.applyLeft(M1,M3);
 	}
 
 	static void mul (const Field& F,
 			 Block &M1, const SparseMatrix<Field,SparseMatrixFormat::TPL_omp> &M2, const Block& M3) {
+		LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, M3.coldim());
 		M2.applyLeft(M1,M3);
 	}
 
 	static void mul (const Field& F,
 	                 Block &M1, const PascalBlackbox<Field> &M2, const Block& M3) {
+		LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, M3.coldim());
 		M2.applyLeft(M1,M3);
 	}
 };
@@ -163,6 +168,11 @@ public:
 		// blackbox of the sequence
 		const Blackbox *getBB () const { return _BB; }
 
+		// left and right projections (the right one is only V before
+		// the sequence is iterated)
+		const Block &getU () const { return _blockU; }
+		const Block &getV () const { return _blockV; }
+
 		// row dimension of the sequence element
 		size_t rowdim() const          { return _m; }
 
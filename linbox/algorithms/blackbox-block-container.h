@@ -447,6 +447,7 @@ namespace LinBox
 			if ( _iter < this->_size) {
 				if ( _case == 1) {
 					this->_BB->applyTranspose(_w,_u);
+					LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 					std::vector<Element> _row_value(this->_n);
 					_BMD.mul(_row_value, _w, _Vcopy);
 					this->_value  = _rep[_iter];
@@ -457,6 +458,7 @@ namespace LinBox
 				}
 				else {
 					this->_BB->applyTranspose(_u,_w);
+					LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 					std::vector<Element> _row_value(this->_n);
 					_BMD.mul(_row_value, _u, _Vcopy);
 					this->_value  = _rep[_iter];
@@ -475,6 +477,7 @@ namespace LinBox
 			if ( _iter < this->_size) {
 				if ( _case == 1) {
 					this->_BB->apply(_w,_u);
+					LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 					std::vector<Element> _col_value(this->_m);
 					_BMD.mul(_col_value, this->_blockU, _w);
 					this->_value  = _rep[_iter];
@@ -485,6 +488,7 @@ namespace LinBox
 				}
 				else {
 					this->_BB->apply(_u,_w);
+					LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 					std::vector<Element> _col_value(this->_m);
 					_BMD.mul(_col_value, this->_blockU, _u);
 					this->_value  = _rep[_iter];
@@ -0,0 +1,193 @@
+/* linbox/algorithms/blackbox-block-pipeline.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+  * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/blackbox-block-pipeline.h
+ * @ingroup algorithms
+ * @brief Block Krylov sequence computed ahead by a pool of threads.
+ */
+
+#ifndef __LINBOX_blackbox_block_pipeline_H
+#define __LINBOX_blackbox_block_pipeline_H
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "linbox/algorithms/blackbox-block-container-base.h"
+
+namespace LinBox
+{
+
+	/** \brief Producer/consumer version of the sequence \f$U A^i V\f$.
+	 *
+	 * A pool of threads computes the elements of the sequence ahead of
+	 * their use and stores them in a ring buffer of \c lookahead slots.
+	 * The columns of V are split among the threads: thread j iterates
+	 * on its own slice \f$A^i V_j\f$ and fills the columns j of each
+	 * element, so that the producers only synchronize on the ring slots.
+	 * The consumer gets the elements in order with \c next(), the
+	 * producers never run more than \c lookahead elements ahead.
+	 *
+	 * With \c nthreads > 1 the blackbox apply is called concurrently and
+	 * must therefore not use mutable temporaries (see e.g. Compose).
+	 */
+	template<class _Field, class _Blackbox>
+	class BlackboxBlockPipeline {
+	public:
+		typedef _Field                         Field;
+		typedef _Blackbox                   Blackbox;
+		typedef BlasMatrix<Field>              Block;
+		typedef BlasMatrix<Field>              Value;
+
+		BlackboxBlockPipeline (const Blackbox *BB, const Field &F, const Block &U, const Block &V,
+				       size_t lookahead, size_t nthreads=1) :
+			_field(&F), _BB(BB), _blockU(U), _m(U.rowdim()), _n(V.coldim())
+			, _lookahead(std::max(lookahead,(size_t)1))
+			, _nthreads(std::max((size_t)1,std::min(nthreads,V.coldim())))
+			, _ring(_lookahead,Value(F,U.rowdim(),V.coldim())), _done(_lookahead,0)
+			, _consumed(0), _stop(false)
+		{
+			linbox_check(U.coldim() == BB->rowdim());
+			linbox_check(V.rowdim() == BB->coldim());
+			for (size_t j = 0; j < _nthreads; ++j) {
+				size_t c0 = j*_n/_nthreads, c1 = (j+1)*_n/_nthreads;
+				_slices.push_back(Block(F,V.rowdim(),c1-c0));
+				for (size_t i = 0; i < V.rowdim(); ++i)
+					for (size_t k = c0; k < c1; ++k)
+						_slices[j].setEntry(i,k-c0,V.getEntry(i,k));
+			}
+			// no destructor if a thread cannot be started: join the others here
+			try {
+				for (size_t j = 0; j < _nthreads; ++j)
+					_workers.push_back(std::thread(&BlackboxBlockPipeline::produce,this,j,j*_n/_nthreads));
+			}
+			catch (...) {
+				stop();
+				throw;
+			}
+		}
+
+		BlackboxBlockPipeline (const BlackboxBlockPipeline&) = delete;
+		BlackboxBlockPipeline &operator= (const BlackboxBlockPipeline&) = delete;
+
+		~BlackboxBlockPipeline () { stop(); }
+
+		/// copy the next element of the sequence into v (blocks until it is ready)
+		void next (Value &v)
+		{
+			size_t s = _consumed % _lookahead;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_ready.wait(lock, [&]{return _done[s] == _nthreads;});
+			}
+			v = _ring[s];
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_done[s] = 0;
+				++_consumed;
+			}
+			_free.notify_all();
+		}
+
+		/// no more elements are needed: stop and join the producers
+		void stop ()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stop = true;
+			}
+			_free.notify_all();
+			for (size_t j = 0; j < _workers.size(); ++j)
+				if (_workers[j].joinable())
+					_workers[j].join();
+		}
+
+		// number of elements given to the consumer
+		size_t size () const { return _consumed; }
+
+		const Field &field () const { return *_field; }
+		size_t rowdim () const { return _m; }
+		size_t coldim () const { return _n; }
+
+	protected:
+
+		// thread j: U A^i V_j for i=0,1,... written in the columns c0.. of the slots
+		void produce (size_t j, size_t c0)
+		{
+			BlasMatrixDomain<Field> BMD(field());
+			Block W[2] = { _slices[j], Block(field(),_slices[j].rowdim(),_slices[j].coldim()) };
+			Block Y(field(),_m,_slices[j].coldim());
+			size_t cur = 0;
+			for (size_t i = 0; ; ++i) {
+				BMD.mul(Y, _blockU, W[cur]);
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_free.wait(lock, [&]{return _stop || i < _consumed+_lookahead;});
+					if (_stop) return;
+				}
+				// the slot is not read before all the slices are there
+				Value &S = _ring[i % _lookahead];
+				for (size_t r = 0; r < _m; ++r)
+					for (size_t k = 0; k < Y.coldim(); ++k)
+						S.setEntry(r,c0+k,Y.getEntry(r,k));
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					if (++_done[i % _lookahead] == _nthreads)
+						_ready.notify_all();
+				}
+				MulHelper<Field,Block>::mul(field(), W[1-cur], *_BB, W[cur]);
+				cur = 1-cur;
+			}
+		}
+
+		const Field                 *_field;
+		const Blackbox                 *_BB;
+		Block                       _blockU;
+		size_t                           _m;
+		size_t                           _n;
+		size_t                   _lookahead;
+		size_t                    _nthreads;
+		std::vector<Block>          _slices;
+		std::vector<Value>            _ring;
+		std::vector<size_t>           _done; // slices written in each slot
+		size_t                    _consumed;
+		bool                          _stop;
+		std::mutex                   _mutex;
+		std::condition_variable      _ready;
+		std::condition_variable       _free;
+		std::vector<std::thread>   _workers;
+	};
+
+}
+
+#endif // __LINBOX_blackbox_block_pipeline_H
+
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -72,6 +72,7 @@ namespace LinBox
 				if (this->casenumber == 1) {
 					this->casenumber = 2;
 					this->_BB->apply (this->v, this->u);                // this->v <- B(B^i u_0) = B^(i+1) u_0
+					LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 					this->_VD.dot (this->_value, this->u, this->v);     // t <- this->u^t this->v = u_0^t B^(2i+1) u_0
 				}
 				else {
@@ -87,6 +88,7 @@ namespace LinBox
 				else {
 					this->casenumber = 0;
 					this->_BB->apply (this->u, this->v);                // this->u <- B(B^(i+1) u_0) = B^(i+2) u_0
+					LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 					this->_VD.dot (this->_value, this->v, this->u);     // t <- this->v^t this->u = u_0^t B^(2i+3) u_0
 				}
 			}
@@ -33,6 +33,7 @@
 #include "linbox/randiter/archetype.h"
 #include "linbox/algorithms/blackbox-container-base.h"
 #include "linbox/util/timer.h"
+#include "linbox/util/perf-counters.h"
 
 namespace LinBox
 {
@@ -119,6 +120,7 @@ namespace LinBox
 				_timer.start ();
 #endif // INCLUDE_TIMING
 				this->_BB->apply (this->v, w);  // GV
+				LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 
 #ifdef INCLUDE_TIMING
 				_timer.stop ();
@@ -140,6 +142,7 @@ namespace LinBox
 				_timer.start ();
 #endif // INCLUDE_TIMING
 				this->_BB->apply (w, this->v);  // GV
+				LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 
 #ifdef INCLUDE_TIMING
 				_timer.stop ();
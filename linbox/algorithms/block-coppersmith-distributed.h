@@ -0,0 +1,245 @@
+/* linbox/algorithms/block-coppersmith-distributed.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/block-coppersmith-distributed.h
+ * @ingroup algorithms
+ * @brief Block Coppersmith with the columns of the projection distributed over processes.
+ */
+
+#ifndef __LINBOX_block_coppersmith_distributed_H
+#define __LINBOX_block_coppersmith_distributed_H
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <time.h>
+
+#include "linbox/util/error.h"
+#include "linbox/algorithms/blackbox-block-container.h"
+#include "linbox/algorithms/block-coppersmith-domain.h"
+
+namespace LinBox
+{
+
+	/** \brief Block sequence computed elsewhere, given to BlockCoppersmithDomain
+	 * as a BlackboxBlockContainer.
+	 *
+	 * The sequence can not be computed ahead (no projections are
+	 * available), and iterating past its end throws.
+	 */
+	template<class _Field, class _Blackbox>
+	class GatheredBlockContainer {
+	public:
+		typedef _Field                         Field;
+		typedef _Blackbox                   Blackbox;
+		typedef BlasMatrix<Field>              Block;
+		typedef BlasMatrix<Field>              Value;
+
+		GatheredBlockContainer (const Blackbox *BB, const Field &F, const std::vector<Value> &seq) :
+			_field(&F), _BB(BB), _seq(&seq), _idx(0), _none(F,0,0)
+		{ linbox_check(seq.size() > 0); }
+
+		class const_iterator {
+		protected:
+			GatheredBlockContainer<Field, Blackbox> &_c;
+		public:
+			const_iterator (GatheredBlockContainer<Field, Blackbox> &C) : _c (C) {}
+
+			const_iterator &operator ++ ()
+			{
+				if (++_c._idx >= _c._seq->size())
+					throw LinboxError("GatheredBlockContainer: the sequence is too short");
+				return *this;
+			}
+
+			const Value &operator * () { return (*_c._seq)[_c._idx]; }
+		};
+
+		const_iterator begin () { return const_iterator (*this); }
+
+		size_t size () const { return _seq->size(); }
+		const Field &field () const { return *_field; }
+		const Blackbox *getBB () const { return _BB; }
+		size_t rowdim () const { return (*_seq)[0].rowdim(); }
+		size_t coldim () const { return (*_seq)[0].coldim(); }
+		const Block &getU () const { return _none; }
+		const Block &getV () const { return _none; }
+
+	protected:
+		const Field                *_field;
+		const Blackbox                *_BB;
+		const std::vector<Value>     *_seq;
+		size_t                        _idx;
+		Block                        _none;
+	};
+
+	/** \brief Block Coppersmith with the block columns of V computed by several processes.
+	 *
+	 * The columns of the right projection V are split in groups, one per
+	 * process. Each process iterates \f$U A^i V_g\f$ on its own group with
+	 * a BlackboxBlockContainer and sends the projected blocks to the root,
+	 * which gathers \f$U A^i V\f$ and computes the generator with
+	 * BlockCoppersmithDomain. The gathered sequence can also be retrieved
+	 * with sequence() to compute an OrderBasis on the root.
+	 *
+	 * U and V are random: every process builds the same U from the seed,
+	 * and the column j of V only depends on (seed, j), so that a process
+	 * only builds its own columns.
+	 *
+	 * Comm is Communicator (MPI) or LocalCommunicator (forked processes on
+	 * one host). The field elements are sent as raw bytes, they must be
+	 * trivially copyable.
+	 */
+	template<class _Domain, class _Comm>
+	class DistributedBlockCoppersmith {
+	public:
+		typedef _Domain                          Domain;
+		typedef _Comm                              Comm;
+		typedef typename Domain::Field            Field;
+		typedef typename Field::Element         Element;
+		typedef BlasMatrix<Field>                 Block;
+		typedef typename Domain::OwnMatrix  Coefficient;
+
+		static_assert(std::is_trivially_copyable<Element>::value,
+			      "DistributedBlockCoppersmith: the field elements are sent as raw bytes");
+
+		DistributedBlockCoppersmith (const Domain &MD, Comm *C, size_t m, size_t n,
+					     size_t seed = (size_t)time(NULL),
+					     unsigned long ett = DEFAULT_BLOCK_EARLY_TERM_THRESHOLD) :
+			_MD(&MD), _comm(C), _m(m), _n(n), _seed(seed), _ett(ett)
+		{}
+
+		const Domain &domain () const { return *_MD; }
+		const Field &field () const { return domain().field(); }
+
+		/// first column of V computed by the process r
+		size_t colbegin (int r) const { return (size_t)r*_n/(size_t)_comm->size(); }
+
+		/// default length of the sequence for a matrix of order N
+		size_t length (size_t N) const { return (N+_m-1)/_m + (N+_n-1)/_n + _ett + 8; }
+
+		/** \brief \f$U A^i V\f$ for i < len, on the root.
+		 * All the processes must call it; seq is left empty except on the root.
+		 */
+		template<class Blackbox>
+		void sequence (std::vector<Block> &seq, const Blackbox &A, size_t len)
+		{
+			typedef BlackboxBlockContainer<Field,Blackbox> Sequence;
+			int np = _comm->size(), r = _comm->rank();
+			size_t c0 = colbegin(r), c1 = colbegin(r+1);
+			seq.clear();
+
+			// this process' projections
+			Block U(field(),_m,A.rowdim());
+			typename Field::RandIter G(field(),0,_seed);
+			for (typename Block::Iterator it = U.Begin(); it != U.End(); ++it)
+				G.random(*it);
+			Block V(field(),A.coldim(),c1-c0);
+			for (size_t j = c0; j < c1; ++j) {
+				typename Field::RandIter Gj(field(),0,_seed+1+j);
+				Element e;
+				for (size_t i = 0; i < A.coldim(); ++i)
+					V.setEntry(i,j-c0,Gj.random(e));
+			}
+			std::unique_ptr<Sequence> S;
+			std::unique_ptr<typename Sequence::const_iterator> it;
+			if (c1 > c0) {
+				S.reset(new Sequence(&A,field(),U,V));
+				it.reset(new typename Sequence::const_iterator(S->begin()));
+			}
+			std::vector<Element> buf;
+
+			if (r != 0) {
+				buf.resize(_m*(c1-c0));
+				for (size_t i = 0; S && i < len; ++i) {
+					if (i) ++(*it);
+					const Block &Y = **it;
+					for (size_t k = 0; k < _m; ++k)
+						for (size_t j = 0; j < c1-c0; ++j)
+							buf[k*(c1-c0)+j] = Y.getEntry(k,j);
+					_comm->send(&buf[0], &buf[0]+buf.size(), 0, 0);
+				}
+			}
+			else {
+				// the root computes its group while the others are received
+				seq.assign(len, Block(field(),_m,_n));
+				for (size_t i = 0; i < len; ++i) {
+					if (S) {
+						if (i) ++(*it);
+						const Block &Y = **it;
+						for (size_t k = 0; k < _m; ++k)
+							for (size_t j = c0; j < c1; ++j)
+								seq[i].setEntry(k,j,Y.getEntry(k,j-c0));
+					}
+					for (int q = 1; q < np; ++q) {
+						size_t q0 = colbegin(q), q1 = colbegin(q+1);
+						if (q1 == q0) continue;
+						buf.resize(_m*(q1-q0));
+						_comm->recv(&buf[0], &buf[0]+buf.size(), q, 0);
+						for (size_t k = 0; k < _m; ++k)
+							for (size_t j = q0; j < q1; ++j)
+								seq[i].setEntry(k,j,buf[k*(q1-q0)+j-q0]);
+					}
+				}
+			}
+		}
+
+		/** \brief Right minimal generator of \f$U A^i V\f$ (see BlockCoppersmithDomain).
+		 * All the processes must call it, the generator is only computed
+		 * on the root (an empty degree vector is returned elsewhere).
+		 * len=0 uses length(A.coldim()).
+		 */
+		template<class Blackbox>
+		std::vector<size_t> right_minpoly (std::vector<Coefficient> &P, const Blackbox &A, size_t len = 0)
+		{
+			std::vector<Block> seq;
+			sequence(seq, A, len ? len : length(A.coldim()));
+			if (_comm->rank() != 0)
+				return std::vector<size_t>();
+
+			typedef GatheredBlockContainer<Field,Blackbox> Sequence;
+			Sequence C(&A, field(), seq);
+			BlockCoppersmithDomain<Domain,Sequence> BCD(domain(), &C, _ett);
+			return BCD.right_minpoly(P);
+		}
+
+	protected:
+		const Domain                   *_MD;
+		Comm                         *_comm;
+		size_t                           _m;
+		size_t                           _n;
+		size_t                        _seed;
+		unsigned long                  _ett;
+	};
+
+} // end of namespace LinBox
+
+#endif // __LINBOX_block_coppersmith_distributed_H
+
+
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,:0,t0,+0,=s
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
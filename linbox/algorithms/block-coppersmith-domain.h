@@ -30,6 +30,7 @@
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <memory>
 
 #include "linbox/util/timer.h"
 
@@ -46,6 +47,7 @@ namespace LinBox {
 #endif
 
 #include "linbox/util/commentator.h"
+#include "linbox/algorithms/blackbox-block-pipeline.h"
 
 #define DEFAULT_BLOCK_EARLY_TERM_THRESHOLD 10
 //Preprocessor variables for the state of BM_iterators
@@ -80,6 +82,8 @@ namespace LinBox
         Sequence                          *_container;
         const Domain                      *_MD;
         unsigned long            EARLY_TERM_THRESHOLD;
+        size_t                             _lookahead;
+        size_t                             _producers;
 
 
     public:
@@ -88,12 +92,13 @@ namespace LinBox
 Sequence> &Mat, unsigned long ett_default =
 DEFAULT_BLOCK_EARLY_TERM_THRESHOLD) :
             _container(Mat._container), _MD(Mat._MD),
-            EARLY_TERM_THRESHOLD (ett_default)
+            EARLY_TERM_THRESHOLD (ett_default),
+            _lookahead(Mat._lookahead), _producers(Mat._producers)
         {}
         BlockCoppersmithDomain (const Domain& MD, Sequence *D, unsigned long ett_default
 = DEFAULT_BLOCK_EARLY_TERM_THRESHOLD) :
             _container(D), _MD(&MD),
-EARLY_TERM_THRESHOLD (ett_default)
+EARLY_TERM_THRESHOLD (ett_default), _lookahead(0), _producers(1)
         {}
 
 	//matrix domain
@@ -107,6 +112,13 @@ EARLY_TERM_THRESHOLD (ett_default)
         Sequence *getSequence () const
         { return _container; }
 
+        // compute up to lookahead elements of the sequence ahead of the
+        // generator, with nthreads producer threads (see BlackboxBlockPipeline).
+        // lookahead=0 computes them on demand (default).
+        // The sequence must not have been iterated yet.
+        void setLookahead (size_t lookahead, size_t nthreads=1)
+        { _lookahead = lookahead; _producers = nthreads; }
+
         // the principal function
         std::vector<size_t>  right_minpoly (std::vector<Coefficient> &P);
 
@@ -836,8 +848,24 @@ EARLY_TERM_THRESHOLD (ett_default)
 	    //Create the BM_Seq, that will use the Coppersmith Block Berlekamp Massey Algorithm to compute the minimal generator.
 	    BM_Seq seq(domain(),r,c);
 
+	    //With a lookahead the projections are computed by producer threads
+	    //while the generator is updated
+	    typedef BlackboxBlockPipeline<typename Sequence::Field, typename Sequence::Blackbox> Pipeline;
+	    //the producers are stopped and joined by the destructor, also when
+	    //the generator computation throws
+	    std::unique_ptr<Pipeline> pipe;
+	    typename Pipeline::Value value(_container->field(),r,c);
+	    if (_lookahead)
+		    pipe.reset(new Pipeline(_container->getBB(), _container->field(),
+					_container->getU(), _container->getV(), _lookahead, _producers));
+
 	    //Push the first projection onto the BM_Seq
-	    seq.push_back(*contiter);
+	    if (pipe) {
+		    pipe->next(value);
+		    seq.push_back(value);
+	    }
+	    else
+		    seq.push_back(*contiter);
 
 	    //Create the BM_Seq iterator whose incrementation performs a step of the generator
 	    typename BM_Seq::BM_iterator bmit(seq.BM_begin(EARLY_TERM_THRESHOLD));
@@ -848,12 +876,21 @@ EARLY_TERM_THRESHOLD (ett_default)
 		    check = bmit.state();
 		    if(check.IsSequenceExceeded()){
 			    CTimer start; start.start();
-			    ++contiter;
-                            start.stop();
-			    g_time1+=start.realtime();
-			    seq.push_back(*contiter);
+			    if (pipe) {
+				    pipe->next(value);
+				    start.stop();
+				    g_time1+=start.realtime();
+				    seq.push_back(value);
+			    }
+			    else {
+				    ++contiter;
+				    start.stop();
+				    g_time1+=start.realtime();
+				    seq.push_back(*contiter);
+			    }
 		    }
 	    }
+	    pipe.reset();
 	    P = bmit.GetGenerator();
 	    std::vector<size_t> deg(bmit.get_deg());
 	    commentator().report(Commentator::LEVEL_IMPORTANT,TIMING_MEASURE) <<
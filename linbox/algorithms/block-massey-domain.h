@@ -35,6 +35,7 @@
 
 #include "linbox/util/commentator.h"
 #include "linbox/util/timer.h"
+#include "linbox/util/perf-counters.h"
 #include <givaro/zring.h>
 #include "linbox/matrix/matrix-domain.h"
 #include "linbox/matrix/dense-matrix.h"
@@ -55,7 +56,6 @@
 // #define __PRINT_SEQUENCE
 // #define __PRINT_SIGMABASE
 
-//#define _BM_TIMING
 #define DEFAULT_BLOCK_EARLY_TERM_THRESHOLD 10
 
 namespace LinBox
@@ -115,98 +115,16 @@ namespace LinBox
 
 	public:
 
-#ifdef _BM_TIMING
-		mutable Timer   ttGetMinPoly;			mutable Timer tGetMinPoly;
-		mutable Timer	ttNewDiscrepancy;		mutable Timer tNewDiscrepancy;
-		mutable Timer	ttShiftSigma;			mutable Timer tShiftSigma;
-		mutable Timer   ttApplyPerm;			mutable Timer tApplyPerm;
-		mutable Timer   ttUpdateSigma;			mutable Timer tUpdateSigma;
-		mutable Timer   ttInverseL;			mutable Timer tInverseL;
-		mutable Timer   ttGetPermutation;		mutable Timer tGetPermutation;
-		mutable Timer   ttLQUP;				mutable Timer tLQUP;
-		mutable Timer   ttDiscrepancy;			mutable Timer tDiscrepancy;
-		mutable Timer   ttGetCoeff;			mutable Timer tGetCoeff;
-		mutable Timer   ttCheckSequence;		mutable Timer tCheckSequence;
-		mutable Timer   ttSetup;			mutable Timer tSetup;
-		mutable Timer   ttMBasis;			mutable Timer tMBasis;
-		mutable Timer   ttUpdateSerie;			mutable Timer tUpdateSerie;
-		mutable Timer   ttBasisMultiplication;	        mutable Timer tBasisMultiplication;
-		mutable Timer   ttCopyingData;			mutable Timer tCopyingData;
-		mutable Timer   Total;
-
-		void clearTimer()
-		{
-			ttGetMinPoly.clear();
-			ttNewDiscrepancy.clear();
-			ttShiftSigma.clear();
-			ttApplyPerm.clear();
-			ttUpdateSigma.clear();
-			ttInverseL.clear();
-			ttGetPermutation.clear();
-			ttLQUP.clear();
-			ttDiscrepancy.clear();
-			ttGetCoeff.clear();
-			ttCheckSequence.clear();
-			ttSetup.clear();
-			ttMBasis.clear();
-			ttUpdateSerie.clear();
-			ttBasisMultiplication.clear();
-			ttCopyingData.clear(),
-			Total.clear();
-		}
-
-		void print(Timer& T, const  char* timer, const char* title)
-		{
-			if (&T != &Total)
-				Total+=T;
-			if (T.count() > 0) {
-				std::cout<<title<<": "<<timer;
-				for (int i=(int)strlen(timer); i<28; i++)
-					std::cout << ' ';
-				std::cout<<T<<std::endl;
-			}
-		}
-
-		void printTimer()
-		{
-			print(ttSetup, "Setup", "direct");
-			print(ttCheckSequence, "Rank of Seq[0]", "direct");
-			print(ttGetCoeff, "Compute sequence", "direct");
-			print(ttDiscrepancy, "Compute Discrepancy", "direct");
-			print(ttLQUP, "LQUP","direct");
-			print(ttGetPermutation, "Compute Permutation", "direct");
-			print(ttApplyPerm, "Apply Permutation", "direct");
-			print(ttInverseL, "Inverse of L", "direct");
-			print(ttUpdateSigma, "Update Sigma", "direct");
-			print(ttShiftSigma, "Shift Sigma by x", "direct");
-			print(ttNewDiscrepancy, "Keep half Discrepancy", "direct");
-			print(ttMBasis, "MBasis computation", "recursive");
-			print(ttUpdateSerie, "Updating Power Serie", "recursive");
-			print(ttBasisMultiplication, "Basis Multiplication", "recursive");
-			print(ttCopyingData, "Copying Data", "recursive");
-			print(Total, "Total", "");
-			std::cout<<std::endl<<std::endl;
-		}
-#endif
 
 
 		BlockMasseyDomain (const BlockMasseyDomain<Field, Sequence> &Mat, unsigned long ett_default = DEFAULT_BLOCK_EARLY_TERM_THRESHOLD) :
 			_container(Mat._container), _field(Mat._field), _BMD(Mat.field()),
 			_MD(Mat.field()),  EARLY_TERM_THRESHOLD (ett_default)
-		{
-#ifdef _BM_TIMING
-			clearTimer();
-#endif
-
-		}
+		{}
 
 		BlockMasseyDomain (Sequence *D, unsigned long ett_default = DEFAULT_BLOCK_EARLY_TERM_THRESHOLD) :
 			_container(D), _field(&(D->field ())), _BMD(D->field ()), _MD(D->field ()), EARLY_TERM_THRESHOLD (ett_default)
-		{
-#ifdef _BM_TIMING
-			clearTimer();
-#endif
-		}
+		{}
 
 
 		// field of the domain
@@ -307,6 +225,7 @@ namespace LinBox
 
 				// Get the next coefficient in the sequence
 				S[NN]=*_iter;
+				LINBOX_PERF_LAP_START(3);
 
 				/*
 				 * Compute the new discrepancy (just updating the first m rows)
@@ -331,6 +250,7 @@ namespace LinBox
                                         early_stop=0;
                                 else
                                         early_stop++;
+				LINBOX_PERF_LAP(3,"BlockMassey: discrepancy");
 
 				// maybe there is something to do here
 				// increase the last n rows of orders
@@ -398,6 +318,7 @@ namespace LinBox
 				// compute the inverse of L
 				TriangularBlasMatrix<Field> invL (field(),m+n,m+n, Tag::Shape::Lower,Tag::Diag::Unit);
 				FFPACK::trinv_left(field(),m+n,L.getPointer(),L.getStride(),invL.getWritePointer(),invL.getStride());
+				LINBOX_PERF_LAP(3,"BlockMassey: LQUP and inverse of L");
 
 #ifdef 	__CHECK_TRANSFORMATION
 				report<<"invL"<<NN<<":=Matrix(";
@@ -411,6 +332,7 @@ namespace LinBox
 					_BMD.mulin_right(Qt,SigmaBase[i]);
 					_BMD.mulin_right(BPerm2,SigmaBase[i]);
 				}
+				LINBOX_PERF_LAP(3,"BlockMassey: update sigma");
 
 				// Apply BPerm2 and Qt to the vector of order and increase by 1 the last n rows
 				Givaro::ZRing<long> UF(0);
@@ -491,6 +413,7 @@ namespace LinBox
 				// BlasPermutation<size_t> Pp= LQUP.getP();
 				_BMD.mul(Discrepancy,trU, Pp);
 				_BMD.mulin_right(BPerm2,Discrepancy);
+				LINBOX_PERF_LAP(3,"BlockMassey: shift sigma and new discrepancy");
 			}
 
                         if ( early_stop == EARLY_TERM_THRESHOLD)
@@ -599,8 +522,11 @@ namespace LinBox
 			std::vector<Coefficient> SigmaBase(length,Zero);
 
 			// Compute Sigma Base up to the order length - 1
-			SigmaBasis<Field> SB(field(), PowerSerie);
-			SB.left_basis(SigmaBase, length-1, defect);
+			{
+				LINBOX_PERF_TIMER("BlockMassey: sigma basis");
+				SigmaBasis<Field> SB(field(), PowerSerie);
+				SB.left_basis(SigmaBase, length-1, defect);
+			}
 
 			// take the m rows which have lowest defect
 			// compute permutation such that first m rows have lowest defect
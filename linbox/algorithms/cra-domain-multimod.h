@@ -0,0 +1,178 @@
+/* linbox/algorithms/cra-domain-multimod.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/cra-domain-multimod.h
+ * @brief \ref CRA with k primes by iteration, over a MultiModDouble
+ * @ingroup CRA
+ */
+
+#ifndef __LINBOX_multimod_cra_H
+#define __LINBOX_multimod_cra_H
+
+#include <set>
+#include <vector>
+#include "linbox/field/multimod-field.h"
+#include "linbox/algorithms/cra-domain-seq.h"
+
+namespace LinBox
+{
+
+	/** \brief CRA loop computing the residues modulo k primes at once.
+	 * @ingroup CRA
+	 *
+	 * Each iteration is given a MultiModDouble F on k new primes and
+	 * returns the k residues, which are then given to the builder one
+	 * prime at a time. With a MultiModSparseMatrix, one pass over the
+	 * nonzeros serves the k primes.
+	 *
+	 * The primes of the iterator must be valid for MultiModDouble
+	 * (< 2^26.5) and for the Domain of the builder.
+	 */
+	template<class CRABase>
+	struct ChineseRemainderMultiMod : public ChineseRemainderSeq<CRABase> {
+		typedef typename CRABase::Domain	Domain;
+		typedef typename CRABase::DomainElement	DomainElement;
+		typedef ChineseRemainderSeq<CRABase>    Father_t;
+		typedef MultiModDouble::Element      MultiElement;
+
+	protected:
+		size_t nbPrimes_; //!< primes by iteration
+
+	public:
+		template<class Param>
+		ChineseRemainderMultiMod(const Param& b, const size_t k = 4) :
+			Father_t(b), nbPrimes_(k)
+		{}
+
+		ChineseRemainderMultiMod(const CRABase& b, const size_t k = 4) :
+			Father_t(b), nbPrimes_(k)
+		{}
+
+		/** \brief The \ref CRA loop, k primes at a time.
+		 *
+		 * \param Iteration  Function object \c Iteration(r, F), given a
+		 * MultiModDouble \p F it outputs the residues \p r, a
+		 * MultiModDouble::Element: r[l] is the residue modulo
+		 * F.getModulo(l).
+		 * \param primeiter  iterator for generating primes.
+		 * \param[out] res  an integer
+		 */
+		template<class Function, class PrimeIterator>
+		Integer& operator() (Integer& res, Function& Iteration, PrimeIterator& primeiter)
+		{
+			commentator().start ("MultiModDouble iteration", "mmcramm");
+			std::vector<Integer> primes;
+			while( (this->IterCounter == 0) || ! this->Builder_.terminated() ) {
+				if (! nextPrimes(primes, primeiter)) break;
+				MultiModDouble F(primes);
+				MultiElement r; F.init(r);
+				Iteration(r, F);
+				for (size_t l = 0; l < primes.size(); ++l) {
+					Domain D(primes[l]);
+					DomainElement e; D.init(e, r[l]);
+					feed(D, e);
+					if (this->Builder_.terminated()) break;
+				}
+			}
+			commentator().stop ("done", NULL, "mmcramm");
+			return this->Builder_.result(res);
+		}
+
+		/** \brief The vectorized \ref CRA loop, k primes at a time.
+		 *
+		 * \param Iteration  Function object \c Iteration(r, F), given a
+		 * MultiModDouble \p F it outputs the residues \p r, a
+		 * std::vector of MultiModDouble::Element: r[i][l] is the
+		 * residue of the i-th entry modulo F.getModulo(l).
+		 */
+		template<class Iterator, class Function, class PrimeIterator>
+		Iterator& operator() (Iterator& res, Function& Iteration, PrimeIterator& primeiter)
+		{
+			commentator().start ("MultiModDouble vectorized iteration", "mmcravmm");
+			std::vector<Integer> primes;
+			while( (this->IterCounter == 0) || ! this->Builder_.terminated() ) {
+				if (! nextPrimes(primes, primeiter)) break;
+				MultiModDouble F(primes);
+				std::vector<MultiElement> r;
+				Iteration(r, F);
+				for (size_t l = 0; l < primes.size(); ++l) {
+					Domain D(primes[l]);
+					BlasVector<Domain> e(D, r.size());
+					for (size_t i = 0; i < r.size(); ++i)
+						D.init(e[i], r[i][l]);
+					feed(D, e);
+					if (this->Builder_.terminated()) break;
+				}
+			}
+			commentator().stop ("done", NULL, "mmcravmm");
+			return this->Builder_.result(res);
+		}
+
+	protected:
+		template<class Residue>
+		void feed(const Domain& D, const Residue& e)
+		{
+			++this->IterCounter;
+			LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
+			if (this->IterCounter == 1)
+				this->Builder_.initialize(D, e);
+			else
+				this->Builder_.progress(D, e);
+		}
+
+		/// the next nbPrimes_ distinct primes coprime with the modulus, false if there are no more
+		template<class PrimeIterator>
+		bool nextPrimes(std::vector<Integer>& primes, PrimeIterator& primeiter)
+		{
+			int coprime = 0;
+			int maxnoncoprime = 1000;
+			std::set<Integer> coprimeset;
+			while(coprimeset.size() < nbPrimes_) {
+				while( this->Builder_.noncoprime(*primeiter) || coprimeset.count(*primeiter) ) {
+					++primeiter;
+					++coprime;
+					if (coprime > maxnoncoprime) {
+						commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_ERROR) << "you are running out of primes. " << this->IterCounter << " used and " << maxnoncoprime << " coprime primes tried for a new one.";
+						return false;
+					}
+				}
+				coprime = 0;
+				coprimeset.insert(*primeiter);
+				commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "With prime " << *primeiter << std::endl;
+				++primeiter;
+			}
+			primes.assign(coprimeset.begin(), coprimeset.end());
+			return true;
+		}
+	};
+
+} // LinBox
+
+#endif // __LINBOX_multimod_cra_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -32,10 +32,13 @@
 
 #ifndef __LINBOX_omp_cra_H
 #define __LINBOX_omp_cra_H
-// commentator is not thread safe
+// commentator is not thread safe: the activities are traced with tracer()
 #define DISABLE_COMMENTATOR
 #include <omp.h>
 #include <set>
+#include <memory>
+#include "linbox/util/tracer.h"
+#include "linbox/util/prime-pool.h"
 #include "linbox/algorithms/cra-domain-seq.h"
 
 namespace LinBox
@@ -66,7 +69,7 @@ namespace LinBox
 			 */
 			size_t NN = omp_get_max_threads();
 			//std::cerr << "Blocs: " << NN << " iterations." << std::endl;
-			// commentator().start ("Parallel OMP Givaro::Modular iteration", "mmcrait");
+			TraceActivity act("Parallel OMP CRA");
 			if (NN == 1) return Father_t::operator()(res,Iteration,primeiter);
 
 			int coprime =0;
@@ -98,15 +101,19 @@ namespace LinBox
 
 #pragma omp parallel for
 				for(size_t i=0;i<NN;++i) {
+					TraceActivity iter("CRA iteration");
 					Iteration(ROUNDresidues[i], ROUNDdomains[i]);
 				}
 #pragma omp barrier
 				++this->IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				this->Builder_.initialize( ROUNDdomains[0],ROUNDresidues[0]);
 				for(size_t i=1;i<NN;++i) {
 					++this->IterCounter;
+					LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 					this->Builder_.progress( ROUNDdomains[i],ROUNDresidues[i]);
 				}
+				tracer().progress((long)this->IterCounter);
 				// commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "With prime " << *primeiter << std::endl;
 			}
 
@@ -137,15 +144,17 @@ namespace LinBox
 
 #pragma omp parallel for
 				for(size_t i=0;i<NN;++i) {
+					TraceActivity iter("CRA iteration");
 					Iteration(ROUNDresidues[i], ROUNDdomains[i]);
 				}
 #pragma omp barrier
 				for(size_t i=0;i<NN;++i) {
 					++this->IterCounter;
+					LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 					this->Builder_.progress( ROUNDdomains[i],ROUNDresidues[i]);
 				}
+				tracer().progress((long)this->IterCounter);
 			}
-			// commentator().stop ("done", NULL, "mmcrait");
 			//std::cerr << "Used: " << this->IterCounter << " primes." << std::endl;
 			return this->Builder_.result(res);
 		}
@@ -156,7 +165,7 @@ namespace LinBox
 			typedef typename CRATemporaryVectorTrait<Function, DomainElement>::Type_t ElementContainer;
 			size_t NN = omp_get_max_threads();
 			//std::cerr << "Blocs: " << NN << " iterations." << std::endl;
-			// commentator().start ("Parallel OMP Givaro::Modular iteration", "mmcrait");
+			TraceActivity act("Parallel OMP CRA");
 			if (NN == 1) return Father_t::operator()(res,Iteration,primeiter);
 
 			int coprime =0;
@@ -190,15 +199,19 @@ namespace LinBox
 
 #pragma omp parallel for
 				for(size_t i=0;i<NN;++i) {
+					TraceActivity iter("CRA iteration");
 					Iteration(ROUNDresidues[i], ROUNDdomains[i]);
 				}
 #pragma omp barrier
 				++this->IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				this->Builder_.initialize( ROUNDdomains[0],ROUNDresidues[0]);
 				for(size_t i=1;i<NN;++i) {
 					++this->IterCounter;
+					LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 					this->Builder_.progress( ROUNDdomains[i],ROUNDresidues[i]);
 				}
+				tracer().progress((long)this->IterCounter);
 				// commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "With prime " << *primeiter << std::endl;
 			}
 
@@ -231,21 +244,92 @@ namespace LinBox
 
 #pragma omp parallel for
 				for(size_t i=0;i<NN;++i) {
+					TraceActivity iter("CRA iteration");
 					Iteration(ROUNDresidues[i], ROUNDdomains[i]);
 				}
 #pragma omp barrier
 				for(size_t i=0;i<NN;++i) {
 					++this->IterCounter;
+					LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 					this->Builder_.progress( ROUNDdomains[i],ROUNDresidues[i]);
 				}
+				tracer().progress((long)this->IterCounter);
 			}
-			// commentator().stop ("done", NULL, "mmcrait");
 			//std::cerr << "Used: " << this->IterCounter << " primes." << std::endl;
 			return this->Builder_.result(res);
 		}
 
+		/** \brief The \ref CRA loop with the primes of a PrimePool.
+		 *
+		 * Each worker claims its own prime from the pool (and another one
+		 * while it is not coprime with the modulus), instead of the
+		 * master generating the NN primes of a round before the parallel
+		 * iterations.
+		 */
+		template<class Function>
+		Integer& operator() (Integer& res, Function& Iteration, PrimePool::Iterator& primeiter)
+		{
+			return poolLoop<DomainElement>(res, Iteration, primeiter.pool());
+		}
+
+		/// The vectorized \ref CRA loop with the primes of a PrimePool
+		template<class Container, class Function>
+		Container& operator() (Container& res, Function& Iteration, PrimePool::Iterator& primeiter)
+		{
+			typedef typename CRATemporaryVectorTrait<Function, DomainElement>::Type_t ElementContainer;
+			return poolLoop<ElementContainer>(res, Iteration, primeiter.pool());
+		}
+
+	protected:
+		template<class Residue, class Result, class Function>
+		Result& poolLoop (Result& res, Function& Iteration, PrimePool& pool)
+		{
+			size_t NN = omp_get_max_threads();
+			TraceActivity act("Parallel OMP CRA");
+			int maxnoncoprime = 1000;
+
+			while( (this->IterCounter == 0) || ! this->Builder_.terminated() ) {
+				std::vector<std::unique_ptr<Domain> > ROUNDdomains(NN);
+				std::vector<Residue> ROUNDresidues(NN);
+
+				// the builder is only read during the iterations
+#pragma omp parallel for
+				for(size_t i=0;i<NN;++i) {
+					Integer p;
+					bool found = pool.claim(p);
+					for(int coprime = 0; found && this->Builder_.noncoprime(p); ++coprime)
+						found = (coprime < maxnoncoprime) && pool.claim(p);
+					if (! found) continue;
+					TraceActivity iter("CRA iteration");
+					ROUNDdomains[i].reset(new Domain(p));
+					initResidue(*ROUNDdomains[i], ROUNDresidues[i]);
+					Iteration(ROUNDresidues[i], *ROUNDdomains[i]);
+				}
+#pragma omp barrier
+				size_t done = 0;
+				for(size_t i=0;i<NN;++i) {
+					if (! ROUNDdomains[i]) continue;
+					++done;
+					++this->IterCounter;
+					LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
+					if (this->IterCounter == 1)
+						this->Builder_.initialize( *ROUNDdomains[i],ROUNDresidues[i]);
+					else
+						this->Builder_.progress( *ROUNDdomains[i],ROUNDresidues[i]);
+				}
+				tracer().progress((long)this->IterCounter);
+				if (done < NN) {
+					std::cout << "you are running out of primes. " << maxnoncoprime << " coprime primes found";
+					break;
+				}
+			}
+			return this->Builder_.result(res);
+		}
 
+		static void initResidue (const Domain& D, DomainElement& r) { D.init(r); }
 
+		template<class Container>
+		static void initResidue (const Domain&, Container&) {}
 	};
 }
 
@@ -31,6 +31,7 @@
 #define __LINBOX_sequential_cra_H
 #include "linbox/linbox-config.h"
 #include "linbox/util/timer.h"
+#include "linbox/util/perf-counters.h"
 #include "linbox/integer.h"
 #include "linbox/solutions/methods.h"
 #include "linbox/vector/blas-vector.h"
@@ -98,6 +99,7 @@ namespace LinBox
 			commentator().start ("Givaro::Modular iteration", "mmcrait");
 			if (IterCounter==0) {
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				Domain D(*primeiter);
 				std::ostream& report = commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION);
 				report << "With prime " << *primeiter << std::endl;
@@ -112,6 +114,7 @@ namespace LinBox
 
 			while( ! Builder_.terminated() ) {
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				while(Builder_.noncoprime(*primeiter) ) {
 					++primeiter;
 					++coprime;
@@ -144,6 +147,7 @@ namespace LinBox
 			if ((IterCounter ==0) && (k !=0)) {
 				++i;
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				Domain D(*primeiter);
 				commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "With prime " << *primeiter << std::endl;
 				++primeiter;
@@ -196,6 +200,7 @@ namespace LinBox
 
 			while( ! Builder_.terminated() ) {
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				while(Builder_.noncoprime(*primeiter) ) {
 					++primeiter;
 					++coprime;
@@ -226,6 +231,7 @@ namespace LinBox
 			if ((IterCounter ==0) && (k !=0)) {
 				++i;
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				Domain D(*primeiter);
 				commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "With prime " << *primeiter << std::endl;
 				++primeiter;
@@ -240,6 +246,7 @@ namespace LinBox
 				if (Builder_.terminated()) break;
 				++i;
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 
 				while(Builder_.noncoprime(*primeiter) ) {
 					++primeiter;
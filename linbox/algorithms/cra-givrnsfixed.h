@@ -32,6 +32,7 @@
 
 #include <stdlib.h>
 #include "linbox/vector/blas-vector.h"
+#include "linbox/field/multimod-field.h"
 #include <givaro/givrnsfixed.h>
 
 namespace LinBox
@@ -56,6 +57,10 @@ namespace LinBox
 		integer _product;
 		integer _midprod;
 
+		std::vector<integer>                    _primes;
+		MultiModDouble                            _full; //!< all the primes, for the residues by MultiModDouble
+		std::vector<MultiModDouble::Element>       _rns; //!< their residues, by entry
+
 	public:
 		GivaroRnsFixedCRA(const std::vector<integer>& primes)
 				: Father_t(primes),
@@ -63,6 +68,7 @@ namespace LinBox
 				  iterationnumber(0)
 				  , residues(0,BlasVector<Givaro::ZRing<Integer> >(Givaro::ZRing<Integer>()))
 				  , _product(1)
+				  , _primes(primes)
 		{
 			for(size_t i=0; i<primes.size(); ++i)
 				_product *= primes[i];
@@ -75,6 +81,7 @@ namespace LinBox
 				  iterationnumber(0)
 				  , residues(0,BlasVector<Givaro::ZRing<Integer> >(Givaro::ZRing<Integer>()))
 				  , _product(1)
+				  , _primes(primes.begin(), primes.end())
 		{
 			for(size_t i=0; i<primes.size(); ++i)
 				_product *= primes[i];
@@ -139,9 +146,43 @@ namespace LinBox
 		}
 
 
+		/** \brief Residues modulo several primes of the system at once.
+		 *
+		 * The primes of \p F (< 2^26.5) are the next F.size() primes of
+		 * the system, in order, and e[i] is the MultiModDouble::Element
+		 * of the i-th entry. The residues are kept as doubles and
+		 * result() reconstructs the entries with the CRT of
+		 * MultiModDouble over all the primes, computed across the primes:
+		 * no Integer by residue. Not to be mixed with the progress by
+		 * prime.
+		 */
+		template<class Vect>
+		void progress (const MultiModDouble& F, const Vect& e)
+		{
+			if (_rns.empty()) {
+				_full = MultiModDouble(_primes);
+				_rns.resize(e.size());
+				for (size_t i = 0; i < e.size(); ++i)
+					_full.init(_rns[i]);
+			}
+			linbox_check(iterationnumber + F.size() <= nbloops);
+			for (size_t l = 0; l < F.size(); ++l)
+				linbox_check(F.getModulo(l) == _full.getModulo(iterationnumber + l));
+			for (size_t i = 0; i < e.size(); ++i)
+				std::copy(e[i].begin(), e[i].begin() + F.size(), _rns[i].begin() + iterationnumber);
+			iterationnumber += F.size();
+		}
+
+		template<class Vect>
+		void initialize (const MultiModDouble& F, const Vect& e)
+		{
+			progress(F, e);
+		}
+
 		template<template<class, class> class Vect, template <class> class Alloc>
 		Vect<Integer, Alloc<Integer> >& result (Vect<Integer, Alloc<Integer> > &d)
 		{
+			if (! _rns.empty()) return resultRNS(d);
 			d.resize(0);
 			for(typename Vect<Integer, Alloc<Integer> >::const_iterator rit = residues.begin(); rit != residues.end(); ++rit) {
 				Integer tmp;
@@ -159,6 +200,7 @@ namespace LinBox
 
 		BlasVector<Givaro::ZRing<Integer> >& result (BlasVector<Givaro::ZRing<Integer> > &d)
 		{
+			if (! _rns.empty()) return resultRNS(d);
 			d.resize(0);
 			for(std::vector<BlasVector< Givaro::ZRing<Integer> > >::const_iterator rit = residues.begin(); rit != residues.end(); ++rit) {
 				Integer tmp;
@@ -183,6 +225,23 @@ namespace LinBox
 			return false;
 		}
 
+	protected:
+		// the entries from the residues given by MultiModDouble, in ]-M/2,M/2]
+		template<class Vect>
+		Vect& resultRNS (Vect &d)
+		{
+			linbox_check(iterationnumber == nbloops);
+			d.resize(0);
+			for(size_t i = 0; i < _rns.size(); ++i) {
+				Integer tmp;
+				_full.convert(tmp, _rns[i]);
+				if (tmp>_midprod)
+					tmp -= _product ;
+				d.push_back(tmp);
+			}
+			return d;
+		}
+
 
 
 
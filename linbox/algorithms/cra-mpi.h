@@ -30,6 +30,7 @@
 
 #define MPICH_IGNORE_CXX_SEEK //BB: ???
 #include "linbox/util/timer.h"
+#include "linbox/util/perf-counters.h"
 #include <stdlib.h>
 #include "linbox/integer.h"
 #include "linbox/solutions/methods.h"
@@ -106,10 +107,12 @@ namespace LinBox
 					//  assimilate results
 					if(first_time){
 						Builder_.initialize(D, r);
+						LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 						first_time = false;
 					}
 					else
 						Builder_.progress( D, r );
+						LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 					//  queue a new prime if applicable
 					if(! Builder_.terminated()){
 						++primeg;
@@ -177,6 +180,7 @@ namespace LinBox
 					_commPtr->send(primes[i - 1], i);
 				}
 				Builder_.initialize( D, Iteration(r, D) );
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				int poison_pills_left = procs - 1;
 				while(poison_pills_left > 0 ){
 					int idle_process = 0;
@@ -187,6 +191,7 @@ namespace LinBox
 					idle_process = (_commPtr->get_stat()).MPI_SOURCE;
 					Domain D(primes[idle_process - 1]);
 					Builder_.progress(D, r);
+					LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 					//  if still working, queue a prime
 					if(! Builder_.terminated()){
 						++primeg;
@@ -44,6 +44,12 @@
  */
 
 
+#ifndef __LINBOX_GF2_SpD_MAXSPARSITY__
+// Schur complement denser than 5% --> switch to packed dense rows
+// (a BitVector row is already smaller than size_t indices above 1/64)
+#define __LINBOX_GF2_SpD_MAXSPARSITY__ 0.05
+#endif
+
 namespace LinBox
 {
 
@@ -60,11 +66,23 @@ namespace LinBox
 
 		/** \brief The field parameter is the domain  over which to perform computations.
 		 */
-		GaussDomain (const Field &) {}
+		GaussDomain (const Field &) :
+			_maxSparsity (__LINBOX_GF2_SpD_MAXSPARSITY__)
+		{}
 
 		//Copy constructor
 		///
-		GaussDomain (const GaussDomain &)  {}
+		GaussDomain (const GaussDomain &D) :
+			_maxSparsity (D._maxSparsity)
+		{}
+
+		/** \brief Density of the Schur complement above which
+		 * InPlaceLinearPivoting goes on with packed dense rows.
+		 * Defaults to __LINBOX_GF2_SpD_MAXSPARSITY__; 0 switches at once,
+		 * infinity never.
+		 */
+		void setMaxSparsity (double d) { _maxSparsity = d; }
+		double maxSparsity () const { return _maxSparsity; }
 
 		/** accessor for the field of computation.
 		*/
@@ -185,6 +203,21 @@ namespace LinBox
 						     Perm                   &P,
 						     unsigned long Ni,
 						     unsigned long Nj) const;
+		/** \brief Packed dense continuation of InPlaceLinearPivoting.
+		 * Rows k..Ni-1 (the Schur complement, on columns Rank..Nj-1)
+		 * are moved to BitVector rows and eliminated by word-wise XOR,
+		 * the sparsest row (by popcount) being chosen as pivot.
+		 * On return they are written back as sparse rows, permutations
+		 * being applied to P and to the rows above k.
+		 */
+		template <class SparseSeqMatrix, class Perm>
+		unsigned long& DenseInPlaceLinearPivotingBinary(unsigned long &Rank,
+								SparseSeqMatrix        &A,
+								Perm                   &P,
+								unsigned long k,
+								unsigned long Ni,
+								unsigned long Nj) const;
+
 		template <class SparseSeqMatrix>
 		unsigned long& NoReordering (unsigned long & Rank, Element& , SparseSeqMatrix &, unsigned long , unsigned long ) const
 		{
@@ -195,6 +228,8 @@ namespace LinBox
 
 	protected:
 
+		double _maxSparsity;
+
 		//-----------------------------------------
 		// Sparse elimination using a pivot row :
 		// lc <-- lc - lc[k]/lp[0] * lp
@@ -73,14 +73,20 @@ namespace LinBox
 		std::vector<size_t> col_density (Nj);
 
 
+		// number of non zero elements in the Schur complement
+		long long schur_nnz = 0;
+
 		// assignment of LigneA with the domain object
-		for (unsigned long jj = 0; jj < Ni; ++jj)
+		for (unsigned long jj = 0; jj < Ni; ++jj) {
+			schur_nnz += (long long)LigneA[jj].size ();
 			for (unsigned long k = 0; k < LigneA[jj].size (); k++)
 				++col_density[LigneA[jj][(size_t)k]];
+		}
 
 		long last = (long)Ni - 1;
 		long c;
 		Rank = 0;
+		bool degeneratedense = false;
 
 #ifdef __LINBOX_OFTEN__
 		long sstep = last/40;
@@ -92,6 +98,16 @@ namespace LinBox
 
 		typename SparseSeqMatrix::iterator LigneA_k = LigneA.begin();
 		for (long k = 0; k < last; ++k, ++LigneA_k) {
+
+			if ((double)schur_nnz > double(Ni-(unsigned long)k)*double(Nj-Rank)*_maxSparsity) {
+				commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+				<< "Dense switch at step " << k << ": " << schur_nnz << " elements in "
+				<< (Ni-(unsigned long)k) << " x " << (Nj-Rank) << std::endl;
+				DenseInPlaceLinearPivotingBinary(Rank, LigneA, P, (unsigned long)k, Ni, Nj);
+				degeneratedense = true;
+				break;
+			}
+
 			long p = k, s = 0;
 
 #ifdef __LINBOX_FILLIN__
@@ -151,9 +167,12 @@ namespace LinBox
 					long npiv=(long)LigneA_k->size();
 					for (ll = k+1; ll < static_cast<long>(Ni); ++ll) {
 						bool elim=false;
+						schur_nnz -= (long long)LigneA[(size_t)ll].size();
 						eliminateBinary (elim, LigneA[(size_t)ll], *LigneA_k, Rank, c, (size_t)npiv, col_density);
+						schur_nnz += (long long)LigneA[(size_t)ll].size();
 					}
 				}
+				schur_nnz -= (long long)LigneA_k->size();
 
 				// LigneA.write(std::cerr << "AFT " )<<std::endl;
 #ifdef __LINBOX_COUNT__
@@ -163,12 +182,14 @@ namespace LinBox
 			// LigneA.write(rep << "U:= ", Tag::FileFormat::Maple) << std::endl;
 		}//for k
 
-		SparseFindPivotBinary ( LigneA[(size_t)last], Rank, c, determinant);
-		if (c != -1) {
-			if ( c != (static_cast<long>(Rank)-1) ) {
-				P.permute(Rank-1,(size_t)c);
-				for (long ll=0      ; ll < last ; ++ll)
-					permuteBinary( LigneA[(size_t)ll], Rank, c);
+		if (! degeneratedense) {
+			SparseFindPivotBinary ( LigneA[(size_t)last], Rank, c, determinant);
+			if (c != -1) {
+				if ( c != (static_cast<long>(Rank)-1) ) {
+					P.permute(Rank-1,(size_t)c);
+					for (long ll=0      ; ll < last ; ++ll)
+						permuteBinary( LigneA[(size_t)ll], Rank, c);
+				}
 			}
 		}
 
@@ -208,6 +229,119 @@ namespace LinBox
 		return Rank;
 	}
 
+	// Packed dense tail of the elimination over GF2
+	template <class SparseSeqMatrix, class Perm>
+	inline unsigned long&
+	GaussDomain<GF2>::DenseInPlaceLinearPivotingBinary (unsigned long &Rank,
+							    SparseSeqMatrix        &LigneA,
+							    Perm           &P,
+							    unsigned long k,
+							    unsigned long Ni,
+							    unsigned long Nj) const
+	{
+		typedef typename SparseSeqMatrix::value_type Vector;
+		typedef typename Vector::value_type E;
+		typedef BitVector::word_iterator WordIterator;
+
+		// The Schur complement lives on rows k..Ni-1 and columns Rank..Nj-1
+		const unsigned long r0 = Rank;
+		const size_t sNi = (size_t)(Ni-k), sNj = (size_t)(Nj-r0);
+
+		commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+		<< "Packed dense elimination on " << sNi << " x " << sNj << " Schur complement" << std::endl;
+
+		std::vector<BitVector> D (sNi);
+		std::vector<size_t> weight (sNi);
+		for (size_t i = 0; i < sNi; ++i) {
+			D[i].resize (sNj);
+			Vector & row = LigneA[(size_t)k+i];
+			for (typename Vector::const_iterator it = row.begin(); it != row.end(); ++it) {
+				const size_t j = (size_t)*it - r0;
+				*(D[i].wordBegin() + (long)(j >> __LINBOX_LOGOF_SIZE)) |= 1UL << (j & __LINBOX_POS_ALL_ONES);
+			}
+			weight[i] = row.size();
+			Vector().swap(row);
+		}
+
+		for (size_t cur = 0; cur < sNi; ++cur) {
+			// Sparsest non zero row as pivot row
+			size_t p = sNi;
+			for (size_t l = cur; l < sNi; ++l)
+				if (weight[l] && ((p == sNi) || (weight[l] < weight[p])))
+					p = l;
+			if (p == sNi) break; // Schur complement is zero
+
+			if (p != cur) {
+				std::swap (D[cur], D[p]);
+				std::swap (weight[cur], weight[p]);
+			}
+
+			// First non zero column of the pivot row,
+			// columns before dc are zero in rows cur..sNi-1
+			const size_t dc = (size_t)(Rank - r0);
+			size_t w = dc >> __LINBOX_LOGOF_SIZE;
+			WordIterator pw = D[cur].wordBegin();
+			while (! *(pw + (long)w)) ++w;
+			unsigned long word = *(pw + (long)w);
+			size_t b = 0;
+			while (! ((word >> b) & 1UL)) ++b;
+			const size_t c = (w << __LINBOX_LOGOF_SIZE) + b;
+
+			if (c != dc) {
+				// Column permutation, in the packed block ...
+				const size_t wc = c >> __LINBOX_LOGOF_SIZE, bc = c & __LINBOX_POS_ALL_ONES;
+				const size_t wd = dc >> __LINBOX_LOGOF_SIZE, bd = dc & __LINBOX_POS_ALL_ONES;
+				for (size_t i = 0; i < sNi; ++i) {
+					WordIterator ri = D[i].wordBegin();
+					const unsigned long xc = (*(ri+(long)wc) >> bc) & 1UL;
+					const unsigned long xd = (*(ri+(long)wd) >> bd) & 1UL;
+					if (xc != xd) {
+						*(ri+(long)wc) ^= 1UL << bc;
+						*(ri+(long)wd) ^= 1UL << bd;
+					}
+				}
+				// ... and in the sparse rows above
+				const unsigned long indcol = Rank+1;
+				const long indpermut = (long)(r0 + c);
+				P.permute(Rank,(size_t)indpermut);
+				for (unsigned long ll = 0; ll < k; ++ll)
+					permuteBinary( LigneA[(size_t)ll], indcol, indpermut);
+			}
+			++Rank;
+
+			// Word-wise elimination below the pivot
+			const size_t wbeg = dc >> __LINBOX_LOGOF_SIZE, bdc = dc & __LINBOX_POS_ALL_ONES;
+			const WordIterator pbeg = D[cur].wordBegin() + (long)wbeg;
+			const WordIterator pend = D[cur].wordEnd();
+			for (size_t l = cur+1; l < sNi; ++l) {
+				WordIterator ri = D[l].wordBegin() + (long)wbeg;
+				if (! ((*ri >> bdc) & 1UL)) continue;
+				size_t wl = weight[l];
+				for (WordIterator pi = pbeg; pi != pend; ++pi, ++ri) {
+					wl -= PopCount (*ri);
+					*ri ^= *pi;
+					wl += PopCount (*ri);
+				}
+				weight[l] = wl;
+			}
+		}
+
+		// Back to sparse rows
+		for (size_t i = 0; i < sNi; ++i) {
+			Vector & row = LigneA[(size_t)k+i];
+			row.reserve (weight[i]);
+			size_t j = 0;
+			for (WordIterator ri = D[i].wordBegin(); ri != D[i].wordEnd(); ++ri, j += __LINBOX_BITSOF_LONG)
+				for (unsigned long word = *ri; word; word &= word - 1) {
+					size_t b = 0;
+					while (! ((word >> b) & 1UL)) ++b;
+					row.push_back ((E)(r0 + j + b));
+				}
+		}
+
+		return Rank;
+	}
+
 	// Specialization over GF2
 	template <class SparseSeqMatrix, class Perm> inline unsigned long&
 	GaussDomain<GF2>::QLUPin (unsigned long &Rank,
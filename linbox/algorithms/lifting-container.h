@@ -35,6 +35,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/perf-counters.h"
 
 #include "linbox/blackbox/apply.h"
 #include "linbox/algorithms/blackbox-container.h"
@@ -430,7 +431,11 @@ namespace LinBox
 
 				linbox_check (digit.size() == _lc._matA.rowdim());
 				// compute next p-adic digit
-				_lc.nextdigit(digit,_res);
+				{
+					LINBOX_PERF_TIMER("lifting: digit mod p");
+					_lc.nextdigit(digit,_res);
+				}
+				LINBOX_PERF_COUNT(PERF_LIFTING_DIGIT, 1);
 #ifdef RSTIMING
 				_lc.tRingApply.start();
 #endif
@@ -448,7 +453,11 @@ namespace LinBox
 
 				// compute v2 = _matA * digit
 				IVector v2 (_lc.ring(),_lc._matA.coldim());
-				_lc._MAD.applyV(v2,digit, _res);
+				{
+					LINBOX_PERF_TIMER("lifting: integer apply");
+					_lc._MAD.applyV(v2,digit, _res);
+				}
+				LINBOX_PERF_COUNT(PERF_BLACKBOX_APPLY, 1);
 
 #ifdef DEBUG_LC
 
@@ -697,6 +706,7 @@ namespace LinBox
 			// compute the solution by applying the inverse of A mod p
 			//_BA.applyV(_digit_p,_Ap,_res_p);
 			_Ap.apply(_digit_p, _res_p);
+			LINBOX_PERF_COUNT(PERF_FIELD_OPS, 2*(uint64_t)_Ap.rowdim()*_Ap.coldim());
 #ifdef RSTIMING
 			tGetDigit.stop();
 			ttGetDigit+=tGetDigit;
@@ -1020,9 +1030,6 @@ namespace LinBox
 
 		virtual ~BlockWiedemannLiftingContainer()
 		{
-#ifdef _BM_TIMING
-			_Dom->printTimer();
-#endif
 #ifdef _BBC_TIMING
 			_Seq->printTimer();
 #endif
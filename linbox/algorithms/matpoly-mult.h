@@ -32,6 +32,7 @@
 #include "linbox/util/error.h"
 #include "linbox/util/debug.h"
 #include "linbox/util/timer.h"
+#include "linbox/algorithms/polynomial-matrix/matpoly-mult-thresholds.h"
 #include <vector>
 #ifdef __LINBOX_HAVE_OPENMP
 #include <omp.h>
@@ -65,12 +66,22 @@ namespace LinBox
 		KaratsubaMulDomain<Field>     _kara;
 		FFTMulDomain<Field>            _fft;
 		ClassicMulDomain<Field>    _classic;
+		MatpolyMulDispatch      _thresholds; // tuned crossovers (see matpoly-mult-thresholds.h)
+
+		// largest dimension of the product b.c
+		template< class Polynomial2, class Polynomial3>
+		size_t dimension (const Polynomial2 &b, const Polynomial3 &c) const
+		{
+			if (b.size() == 0 || c.size() == 0) return 0;
+			return std::max(b[0].rowdim(),std::max(b[0].coldim(),c[0].coldim()));
+		}
 
 	public:
 		Timer multime;
 
 		PolynomialMatrixDomain ( const Field &F) :
-			_kara(F), _fft(F), _classic(F)
+			_kara(F), _fft(F), _classic(F),
+			_thresholds("sigma", F, KARA_DEG_THRESHOLD, FFT_DEG_THRESHOLD)
 		{multime.clear();}
 
 		template< class Polynomial1, class Polynomial2, class Polynomial3>
@@ -80,10 +91,11 @@ namespace LinBox
 			linbox_check(a.size() >= (b.size()+c.size()-1));
 			//Timer mul;
 			//mul.start();
-			if (d > FFT_DEG_THRESHOLD)
+			size_t dim = dimension(b,c);
+			if (d > _thresholds.fft(dim))
 				_fft.mul(a,b,c);
 			else
-				if ( d > KARA_DEG_THRESHOLD)
+				if ( d > _thresholds.karatsuba(dim))
 					_kara.mul(a,b,c);
 				else
 					_classic.mul(a,b,c);
@@ -107,10 +119,11 @@ namespace LinBox
 			//std::cout<<"midp "<<a.size()<<" = "<<b.size()<<" x "<<c.size()<<"...\n";
 			//Timer mul;
 			//mul.start();
-			if (d > FFT_DEG_THRESHOLD)
+			size_t dim = dimension(b,c);
+			if (d > _thresholds.fft(dim))
 				_fft.midproduct(a,b,c);
 			else
-				if ( d > KARA_DEG_THRESHOLD)
+				if ( d > _thresholds.karatsuba(dim))
 					_kara.midproduct(a,b,c);
 				else
 					_classic.midproduct(a,b,c);
@@ -134,10 +147,11 @@ namespace LinBox
 			//std::cout<<"midp "<<a.size()<<" = "<<b.size()<<" x "<<c.size()<<"...\n";
 			//Timer mul;
 			//mul.start();
-			if (d > FFT_DEG_THRESHOLD)
+			size_t dim = dimension(b,c);
+			if (d > _thresholds.fft(dim))
 				_fft.midproductgen(a,b,c);
 			else
-				if ( d > KARA_DEG_THRESHOLD)
+				if ( d > _thresholds.karatsuba(dim))
 					_kara.midproductgen(a,b,c);
 				else
 					_classic.midproductgen(a,b,c);
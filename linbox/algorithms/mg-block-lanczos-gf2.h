@@ -0,0 +1,152 @@
+/* linbox/algorithms/mg-block-lanczos-gf2.h
+ * Copyright (C) 2016 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ *
+ * Bit-sliced Montgomery block Lanczos over GF(2)
+ */
+
+#ifndef __LINBOX_mg_block_lanczos_gf2_H
+#define __LINBOX_mg_block_lanczos_gf2_H
+
+#include "linbox/linbox-config.h"
+
+#include <vector>
+
+#include "linbox/util/debug.h"
+#include "linbox/util/commentator.h"
+#include "linbox/field/gf2.h"
+#include "linbox/randiter/mersenne-twister.h"
+#include "linbox/solutions/methods.h"
+#include "linbox/algorithms/mg-block-lanczos.h"
+
+/** @file algorithms/mg-block-lanczos-gf2.h
+ * @brief Montgomery's block Lanczos over \f$F_2\f$ with 64-wide blocks.
+ */
+
+namespace LinBox
+{
+
+	/** \brief Block Lanczos iteration over GF(2), bit-sliced.
+	 *
+	 * Specialization of @ref MGBlockLanczosSolver where the \f$n\times 64\f$
+	 * blocks \f$V_i\f$ are stored as one 64-bit word per row. A sparse
+	 * apply is then one XOR of words per non zero entry and the
+	 * \f$64\times 64\f$ products \f$V^T A V\f$ are bit-matrix products
+	 * computed with 8-bit lookup tables, c.f. (Montgomery 1995).
+	 *
+	 * The blackbox \f$B\f$ must provide <code>applyBlock</code> and
+	 * <code>applyTransposeBlock</code> (e.g. @ref ZeroOne<GF2>). The
+	 * iteration always runs on the symmetrized \f$A = B^T B\f$, the
+	 * blocking factor is fixed to 64 and only nullspace sampling is
+	 * provided.
+	 */
+	template <class Matrix>
+	class MGBlockLanczosSolver<GF2, Matrix> {
+	public:
+
+		typedef GF2                   Field;
+		typedef Field::Element        Element;
+		typedef uint64_t              Word;
+		/// \f$n\times 64\f$ block, one word per row
+		typedef std::vector<Word>     Block;
+
+		/** Constructor
+		 * @param F Field over which to operate
+		 * @param traits @ref SolverTraits  structure describing user
+		 *               options for the solver (only maxTries is used)
+		 * @param seed seed of the random generator (0 means time)
+		 */
+		MGBlockLanczosSolver (const Field &F, const BlockLanczosTraits &traits, uint32_t seed = 0) :
+			_traits (traits), _field (&F), _MT (seed ? seed : (uint32_t)time (NULL))
+		{}
+
+		/** Sample uniformly from the (right) nullspace of B
+		 *
+		 * @param B Black box for the matrix B
+		 * @param x Block into whose bit columns to store nullspace
+		 *          elements; resized to B.coldim ()
+		 * @return Number of nullspace vectors found, stored in the
+		 *         lowest bits of the words of x
+		 */
+		template <class Blackbox>
+		unsigned int sampleNullspace (const Blackbox &B, Block &x);
+
+		/// Fill the first n words of X with random bits
+		Block &random (Block &X, size_t n);
+
+		/// C = X^T Y, a 64 x 64 bit matrix (C[i] is row i)
+		static void innerProduct (Word *C, const Block &X, const Block &Y, size_t n);
+
+		/// Y = Y + X C, for C a 64 x 64 bit matrix
+		static void mulAcc (Block &Y, const Block &X, const Word *C, size_t n);
+
+		/// C = A B, for 64 x 64 bit matrices (C may alias A or B)
+		static void mul (Word *C, const Word *A, const Word *B);
+
+	private:
+
+		// Y = B^T B X, using Z as the m x 64 temporary
+		template <class Blackbox>
+		Block &symmetricApply (Block &Y, const Blackbox &B, const Block &X) const;
+
+		// Run the block Lanczos iteration on A = B^T B, starting from V0,
+		// accumulating into x the solution to A x = V0 and leaving in v
+		// the last V_m. Return false if the method breaks down.
+		template <class Blackbox>
+		bool iterate (const Blackbox &B, Block &x, Block &v, const Block &V0);
+
+		// Compute W_i^inv and S_i given T = V_i^T A V_i, S_{i-1}
+		// being the first last_dim entries of last_s.
+		// Return the dimension of S_i, 0 on failure.
+		size_t compute_Winv_S (Word                      *Winv,
+				       std::vector<size_t>       &s,
+				       const Word                *T,
+				       const std::vector<size_t> &last_s,
+				       size_t                     last_dim) const;
+
+		// From A (x + v) = 0, find combinations of the columns of x and v
+		// which lie in the nullspace of B. They are stored back in x.
+		template <class Blackbox>
+		unsigned int combine (const Blackbox &B, Block &x, const Block &v) const;
+
+		inline const Field & field() const { return *_field; }
+
+		const BlockLanczosTraits _traits;
+		const Field              *_field;
+		MersenneTwister          _MT;
+
+		// Temporaries used in the computation
+		mutable Block            _Z;        // m x 64
+	};
+
+} // namespace LinBox
+
+#include "linbox/algorithms/mg-block-lanczos-gf2.inl"
+
+#endif // __LINBOX_mg_block_lanczos_gf2_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,445 @@
+/* linbox/algorithms/mg-block-lanczos-gf2.inl
+ * Copyright (C) 2016 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ *
+ * Bit-sliced Montgomery block Lanczos over GF(2)
+ */
+
+#ifndef __LINBOX_mg_block_lanczos_gf2_INL
+#define __LINBOX_mg_block_lanczos_gf2_INL
+
+#include <algorithm>
+#include <cstring>
+
+namespace LinBox
+{
+
+	template <class Matrix>
+	inline typename MGBlockLanczosSolver<GF2, Matrix>::Block &
+	MGBlockLanczosSolver<GF2, Matrix>::random (Block &X, size_t n)
+	{
+		X.resize (n);
+		for (size_t i = 0; i < n; ++i)
+			X[i] = ((Word)_MT.randomInt () << 32) | (Word)_MT.randomInt ();
+		return X;
+	}
+
+	template <class Matrix>
+	inline void MGBlockLanczosSolver<GF2, Matrix>::innerProduct (Word *C, const Block &X, const Block &Y, size_t n)
+	{
+		// One table of 256 partial sums per byte of X[i]
+		std::vector<Word> c (8*256, Word(0));
+
+		for (size_t i = 0; i < n; ++i) {
+			Word xi = X[i];
+			const Word yi = Y[i];
+			for (size_t b = 0; b < 8; ++b, xi >>= 8)
+				c[(b << 8) + (xi & 0xff)] ^= yi;
+		}
+
+		// Row 8b+k of C is the sum of the entries of table b
+		// whose index has bit k set
+		for (size_t b = 0; b < 8; ++b) {
+			const Word * cb = &c[b << 8];
+			for (size_t k = 0; k < 8; ++k) {
+				Word a (0);
+				for (size_t j = 0; j < 256; ++j)
+					if ((j >> k) & 1) a ^= cb[j];
+				C[8*b+k] = a;
+			}
+		}
+	}
+
+	template <class Matrix>
+	inline void MGBlockLanczosSolver<GF2, Matrix>::mulAcc (Block &Y, const Block &X, const Word *C, size_t n)
+	{
+		// T[b][j] = sum of rows 8b+k of C for bits k set in j
+		std::vector<Word> T (8*256);
+		for (size_t b = 0; b < 8; ++b) {
+			Word * Tb = &T[b << 8];
+			Tb[0] = 0;
+			for (size_t j = 1; j < 256; ++j) {
+				size_t k = 0;
+				while (! ((j >> k) & 1)) ++k;
+				Tb[j] = Tb[j & (j-1)] ^ C[8*b+k];
+			}
+		}
+
+		const long ln = (long)n;
+#pragma omp parallel for
+		for (long i = 0; i < ln; ++i) {
+			Word xi = X[(size_t)i];
+			if (! xi) continue;
+			Word yi = Y[(size_t)i];
+			for (size_t b = 0; b < 8; ++b, xi >>= 8)
+				yi ^= T[(b << 8) + (xi & 0xff)];
+			Y[(size_t)i] = yi;
+		}
+	}
+
+	template <class Matrix>
+	inline void MGBlockLanczosSolver<GF2, Matrix>::mul (Word *C, const Word *A, const Word *B)
+	{
+		Word tmp[64];
+		for (size_t i = 0; i < 64; ++i) {
+			Word ai = A[i], ci (0);
+			for (size_t k = 0; ai; ++k, ai >>= 1)
+				if (ai & 1) ci ^= B[k];
+			tmp[i] = ci;
+		}
+		std::copy (tmp, tmp+64, C);
+	}
+
+	template <class Matrix>
+	template <class Blackbox>
+	inline typename MGBlockLanczosSolver<GF2, Matrix>::Block &
+	MGBlockLanczosSolver<GF2, Matrix>::symmetricApply (Block &Y, const Blackbox &B, const Block &X) const
+	{
+		_Z.resize (B.rowdim ());
+		B.applyBlock (_Z, X);
+		return B.applyTransposeBlock (Y, _Z);
+	}
+
+	template <class Matrix>
+	template <class Blackbox>
+	inline unsigned int MGBlockLanczosSolver<GF2, Matrix>::sampleNullspace (const Blackbox &B, Block &x)
+	{
+		commentator().start ("Sampling from nullspace (Montgomery's bit-sliced block Lanczos)", "MGBlockLanczosSolver<GF2>::sampleNullspace");
+
+		const size_t n = B.coldim ();
+		unsigned int number = 0;
+
+		Block y, v, V0 (n);
+		x.resize (n);
+
+		for (unsigned int i = 0; number == 0 && i < _traits.maxTries (); ++i) {
+			commentator().report (Commentator::LEVEL_UNIMPORTANT, INTERNAL_DESCRIPTION)
+			<< "in try: " << i << std::endl;
+
+			// Find a right-hand side A y for the linear system A x = A y
+			random (y, n);
+			symmetricApply (V0, B, y);
+
+			std::fill (x.begin (), x.end (), Word(0));
+			if (! iterate (B, x, v, V0))
+				continue;
+
+			// A x = A y + (part of the Krylov space not reached yet)
+			for (size_t j = 0; j < n; ++j)
+				x[j] ^= y[j];
+
+			number = combine (B, x, v);
+		}
+
+		commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+		<< "Number of nullspace vectors found: " << number << std::endl;
+
+		commentator().stop ("done", NULL, "MGBlockLanczosSolver<GF2>::sampleNullspace");
+
+		return number;
+	}
+
+	template <class Matrix>
+	template <class Blackbox>
+	inline bool MGBlockLanczosSolver<GF2, Matrix>::iterate (const Blackbox &B, Block &x, Block &vm, const Block &V0)
+	{
+		commentator().start ("Bit-sliced block Lanczos iteration", "MGBlockLanczosSolver<GF2>::iterate", B.coldim ());
+
+		const size_t n = B.coldim ();
+
+		// v[0] is V_i, v[1] is V_{i-1}, v[2] is V_{i-2}
+		Block v[3], vnext (n);
+		v[0] = V0;
+		v[1].assign (n, Word(0));
+		v[2].assign (n, Word(0));
+
+		// Index 0 for the current iteration, 1 and 2 for the previous ones
+		Word vt_a_v[2][64], vt_a2_v[2][64], winv[3][64], vt_v0[64];
+		Word d[64], e[64], f[64], f2[64];
+		std::vector<size_t> s[2];
+		s[0].resize (64);
+		s[1].resize (64);
+
+		for (size_t k = 0; k < 64; ++k) {
+			s[1][k] = k;
+			vt_a_v[1][k] = vt_a2_v[1][k] = winv[1][k] = winv[2][k] = 0;
+		}
+		size_t dim1 = 64, total_dim = 0;
+		Word mask1 = ~Word(0);
+
+		// Expected number of iterations is n/(64-0.76)
+		const size_t max_iter = n/32 + 32;
+		size_t iter = 0;
+		bool ret = true;
+
+		for (;;) {
+			if (++iter > max_iter) {
+				commentator().report (Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+				<< "Too many iterations, breaking down" << std::endl;
+				ret = false;
+				break;
+			}
+
+			if (! (iter % 100))
+				commentator().progress ((long)total_dim);
+
+			symmetricApply (vnext, B, v[0]);
+
+			innerProduct (vt_a_v[0], v[0], vnext, n);
+			innerProduct (vt_a2_v[0], vnext, vnext, n);
+
+			// V_i^T A V_i = 0: the iteration has finished
+			bool finished = true;
+			for (size_t k = 0; k < 64; ++k)
+				if (vt_a_v[0][k]) { finished = false; break; }
+			if (finished) break;
+
+			const size_t dim0 = compute_Winv_S (winv[0], s[0], vt_a_v[0], s[1], dim1);
+			if (dim0 == 0) {
+				commentator().report (Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+				<< "V_i^T A V_i has no suitable invertible submatrix, breaking down" << std::endl;
+				ret = false;
+				break;
+			}
+			total_dim += dim0;
+
+			Word mask0 (0);
+			for (size_t k = 0; k < dim0; ++k)
+				mask0 |= Word(1) << s[0][k];
+
+			// A V_i S_i S_i^T
+			if (mask0 != ~Word(0))
+				for (size_t j = 0; j < n; ++j)
+					vnext[j] &= mask0;
+
+			innerProduct (vt_v0, v[0], V0, n);
+
+			// D = I_N - Winv_i (V_i^T A^2 V_i S_i S_i^T + V_i^T A V_i)
+			for (size_t k = 0; k < 64; ++k)
+				d[k] = (vt_a2_v[0][k] & mask0) ^ vt_a_v[0][k];
+			mul (d, winv[0], d);
+			for (size_t k = 0; k < 64; ++k)
+				d[k] ^= Word(1) << k;
+
+			// E = - Winv_{i-1} V_i^T A V_i S_i S_i^T
+			mul (e, winv[1], vt_a_v[0]);
+			for (size_t k = 0; k < 64; ++k)
+				e[k] &= mask0;
+
+			// F = - Winv_{i-2} (I_N - V_{i-1}^T A V_{i-1} Winv_{i-1})
+			//     (V_{i-1}^T A^2 V_{i-1} S_{i-1} S_{i-1}^T + V_{i-1}^T A V_{i-1}) S_i S_i^T
+			mul (f, vt_a_v[1], winv[1]);
+			for (size_t k = 0; k < 64; ++k)
+				f[k] ^= Word(1) << k;
+			mul (f, winv[2], f);
+			for (size_t k = 0; k < 64; ++k)
+				f2[k] = ((vt_a2_v[1][k] & mask1) ^ vt_a_v[1][k]) & mask0;
+			mul (f, f, f2);
+
+			// V_{i+1} = A V_i S_i S_i^T + V_i D + V_{i-1} E + V_{i-2} F
+			mulAcc (vnext, v[0], d, n);
+			mulAcc (vnext, v[1], e, n);
+			mulAcc (vnext, v[2], f, n);
+
+			// x += V_i Winv_i V_i^T V0
+			mul (d, winv[0], vt_v0);
+			mulAcc (x, v[0], d, n);
+
+			// Shift the temporaries
+			v[2].swap (v[1]);
+			v[1].swap (v[0]);
+			v[0].swap (vnext);
+
+			std::copy (vt_a_v[0], vt_a_v[0]+64, vt_a_v[1]);
+			std::copy (vt_a2_v[0], vt_a2_v[0]+64, vt_a2_v[1]);
+			std::copy (winv[1], winv[1]+64, winv[2]);
+			std::copy (winv[0], winv[0]+64, winv[1]);
+			s[1].swap (s[0]);
+			mask1 = mask0;
+			dim1 = dim0;
+		}
+
+		commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+		<< "Iterations: " << iter << ", total dimension: " << total_dim << std::endl;
+
+		vm.swap (v[0]);
+
+		commentator().stop (ret ? "done" : "breakdown", NULL, "MGBlockLanczosSolver<GF2>::iterate");
+
+		return ret;
+	}
+
+	template <class Matrix>
+	inline size_t MGBlockLanczosSolver<GF2, Matrix>::compute_Winv_S (Word                      *Winv,
+									 std::vector<size_t>       &s,
+									 const Word                *T,
+									 const std::vector<size_t> &last_s,
+									 size_t                     last_dim) const
+	{
+		// M = [T | I_N]
+		Word M[64][2];
+		for (size_t k = 0; k < 64; ++k) {
+			M[k][0] = T[k];
+			M[k][1] = Word(1) << k;
+		}
+
+		// Columns of S_{i-1} are tried last
+		Word mask (0);
+		for (size_t k = 0; k < last_dim; ++k) {
+			mask |= Word(1) << last_s[k];
+			s[63-k] = last_s[k];
+		}
+		for (size_t k = 0, j = 0; k < 64; ++k)
+			if (! (mask & (Word(1) << k)))
+				s[j++] = k;
+
+		size_t dim = 0;
+		for (size_t i = 0; i < 64; ++i) {
+			const Word bit = Word(1) << s[i];
+			Word * row_i = M[s[i]];
+			size_t j;
+
+			// Pivot in the left half: column s[i] is selected
+			for (j = i; j < 64; ++j) {
+				Word * row_j = M[s[j]];
+				if (row_j[0] & bit) {
+					std::swap (row_i[0], row_j[0]);
+					std::swap (row_i[1], row_j[1]);
+					break;
+				}
+			}
+			if (j < 64) {
+				for (j = 0; j < 64; ++j) {
+					Word * row_j = M[s[j]];
+					if ((row_j != row_i) && (row_j[0] & bit)) {
+						row_j[0] ^= row_i[0];
+						row_j[1] ^= row_i[1];
+					}
+				}
+				s[dim++] = s[i];
+				continue;
+			}
+
+			// Otherwise use the right half to compensate
+			for (j = i; j < 64; ++j) {
+				Word * row_j = M[s[j]];
+				if (row_j[1] & bit) {
+					std::swap (row_i[0], row_j[0]);
+					std::swap (row_i[1], row_j[1]);
+					break;
+				}
+			}
+			if (j == 64)
+				return 0; // Not invertible
+
+			for (j = 0; j < 64; ++j) {
+				Word * row_j = M[s[j]];
+				if ((row_j != row_i) && (row_j[1] & bit)) {
+					row_j[0] ^= row_i[0];
+					row_j[1] ^= row_i[1];
+				}
+			}
+			row_i[0] = row_i[1] = 0;
+		}
+
+		for (size_t k = 0; k < 64; ++k)
+			Winv[k] = M[k][1];
+
+		// Every column must appear in S_i or S_{i-1}
+		mask = 0;
+		for (size_t k = 0; k < dim; ++k)
+			mask |= Word(1) << s[k];
+		for (size_t k = 0; k < last_dim; ++k)
+			mask |= Word(1) << last_s[k];
+
+		return (mask == ~Word(0)) ? dim : 0;
+	}
+
+	template <class Matrix>
+	template <class Blackbox>
+	inline unsigned int MGBlockLanczosSolver<GF2, Matrix>::combine (const Blackbox &B, Block &x, const Block &v) const
+	{
+		const size_t m = B.rowdim (), n = B.coldim ();
+		const size_t wm = (m+63)/64, wn = (n+63)/64, w = wm + wn;
+
+		Block Bx (m), Bv (m);
+		B.applyBlock (Bx, x);
+		B.applyBlock (Bv, v);
+
+		// The 128 columns of [B x | B v] followed by those of [x | v]
+		std::vector<Block> C (128, Block (w, Word(0)));
+		for (size_t i = 0; i < m; ++i)
+			for (size_t k = 0; k < 64; ++k) {
+				C[k][i/64]    |= ((Bx[i] >> k) & 1) << (i%64);
+				C[64+k][i/64] |= ((Bv[i] >> k) & 1) << (i%64);
+			}
+		for (size_t j = 0; j < n; ++j)
+			for (size_t k = 0; k < 64; ++k) {
+				C[k][wm+j/64]    |= ((x[j] >> k) & 1) << (j%64);
+				C[64+k][wm+j/64] |= ((v[j] >> k) & 1) << (j%64);
+			}
+
+		// Elimination on the B parts, combinations with a zero B part
+		// are in the nullspace of B.
+		std::vector<size_t> kernel;
+		for (size_t r = 0; r < 128; ++r) {
+			size_t p = 0;
+			while ((p < wm) && ! C[r][p]) ++p;
+			if (p == wm) { kernel.push_back (r); continue; }
+			const Word bit = C[r][p] & (~C[r][p] + 1);
+			for (size_t l = r+1; l < 128; ++l)
+				if (C[l][p] & bit)
+					for (size_t q = p; q < w; ++q)
+						C[l][q] ^= C[r][q];
+		}
+
+		// Independent non zero ones among them
+		unsigned int number = 0;
+		std::fill (x.begin (), x.end (), Word(0));
+		for (size_t t = 0; (t < kernel.size ()) && (number < 64); ++t) {
+			Block & row = C[kernel[t]];
+			size_t p = wm;
+			while ((p < w) && ! row[p]) ++p;
+			if (p == w) continue;
+			const Word bit = row[p] & (~row[p] + 1);
+			for (size_t l = t+1; l < kernel.size (); ++l)
+				if (C[kernel[l]][p] & bit)
+					for (size_t q = p; q < w; ++q)
+						C[kernel[l]][q] ^= row[q];
+			for (size_t j = 0; j < n; ++j)
+				x[j] |= ((row[wm+j/64] >> (j%64)) & 1) << number;
+			++number;
+		}
+
+		return number;
+	}
+
+} // namespace LinBox
+
+#endif // __LINBOX_mg_block_lanczos_gf2_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
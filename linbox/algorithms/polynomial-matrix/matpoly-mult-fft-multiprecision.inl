@@ -54,6 +54,15 @@ namespace LinBox{
   private:
     const IntField     *_field;
     integer           _maxnorm;
+    size_t           _nthreads;
+
+    // split the threads between the products modulo the num_primes
+    // FFT primes (outer) and each of these products (inner)
+    void splitThreads(size_t num_primes, size_t &outer, size_t &inner) const {
+      size_t nt = (_nthreads?_nthreads:matpolyFFTNumThreads());
+      outer = std::max((size_t)1, std::min(nt, num_primes));
+      inner = std::max((size_t)1, nt/outer);
+    }
 
     template<typename PMatrix1>
     size_t logmax(const PMatrix1& A) const {
@@ -71,8 +80,12 @@ namespace LinBox{
     inline const IntField & field() const { return *_field; }
 
 
-    PolynomialMatrixFFTMulDomain (const IntField &F, const integer maxnorm=0) :
-      _field(&F), _maxnorm(maxnorm) {}
+    // nthreads: number of threads of the products (0 means all the available threads)
+    PolynomialMatrixFFTMulDomain (const IntField &F, const integer maxnorm=0, size_t nthreads=0) :
+      _field(&F), _maxnorm(maxnorm), _nthreads(nthreads) {}
+
+    size_t getNumThreads() const { return _nthreads; }
+    void setNumThreads(size_t nthreads) { _nthreads=nthreads; }
 
     template<typename PMatrix1, typename PMatrix2, typename PMatrix3>
     void mul (PMatrix1 &c, const PMatrix2 &a, const PMatrix3 &b, size_t max_rowdeg=0) {
@@ -201,9 +214,14 @@ namespace LinBox{
       FFT_PROFILING(2,"reduction mod pi of input matrices");
 
       std::vector<MatrixP_F*> c_i (num_primes);
-      
-      for (size_t l=0;l<num_primes;l++)
+      size_t outer, inner;
+      splitThreads(num_primes, outer, inner);
+
+      // the products modulo each prime are independent
+#pragma omp parallel for num_threads(outer) schedule(dynamic)
+      for (index_t ll=0;ll<(index_t)num_primes;ll++)
 	{
+	  size_t l=(size_t)ll;
 	  //FFT_PROFILE_START;
 	  ModField f(RNS._basis[l]);
 	  MatrixP_F a_i (f, m, k, pts);
@@ -225,11 +243,11 @@ namespace LinBox{
 	  
 	  //FFT_PROFILE_GET(tCopy);
 	  //PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f);
-	  PolynomialMatrixThreePrimesFFTMulDomain<ModField> fftdomain (f);
+	  PolynomialMatrixThreePrimesFFTMulDomain<ModField> fftdomain (f,inner);
 	  integer bound=integer(RNS._basis[l]-1)*integer(RNS._basis[l]-1)
 	    *integer((uint64_t) k)*integer((uint64_t)std::min(a.size(),b.size()));
 
-	  fftdomain.mul_fft(lpts, *c_i[l], a_i, b_i, bound);
+	  fftdomain.mul_fft(lpts, *c_i[l], a_i, b_i, bound, s);
 	  //std::cout<<"c"<<l<<":="<<*c_i[l]<<";\n";
 	  //std::cout<<"p"<<l<<":="<<uint64_t(RNS._basis[l])<<";\n";
 	  //FFT_PROFILE_GET(tMul);
@@ -341,8 +359,12 @@ namespace LinBox{
 	smallRNS.init(1, n_tb, t_b_mod, n_tb, b.getPointer(), n_tb, maxB);
 	FFT_PROFILING(2,"reduction mod pi of input matrices");
 
-	for (size_t l=0;l<rns_chunk;l++)
+	size_t outer, inner;
+	splitThreads(rns_chunk, outer, inner);
+#pragma omp parallel for num_threads(outer) schedule(dynamic)
+	for (index_t ll=0;ll<(index_t)rns_chunk;ll++)
 	  {	    
+	    size_t l=(size_t)ll;
 	    //FFT_PROFILE_START;
 	    //std::cout<<"prime: "<<(long)smallRNS._basis[l]<<std::endl;
 	    ModField f(smallRNS._basis[l]);
@@ -358,11 +380,11 @@ namespace LinBox{
 		b_i.ref(i,j)=t_b_mod[l*n_tb+j+i*b.size()];	
 	    //FFT_PROFILE_GET(tCopy);
 	    //PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f);
-	    PolynomialMatrixThreePrimesFFTMulDomain<ModField> fftdomain (f);
+	    PolynomialMatrixThreePrimesFFTMulDomain<ModField> fftdomain (f,inner);
 	    integer bound=integer(smallRNS._basis[l]-1)*integer(smallRNS._basis[l]-1)
 	      *integer(k)*integer((uint64_t)std::min(a.size(),b.size()));
 	    
-	    fftdomain.mul_fft(lpts, *c_i[loop+l], a_i, b_i, bound);	
+	    fftdomain.mul_fft(lpts, *c_i[loop+l], a_i, b_i, bound, s);	
 	    //FFT_PROFILE_GET(tMul);
 	  }      
 	FFT_PROFILING(2,"FFTprime mult+copying");
@@ -497,8 +519,13 @@ namespace LinBox{
       FFT_PROFILING(2,"reduction mod pi of input matrices");
 
       std::vector<MatrixP_F*> c_i (num_primes);
+      size_t outer, inner;
+      splitThreads(num_primes, outer, inner);
 
-      for (size_t l=0;l<num_primes;l++){
+      // the products modulo each prime are independent
+#pragma omp parallel for num_threads(outer) schedule(dynamic)
+      for (index_t ll=0;ll<(index_t)num_primes;ll++){
+	size_t l=(size_t)ll;
 	FFT_PROFILE_START(2);
 	ModField f(RNS._basis[l]);
 	MatrixP_F a_i (f, m, k, pts);
@@ -520,7 +547,7 @@ namespace LinBox{
 	      b_i.ref(i,hdeg-1-j)=t_b_mod[l*n_tb+j+i*b.size()];
 	FFT_PROFILE_GET(2,tCopy);
 	//PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f);
-	PolynomialMatrixThreePrimesFFTMulDomain<ModField> fftdomain (f);       
+	PolynomialMatrixThreePrimesFFTMulDomain<ModField> fftdomain (f,inner);
 	integer bound2=integer(RNS._basis[l]-1)*integer(RNS._basis[l]-1)
 	  *integer((uint64_t)a.coldim())*integer((uint64_t)std::min(a.size(),b.size()));
 	fftdomain.midproduct_fft(lpts, *(c_i[l]), a_i, b_i, bound2, smallLeft);
@@ -585,14 +612,19 @@ namespace LinBox{
   private:
     const Field            *_field;  // Read only
     integer                     _p;
+    size_t               _nthreads;
 
   public:
     inline const Field & field() const { return *_field; }
 
-    PolynomialMatrixFFTMulDomain(const Field &F) : _field(&F) {
+    // nthreads: number of threads of the products (0 means all the available threads)
+    PolynomialMatrixFFTMulDomain(const Field &F, size_t nthreads=0) : _field(&F), _nthreads(nthreads) {
       field().cardinality(_p);
     }
 
+    size_t getNumThreads() const { return _nthreads; }
+    void setNumThreads(size_t nthreads) { _nthreads=nthreads; }
+
     template<typename Matrix1, typename Matrix2, typename Matrix3>
     void mul (Matrix1 &c, const Matrix2 &a, const Matrix3 &b, size_t max_rowdeg=0) {
       FFT_PROFILE_START(2);
@@ -614,7 +646,7 @@ namespace LinBox{
 
       FFT_PROFILE_START(2);
       IntField Z;      
-      PolynomialMatrixFFTMulDomain<IntField> Zmul(Z,_p);
+      PolynomialMatrixFFTMulDomain<IntField> Zmul(Z,_p,_nthreads);
       integer bound=2*_p*_p*integer((uint64_t)a.coldim())*integer((uint64_t)std::min(a.size(),b.size()));
 #ifdef TRY1
       Zmul.mul_crtla2(c,a,b,_p,_p,bound); 
@@ -647,7 +679,7 @@ namespace LinBox{
     void midproduct (MatrixP_F &c, const MatrixP_F &a, const MatrixP_F &b,
 		     bool smallLeft=true, size_t n0=0, size_t n1=0) {
       IntField Z;
-      PolynomialMatrixFFTMulDomain<IntField> Zmul(Z,_p);
+      PolynomialMatrixFFTMulDomain<IntField> Zmul(Z,_p,_nthreads);
       //const MatrixP_I* a2 = reinterpret_cast<const MatrixP_I*>(&a);
       //const MatrixP_I* b2 = reinterpret_cast<const MatrixP_I*>(&b);
       //MatrixP_I* c2       = reinterpret_cast<MatrixP_I*>(&c);
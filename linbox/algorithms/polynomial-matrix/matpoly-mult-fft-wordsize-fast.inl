@@ -32,9 +32,43 @@
 #include "linbox/matrix/polynomial-matrix.h"
 #include "linbox/matrix/matrix-domain.h"
 #include "linbox/algorithms/polynomial-matrix/polynomial-fft-transform.h"
+#include "linbox/algorithms/polynomial-matrix/polynomial-fft-transform-64.h"
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+// minimal number of coefficients handled by a parallel section of the FFT products
+#ifndef FFT_THREAD_THRESHOLD
+#define FFT_THREAD_THRESHOLD 16384
+#endif
 
 namespace LinBox {
 
+	// default number of threads of the FFT polynomial matrix products
+	inline size_t matpolyFFTNumThreads () {
+#ifdef __LINBOX_USE_OPENMP
+		return (size_t) omp_get_max_threads();
+#else
+		return 1;
+#endif
+	}
+
+	// Recover the cyclic middle product computed by midproduct_fft (on
+	// pts points, first operand reversed over hdeg coefficients) from the
+	// psize first coefficients of the full product p:
+	// c[t] = sum of p[s] for s = t+hdeg-1 mod pts
+	template<typename Field>
+	void foldMidproduct (PolynomialMatrix<PMType::polfirst,PMStorage::plain,Field> &c,
+			     const PolynomialMatrix<PMType::polfirst,PMStorage::plain,Field> &p,
+			     size_t psize, size_t hdeg, size_t pts) {
+		for (size_t i = 0; i < c.rowdim()*c.coldim(); i++)
+			for (size_t t = 0; t < c.size(); t++) {
+				c.ref(i,t) = c.field().zero;
+				for (size_t s = (t+hdeg-1) % pts; s < psize; s += pts)
+					c.field().addin(c.ref(i,t), p.get(i,s));
+			}
+	}
+
 	/***********************************************************************************
 	 **** Polynomial Matrix Multiplication over Zp[x] with p (FFTPrime, FFLAS prime) ***
 	 ***********************************************************************************/
@@ -47,17 +81,26 @@ namespace LinBox {
 		typedef PolynomialMatrix<PMType::polfirst,PMStorage::plain,Field> MatrixP;
 		// Polynomial matrix stored as a polynomial of matrix
 		typedef PolynomialMatrix<PMType::matfirst,PMStorage::plain,Field> PMatrix;
+		typedef typename Field::Element                                  Element;
 
 	private:
 		const Field              *_field;  // Read only
 		uint64_t                      _p;
 		BlasMatrixDomain<Field>     _BMD;
+		size_t                 _nthreads;
 
 	public:
 		inline const Field & field() const { return *_field; }
 
-		PolynomialMatrixFFTPrimeMulDomain(const Field &F)
-			: _field(&F), _p(field().cardinality()),  _BMD(F){}
+		/** nthreads is the number of threads used by the transforms and
+		 * the pointwise products (0 means all the available threads).
+		 */
+		PolynomialMatrixFFTPrimeMulDomain(const Field &F, size_t nthreads=0)
+			: _field(&F), _p(field().cardinality()),  _BMD(F),
+			  _nthreads(nthreads?nthreads:matpolyFFTNumThreads()){}
+
+		size_t getNumThreads() const { return _nthreads; }
+		void setNumThreads(size_t nthreads) { _nthreads=(nthreads?nthreads:matpolyFFTNumThreads()); }
 
 		template<typename Matrix1, typename Matrix2, typename Matrix3>
 		void mul (Matrix1 &c, const Matrix2 &a, const Matrix3 &b, size_t max_rowdeg=0) {
@@ -71,7 +114,7 @@ namespace LinBox {
 			a2.copy(a,0,a.size()-1);
 			b2.copy(b,0,b.size()-1);
 			MatrixP c2(field(),c.rowdim(),c.coldim(),pts);
-			mul_fft (lpts,c2, a2, b2);
+			mul_fft (lpts,c2, a2, b2, deg+1);
 			c.copy(c2,0,deg);
 		}
 
@@ -88,18 +131,20 @@ namespace LinBox {
 			b2.copy(b,0,b.size()-1);
 			// resize c to 2^lpts
 			c.resize(pts);
-			mul_fft (lpts,c, a2, b2);
+			mul_fft (lpts,c, a2, b2, deg+1);
 			c.resize(deg+1);
 		}
 
 		// a,b and c must have size: 2^lpts
-		// -> use TFT to circumvent the padding issue
-		void mul_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b) {
+		// -> only the first npts evaluation points are used (TFT), the
+		// product must have less than npts coefficients (0 means 2^lpts)
+		void mul_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b, size_t npts=0) {
 			FFT_PROFILE_START(1);
 			size_t m = a.rowdim();
 			size_t k = a.coldim();
 			size_t n = b.coldim();
 			size_t pts=c.size();
+			if (npts == 0 || npts > pts) npts = pts;
 			//std::cout<<"mul : 2^"<<lpts<<std::endl;
 
 #ifdef CHECK_MATPOL_MUL
@@ -112,7 +157,7 @@ namespace LinBox {
 #ifdef FFT_PROFILER
 			Timer totalTime;
 			totalTime.start();
-			if (FFT_PROF_LEVEL==1) std::cout<<"FFT: points "<<pts<<"\n";
+			if (FFT_PROF_LEVEL==1) std::cout<<"FFT: points "<<npts<<" ("<<pts<<")\n";
 #endif
 
 			if ((_p-1) % pts != 0) {
@@ -121,8 +166,8 @@ namespace LinBox {
 				std::cout<<"nbr points="<<pts<<std::endl;
 				throw LinboxError("LinBox ERROR: bad FFT Prime\n");
 			}
-			FFT_transform<Field> FFTer (field(), lpts);
-			FFT_transform<Field> FFTinv (field(), lpts, FFTer.getInvRoot());
+			FFT_transform<Field> FFTer (field(), lpts, FFT_plan_cache::get(_p, lpts));
+			FFT_transform<Field> FFTinv (field(), lpts, FFT_plan_cache::get(_p, lpts, true));
 			FFT_PROFILING(1,"init");
 
 			// std::cout<<"FFT Root: "<<FFTer.getRoot()<<std::endl;
@@ -131,10 +176,8 @@ namespace LinBox {
 			// std::cout<<b<<std::endl;
 			
 			// FFT transformation on the input matrices
-			for (size_t i = 0; i < m * k; i++)
-				FFTer.FFT_DIF(&(a.ref(i,0)));
-			for (size_t i = 0; i < k * n; i++)
-				FFTer.FFT_DIF(&(b.ref(i,0)));
+			transform_DIF(FFTer, a, m * k, npts);
+			transform_DIF(FFTer, b, k * n, npts);
 			FFT_PROFILING(1,"direct FFT_DIF");
 			
 			//std::cout<<"DIF:  w="<<FFTer._w<<std::endl;
@@ -142,44 +185,42 @@ namespace LinBox {
 			//std::cout<<b<<std::endl;
 			
 			
-			// convert the matrix representation to matfirst (with double coefficient)
-			PMatrix vm_c (field(), m, n, pts);
 #ifdef TRY1
+			PMatrix vm_c (field(), m, n, npts);
 			BlasMatrix<Field> vm_a(field(),m,k);
 			BlasMatrix<Field> vm_b(field(),k,n);
 			FFT_PROFILING(1,"creation of Matfirst");
 
 			// Pointwise multiplication
-			for (size_t i = 0; i < pts; ++i){
+			for (size_t i = 0; i < npts; ++i){
 				a.setMatrix(vm_a,i);
 				b.setMatrix(vm_b,i);
 				_BMD.mul(vm_c[i], vm_a, vm_b);
 			}
 			FFT_PROFILING(1,"Pointwise mult");
-			
+			c.copy(vm_c,0,npts-1);
 #else
-			PMatrix vm_a (field(), m, k, pts);
-			PMatrix vm_b (field(), k, n, pts);
+			// the evaluations as consecutive matrices, in buffers of the pool
+			typename MatrixP::Buffer vm_a (m*k*npts), vm_b (k*n*npts), vm_c (m*n*npts);
 			FFT_PROFILING(1,"creation of Matfirst");
-			vm_a.copy(a);
-			vm_b.copy(b);
+			a.getMatrices(vm_a.data(),0,npts-1);
+			b.getMatrices(vm_b.data(),0,npts-1);
 			FFT_PROFILING(1,"Polfirst to Matfirst");
 
 			// Pointwise multiplication
-			for (size_t i = 0; i < pts; ++i)
-				_BMD.mul(vm_c[i], vm_a[i], vm_b[i]);
+			pointwise_mul(npts, m, k, n, vm_c.data(), vm_a.data(), vm_b.data());
 			FFT_PROFILING(1,"Pointwise mult");
-#endif			
-			// Transformation into matrix of polynomials (with int32_t coefficient)
-			c.copy(vm_c);
+
+			// Transformation into matrix of polynomials
+			c.setMatrices(vm_c.data(),0,npts-1);
+#endif
 			FFT_PROFILING(1,"Matfirst to Polfirst");
 
 			//std::cout<<"pointwise:"<<std::endl;
 			//std::cout<<c<<std::endl;			
 			
 			// Inverse FFT on the output matrix
-			for (size_t i = 0; i < m * n; i++)
-				FFTinv.FFT_DIT(&(c.ref(i,0)));
+			transform_DIT(FFTinv, c, m * n, npts);
 			FFT_PROFILING(1,"inverse FFT_DIT");
 
 			// std::cout<<"DIT:"<<std::endl;
@@ -209,6 +250,88 @@ namespace LinBox {
 #endif
 		}
 
+		/** Operand of a product kept in evaluated form: its values at
+		 * the npts first points of the transform of size 2^lpts, the
+		 * smallest one with npts <= 2^lpts. The twiddle tables are
+		 * taken from FFT_plan_cache by the first transform and kept
+		 * with the values: the inverse transform of mul() uses the same
+		 * root of unity even if the cache is cleared meanwhile. An
+		 * operand can be transformed once and reused in all the products
+		 * whose result has at most npts coefficients, with operands
+		 * evaluated on the same points.
+		 */
+		struct Transformed {
+			size_t           lpts;
+			size_t           npts;
+			PMatrix        values;
+			FFT_plan_cache::Plan  direct;  //!< tables of the evaluation
+			FFT_plan_cache::Plan inverse;  //!< tables of the interpolation, root direct->invw
+
+			Transformed (const Field &F, size_t m, size_t n, size_t np)
+				: lpts(0), npts(np), values(F, m, n, np) {
+				while (((size_t)1 << lpts) < npts) ++lpts;
+			}
+		};
+
+		// t = the evaluation of a (a.size() <= t.npts), on the points of
+		// t.direct if t was already given tables
+		void transform (Transformed &t, const MatrixP &a) {
+			linbox_check(a.size() <= t.npts);
+			linbox_check(a.rowdim() == t.values.rowdim() && a.coldim() == t.values.coldim());
+			size_t pts = (size_t)1 << t.lpts;
+			if ((_p-1) % pts != 0)
+				throw LinboxError("LinBox ERROR: bad FFT Prime\n");
+			if (!t.direct) {
+				t.direct  = FFT_plan_cache::get(_p, t.lpts);
+				t.inverse = FFT_plan_cache::get(_p, t.lpts, true);
+				// the cache may have been cleared between the two lookups
+				if (t.inverse->w != t.direct->invw)
+					t.inverse = std::make_shared<const FFT_tables> (_p, t.lpts, t.direct->invw);
+			}
+			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
+			a2.copy(a,0,a.size()-1);
+			FFT_transform<Field> FFTer (field(), t.lpts, t.direct);
+			transform_DIF(FFTer, a2, a.rowdim() * a.coldim(), t.npts);
+			t.values.copy(a2,0,t.npts-1);
+		}
+
+		// c = a*b from the evaluations of a and b on the same points,
+		// c is resized to npts (deg(a)+deg(b) < npts)
+		void mul (MatrixP &c, const Transformed &a, const Transformed &b) {
+			linbox_check(a.npts == b.npts);
+			linbox_check(a.values.coldim() == b.values.rowdim());
+			if (a.direct->w != b.direct->w)
+				throw LinboxError("LinBox ERROR: operands evaluated on different points\n");
+			size_t m = a.values.rowdim();
+			size_t n = b.values.coldim();
+			size_t npts = a.npts;
+			size_t pts = (size_t)1 << a.lpts;
+
+			PMatrix vm_c (field(), m, n, npts);
+			pointwise_mul(vm_c, a.values, b.values);
+
+			MatrixP c2(field(),m,n,pts);
+			c2.copy(vm_c,0,npts-1);
+			FFT_transform<Field> FFTinv (field(), a.lpts, a.inverse);
+			transform_DIT(FFTinv, c2, m * n, npts);
+
+			typename Field::Element inv_pts;
+			field().init(inv_pts, pts);
+			field().invin(inv_pts);
+			c.resize(npts);
+			c.copy(c2,0,npts-1);
+			FFLAS::fscalin(field(),c.rowdim()*c.coldim()*c.size(), inv_pts,  c.getWritePointer(),1);
+		}
+
+		// c = a*b where only a is in evaluated form
+		void mul (MatrixP &c, const Transformed &a, const MatrixP &b) {
+			Transformed tb (field(), b.rowdim(), b.coldim(), a.npts);
+			tb.direct  = a.direct;
+			tb.inverse = a.inverse;
+			transform(tb, b);
+			mul(c, a, tb);
+		}
+
 		// compute  c= (a*b x^(-n0-1)) mod x^n1
 		// by defaut: n0=c.size() and n1=2*c.size()-1;
 		template<typename Matrix1, typename Matrix2, typename Matrix3>
@@ -226,6 +349,25 @@ namespace LinBox {
 
 			size_t lpts = 0;
 			size_t pts  = 1; while (pts < deg) { pts= pts<<1; ++lpts; }
+
+			size_t psize = a.size()+b.size()-1;
+			if (psize < pts) {
+				// the full product needs fewer evaluation points than
+				// the cyclic middle product: compute it with the TFT
+				size_t lppts = 0;
+				size_t ppts  = 1; while (ppts < psize) { ppts= ppts<<1; ++lppts; }
+				MatrixP a2(field(),a.rowdim(),a.coldim(),ppts);
+				MatrixP b2(field(),b.rowdim(),b.coldim(),ppts);
+				MatrixP p2(field(),c.rowdim(),c.coldim(),ppts);
+				a2.copy(a,0,a.size()-1);
+				b2.copy(b,0,b.size()-1);
+				mul_fft (lppts, p2, a2, b2, psize);
+				MatrixP c2(field(),c.rowdim(),c.coldim(),c.size());
+				foldMidproduct(c2, p2, psize, hdeg, pts);
+				c.copy(c2,0,c.size()-1);
+				return;
+			}
+
 			// padd the input a and b to 2^lpts (use MatrixP representation)
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
 			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
@@ -266,46 +408,38 @@ namespace LinBox {
 				std::cout<<"nbr points="<<pts<<std::endl;
 				throw LinboxError("LinBox ERROR: bad FFT Prime\n");
 			}
-			FFT_transform<Field> FFTer (field(), lpts);
-			FFT_transform<Field> FFTinv(field(), lpts, FFTer.getInvRoot());
+			FFT_transform<Field> FFTer (field(), lpts, FFT_plan_cache::get(_p, lpts));
+			FFT_transform<Field> FFTinv (field(), lpts, FFT_plan_cache::get(_p, lpts, true));
 			FFT_PROFILING(1,"init");
 
 			// FFT transformation on the input matrices
 			if (smallLeft){
-				for (size_t i = 0; i < m * k; i++)
-					FFTer.FFT_DIF(&(a(i)[0]));
-				for (size_t i = 0; i < k * n; i++)
-					FFTinv.FFT_DIF(&(b(i)[0]));
+				transform_DIF(FFTer, a, m * k, pts);
+				transform_DIF(FFTinv, b, k * n, pts);
 			}
 			else {
-				for (size_t i = 0; i < m * k; i++)
-					FFTinv.FFT_DIF(&(a(i)[0]));
-				for (size_t i = 0; i < k * n; i++)
-					FFTer.FFT_DIF(&(b(i)[0]));
+				transform_DIF(FFTinv, a, m * k, pts);
+				transform_DIF(FFTer, b, k * n, pts);
 			}
 			FFT_PROFILING(1,"direct FFT_DIF");
 
-			// convert the matrix representation to matfirst (with double coefficient)
-			PMatrix vm_c (field(), m, n, pts);
-			PMatrix vm_a (field(), m, k, pts);
-			PMatrix vm_b (field(), k, n, pts);
+			// the evaluations as consecutive matrices, in buffers of the pool
+			typename MatrixP::Buffer vm_a (m*k*pts), vm_b (k*n*pts), vm_c (m*n*pts);
 			FFT_PROFILING(1,"creation of Matfirst");
-			vm_a.copy(a);
-			vm_b.copy(b);
+			a.getMatrices(vm_a.data(),0,pts-1);
+			b.getMatrices(vm_b.data(),0,pts-1);
 			FFT_PROFILING(1,"Polfirst to Matfirst");
 
 			// Pointwise multiplication
-			for (size_t i = 0; i < pts; ++i)
-				_BMD.mul(vm_c[i], vm_a[i], vm_b[i]);
+			pointwise_mul(pts, m, k, n, vm_c.data(), vm_a.data(), vm_b.data());
 			FFT_PROFILING(1,"pointwise mult");
 
-			// Transformation into matrix of polynomials (with int32_t coefficient)
-			c.copy(vm_c);
+			// Transformation into matrix of polynomials
+			c.setMatrices(vm_c.data(),0,pts-1);
 			FFT_PROFILING(1,"Matfirst to Polfirst");
 
 			// Inverse FFT on the output matrix
-			for (size_t i = 0; i < m * n; i++)
-				FFTer.FFT_DIT(&(c(i)[0]));
+			transform_DIT(FFTer, c, m * n, pts);
 			FFT_PROFILING(1,"inverse FFT_DIT");
 
 			// Divide by pts = 2^ltps
@@ -318,8 +452,227 @@ namespace LinBox {
 			FFLAS::fscalin(field(),c.rowdim()*c.coldim()*c.size(), inv_pts,  c.getWritePointer(),1);
 			FFT_PROFILING(1,"scaling the result");
 		}
+
+	private:
+		// number of threads worth using for nbr independent tasks over
+		// coeffs coefficients in total
+		size_t numThreads (size_t nbr, size_t coeffs) const {
+			if (coeffs < FFT_THREAD_THRESHOLD) return 1;
+			return std::max((size_t)1, std::min(_nthreads, nbr));
+		}
+
+		// In place (truncated to npts points) transforms of the nbr
+		// first polynomials of a. The rows are shared among the threads:
+		// the tables of FFT are only read and each thread has its own
+		// conversion buffer.
+		void transform_DIF (FFT_transform<Field> &FFT, MatrixP &a, size_t nbr, size_t npts) {
+			size_t pts = a.size();
+			size_t nt  = numThreads(nbr, nbr * npts);
+			if (nt == 1) {
+				for (size_t i = 0; i < nbr; i++)
+					FFT.TFT_DIF(&(a.ref(i,0)), npts);
+				return;
+			}
+#pragma omp parallel num_threads(nt)
+			{
+				typename FFT_transform<Field>::VECT data(pts);
+#pragma omp for schedule(static)
+				for (index_t i = 0; i < (index_t)nbr; i++)
+					FFT.TFT_DIF(&(a.ref((size_t)i,0)), npts, data);
+			}
+		}
+
+		void transform_DIT (FFT_transform<Field> &FFT, MatrixP &a, size_t nbr, size_t npts) {
+			size_t pts = a.size();
+			size_t nt  = numThreads(nbr, nbr * npts);
+			if (nt == 1) {
+				for (size_t i = 0; i < nbr; i++)
+					FFT.TFT_DIT(&(a.ref(i,0)), npts);
+				return;
+			}
+#pragma omp parallel num_threads(nt)
+			{
+				typename FFT_transform<Field>::VECT data(pts);
+#pragma omp for schedule(static)
+				for (index_t i = 0; i < (index_t)nbr; i++)
+					FFT.TFT_DIT(&(a.ref((size_t)i,0)), npts, data);
+			}
+		}
+
+		// Pointwise products c[i] = a[i] b[i]
+		void pointwise_mul (PMatrix &c, const PMatrix &a, const PMatrix &b) {
+			pointwise_mul(c.size(), a.rowdim(), a.coldim(), b.coldim(),
+				      [&](size_t i){return c[i].getWritePointer();},
+				      [&](size_t i){return a[i].getPointer();},
+				      [&](size_t i){return b[i].getPointer();});
+		}
+
+		// Pointwise products of the pts consecutive row major matrices
+		// of sizes m x k and k x n stored in A and B
+		void pointwise_mul (size_t pts, size_t m, size_t k, size_t n, Element *C, const Element *A, const Element *B) {
+			pointwise_mul(pts, m, k, n,
+				      [&](size_t i){return C+i*m*n;},
+				      [&](size_t i){return A+i*m*k;},
+				      [&](size_t i){return B+i*k*n;});
+		}
+
+		// The work is cut into blocks of consecutive points and, when
+		// there are fewer points than threads, each product is further
+		// cut into blocks of rows. ptrX(i) is the i-th matrix of X,
+		// stored without padding.
+		template<class PtrC, class PtrA, class PtrB>
+		void pointwise_mul (size_t pts, size_t m, size_t k, size_t n, PtrC ptrC, PtrA ptrA, PtrB ptrB) {
+			size_t nt  = numThreads(pts * m, pts * m * n * k);
+			size_t rb = (nt == 1 ? 1 : std::min(m, (nt + pts - 1) / pts)); // row blocks per point
+#pragma omp parallel for num_threads(nt) schedule(static) if(nt > 1)
+			for (index_t t = 0; t < (index_t)(pts * rb); ++t) {
+				size_t i  = (size_t)t / rb;
+				size_t r  = (size_t)t % rb;
+				size_t r0 = (r * m) / rb;
+				size_t r1 = ((r + 1) * m) / rb;
+				FFLAS::fgemm(field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
+					     r1 - r0, n, k, field().one,
+					     ptrA(i) + r0 * k, k,
+					     ptrB(i), n,
+					     field().zero,
+					     ptrC(i) + r0 * n, n);
+			}
+		}
 	}; // end of class special FFT mul domain
 
+	/***********************************************************************************
+	 **** Polynomial Matrix Multiplication over Zp[x] with p < 2^62 (FFTPrime)       ***
+	 ***********************************************************************************/
+	// Same as PolynomialMatrixFFTPrimeMulDomain with the 64-bit transforms: a
+	// single larger FFT prime instead of a multi-modular computation.
+	template<class Field>
+	class PolynomialMatrixFFTPrime64MulDomain {
+	public:
+		typedef PolynomialMatrix<PMType::polfirst,PMStorage::plain,Field> MatrixP;
+		typedef PolynomialMatrix<PMType::matfirst,PMStorage::plain,Field> PMatrix;
+		typedef typename Field::Element                                  Element;
+
+	private:
+		const Field              *_field;  // Read only
+		uint64_t                      _p;
+		BlasMatrixDomain<Field>     _BMD;
+		size_t                 _nthreads;
+
+	public:
+		inline const Field & field() const { return *_field; }
+
+		PolynomialMatrixFFTPrime64MulDomain(const Field &F, size_t nthreads=0)
+			: _field(&F), _p(field().cardinality()),  _BMD(F),
+			  _nthreads(nthreads?nthreads:matpolyFFTNumThreads()){}
+
+		size_t getNumThreads() const { return _nthreads; }
+		void setNumThreads(size_t nthreads) { _nthreads=(nthreads?nthreads:matpolyFFTNumThreads()); }
+
+		template<typename Matrix1, typename Matrix2, typename Matrix3>
+		void mul (Matrix1 &c, const Matrix2 &a, const Matrix3 &b, size_t max_rowdeg=0) {
+			linbox_check(a.coldim()==b.rowdim());
+			size_t deg  = (max_rowdeg?max_rowdeg:a.size()+b.size()-2);
+			size_t lpts = 0;
+			size_t pts  = 1; while (pts <= deg) { pts= pts<<1; ++lpts; }
+			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
+			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
+			MatrixP c2(field(),c.rowdim(),c.coldim(),pts);
+			a2.copy(a,0,a.size()-1);
+			b2.copy(b,0,b.size()-1);
+			mul_fft (lpts,c2, a2, b2);
+			c.copy(c2,0,deg);
+		}
+
+		// compute  c= (a*b x^(-n0-1)) mod x^n1
+		// by defaut: n0=c.size() and n1=2*c.size()-1;
+		// done from the full product (see foldMidproduct)
+		template<typename Matrix1, typename Matrix2, typename Matrix3>
+		void midproduct (Matrix1 &c, const Matrix2 &a, const Matrix3 &b,
+				 bool smallLeft=true, size_t n0=0,size_t n1=0) {
+			linbox_check(a.coldim()==b.rowdim());
+			size_t hdeg = (n0==0?c.size():n0);
+			size_t deg  = (n1==0?2*hdeg-1:n1);
+			linbox_check(c.size()>=deg-hdeg);
+			size_t pts  = 1; while (pts < deg) { pts= pts<<1; }
+
+			size_t psize = a.size()+b.size()-1;
+			size_t lppts = 0;
+			size_t ppts  = 1; while (ppts < psize) { ppts= ppts<<1; ++lppts; }
+			MatrixP a2(field(),a.rowdim(),a.coldim(),ppts);
+			MatrixP b2(field(),b.rowdim(),b.coldim(),ppts);
+			MatrixP p2(field(),c.rowdim(),c.coldim(),ppts);
+			a2.copy(a,0,a.size()-1);
+			b2.copy(b,0,b.size()-1);
+			mul_fft (lppts, p2, a2, b2);
+			MatrixP c2(field(),c.rowdim(),c.coldim(),c.size());
+			foldMidproduct(c2, p2, psize, hdeg, pts);
+			c.copy(c2,0,c.size()-1);
+		}
+
+		// a,b and c must have size: 2^lpts
+		void mul_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b) {
+			size_t m = a.rowdim();
+			size_t k = a.coldim();
+			size_t n = b.coldim();
+			size_t pts=c.size();
+			if ((_p-1) % pts != 0 || (_p >> 62) != 0) {
+				std::cout<<"Error the prime is not a FFTPrime or it has too small power of 2\n";
+				std::cout<<"prime="<<_p<<std::endl;
+				std::cout<<"nbr points="<<pts<<std::endl;
+				throw LinboxError("LinBox ERROR: bad FFT Prime\n");
+			}
+			FFT_transform64<Field> FFTer (field(), lpts, FFT_plan_cache64::get(_p, lpts));
+			FFT_transform64<Field> FFTinv (field(), lpts, FFT_plan_cache64::get(_p, lpts, true));
+
+			transform(FFTer, a, m * k, false);
+			transform(FFTer, b, k * n, false);
+
+			typename MatrixP::Buffer vm_a (m*k*pts), vm_b (k*n*pts), vm_c (m*n*pts);
+			a.getMatrices(vm_a.data(),0,pts-1);
+			b.getMatrices(vm_b.data(),0,pts-1);
+			size_t nt = numThreads(pts, pts * m * n * k);
+#pragma omp parallel for num_threads(nt) schedule(static) if(nt > 1)
+			for (index_t i = 0; i < (index_t)pts; ++i)
+				FFLAS::fgemm(field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
+					     m, n, k, field().one,
+					     vm_a.data()+(size_t)i*m*k, k,
+					     vm_b.data()+(size_t)i*k*n, n,
+					     field().zero,
+					     vm_c.data()+(size_t)i*m*n, n);
+			c.setMatrices(vm_c.data(),0,pts-1);
+
+			transform(FFTinv, c, m * n, true);
+
+			// Divide by pts = 2^lpts
+			typename Field::Element inv_pts;
+			field().init(inv_pts, pts);
+			field().invin(inv_pts);
+			FFLAS::fscalin(field(),c.rowdim()*c.coldim()*c.size(), inv_pts,  c.getWritePointer(),1);
+		}
+
+	private:
+		size_t numThreads (size_t nbr, size_t coeffs) const {
+			if (coeffs < FFT_THREAD_THRESHOLD) return 1;
+			return std::max((size_t)1, std::min(_nthreads, nbr));
+		}
+
+		// in place transforms of the nbr first polynomials of a
+		void transform (FFT_transform64<Field> &FFT, MatrixP &a, size_t nbr, bool inverse) {
+			size_t pts = a.size();
+			size_t nt  = numThreads(nbr, nbr * pts);
+#pragma omp parallel num_threads(nt) if (nt > 1)
+			{
+				typename FFT_transform64<Field>::VECT data(pts);
+#pragma omp for schedule(static)
+				for (index_t i = 0; i < (index_t)nbr; i++)
+					if (inverse)
+						FFT.FFT_DIT(&(a.ref((size_t)i,0)), data);
+					else
+						FFT.FFT_DIF(&(a.ref((size_t)i,0)), data);
+			}
+		}
+	}; // end of class FFT mul domain with 64-bit primes
+
 
 
 }//end of namespace LinBox
@@ -52,12 +52,14 @@ namespace LinBox {
 	private:
 		const Field              *_field;  // Read only
 		uint64_t                      _p;
+		size_t                 _nthreads;
 	  
 	public:
 		inline const Field & field() const { return *_field; }
 	  
-		PolynomialMatrixThreePrimesFFTMulDomain(const Field &F)
-			: _field(&F), _p(field().cardinality())
+		// nthreads: number of threads of each FFT prime product (0 means all the available threads)
+		PolynomialMatrixThreePrimesFFTMulDomain(const Field &F, size_t nthreads=0)
+			: _field(&F), _p(field().cardinality()), _nthreads(nthreads)
 		{
 			if (integer(_p).bitsize()>29) {
 				std::cout<<"MatPoly MUL FFT 3-primes: error initial prime has more than 29 bits exiting.."<<std::endl;
@@ -81,7 +83,7 @@ namespace LinBox {
 			MatrixP c2(field(),c.rowdim(),c.coldim(),pts);
 			integer bound=integer(_p-1)*integer(_p-1)
 				*integer((uint64_t)a.coldim())*integer((uint64_t)std::min(a.size(),b.size()));
-			mul_fft (lpts,c2, a2, b2, bound);
+			mul_fft (lpts,c2, a2, b2, bound, deg+1);
 			c.copy(c2,0,deg);
 		}
 
@@ -101,16 +103,17 @@ namespace LinBox {
 			integer bound=integer(_p-1)*integer(_p-1)
 				*integer((uint64_t)a.coldim())*integer((uint64_t)std::min(a.size(),b.size()));
 
-			mul_fft (lpts,c, a2, b2, bound);
+			mul_fft (lpts,c, a2, b2, bound, deg+1);
 			c.resize(deg+1);
 		}
 		
 		// a,b and c must have size: 2^lpts
-		void mul_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b, const integer& bound) {
+		// -> only npts evaluation points are used (0 means 2^lpts)
+		void mul_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b, const integer& bound, size_t npts=0) {
 			size_t pts=c.size();			
 			if ((_p-1) % pts == 0){
-				PolynomialMatrixFFTPrimeMulDomain<ModField> fftprime_domain (field());
-				fftprime_domain.mul_fft(lpts,c,a,b);
+				PolynomialMatrixFFTPrimeMulDomain<ModField> fftprime_domain (field(),_nthreads);
+				fftprime_domain.mul_fft(lpts,c,a,b,npts);
                 		return;
 			}			
 			//std::cout<<"a:="<<a<<std::endl;
@@ -138,7 +141,7 @@ namespace LinBox {
 				f[l]=ModField(basis[l]);
 	    
 			for (size_t l=0;l<num_primes;l++){
-				PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f[l]);
+				PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f[l],_nthreads);
 				MatrixP ai(f[l],m,k,pts);
 				MatrixP bi(f[l],k,n,pts);
 				if (basis[l]> _p) {
@@ -154,7 +157,7 @@ namespace LinBox {
 				
 				}
 				c_i[l] = new MatrixP(f[l], m, n, pts);
- 				fftdomain.mul_fft(lpts, *c_i[l], ai, bi);				
+ 				fftdomain.mul_fft(lpts, *c_i[l], ai, bi, npts);				
 				//std::cout<<"pi:="<<(uint64_t)basis[l]<<std::endl;
 				//std::cout<<"ci:="<<*c_i[l]<<std::endl;
 			}
@@ -210,6 +213,27 @@ namespace LinBox {
 
 			size_t lpts = 0;
 			size_t pts  = 1; while (pts < deg) { pts= pts<<1; ++lpts; }
+			integer bound=integer(_p-1)*integer(_p-1)
+				*integer((uint64_t)a.coldim())*integer((uint64_t)std::min(a.size(),b.size()));
+
+			size_t psize = a.size()+b.size()-1;
+			if (psize < pts) {
+				// the full product needs fewer evaluation points than
+				// the cyclic middle product: compute it with the TFT
+				size_t lppts = 0;
+				size_t ppts  = 1; while (ppts < psize) { ppts= ppts<<1; ++lppts; }
+				MatrixP a2(field(),a.rowdim(),a.coldim(),ppts);
+				MatrixP b2(field(),b.rowdim(),b.coldim(),ppts);
+				MatrixP p2(field(),c.rowdim(),c.coldim(),ppts);
+				a2.copy(a,0,a.size()-1);
+				b2.copy(b,0,b.size()-1);
+				mul_fft (lppts, p2, a2, b2, bound, psize);
+				MatrixP c2(field(),c.rowdim(),c.coldim(),c.size());
+				foldMidproduct(c2, p2, psize, hdeg, pts);
+				c.copy(c2,0,c.size()-1);
+				return;
+			}
+
 			// padd the input a and b to 2^lpts (use MatrixP representation)
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
 			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
@@ -226,8 +250,6 @@ namespace LinBox {
 				for (size_t j=0;j<b2.rowdim()*b2.coldim();j++)
 					for (size_t i=0;i<hdeg/2;i++)
 						std::swap(b2.ref(j,i),b2.ref(j,hdeg-1-i));
-			integer bound=integer(_p-1)*integer(_p-1)
-				*integer((uint64_t)a.coldim())*integer((uint64_t)std::min(a.size(),b.size()));
 			
 			midproduct_fft (lpts,c2, a2, b2, bound, smallLeft);
 			c.copy(c2,0,c.size()-1);
@@ -241,7 +263,7 @@ namespace LinBox {
 			size_t pts=c.size();			
 			if ((_p-1) % pts == 0){
 				//std::cerr<<"3-prime FFT midp switching to FFTPrime  "<<std::endl;
-				PolynomialMatrixFFTPrimeMulDomain<ModField> fftprime_domain (field());
+				PolynomialMatrixFFTPrimeMulDomain<ModField> fftprime_domain (field(),_nthreads);
 				fftprime_domain.midproduct_fft(lpts,c,a,b,smallLeft);
 				return;
 			}
@@ -280,7 +302,7 @@ namespace LinBox {
 	    
 			for (size_t l=0;l<num_primes;l++){
 				//std::cerr<<"3-prime FFT midp over "; f[l].write(std::cerr)<<std::endl;
-				PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f[l]);
+				PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f[l],_nthreads);
 				MatrixP ai(f[l],m,k,pts);
 				MatrixP bi(f[l],k,n,pts);
 				if (basis[l]> _p) {
@@ -49,10 +49,16 @@ namespace LinBox {
         private:
                 const Field            *_field;  // Read only
                 uint64_t                    _p;
+                size_t               _nthreads;
         public:
                 inline const Field & field() const { return *_field; }
 
-                PolynomialMatrixFFTMulDomain (const Field& F) : _field(&F), _p(F.cardinality()) {}
+                // nthreads: number of threads of the products (0 means all the available threads)
+                PolynomialMatrixFFTMulDomain (const Field& F, size_t nthreads=0)
+                        : _field(&F), _p(F.cardinality()), _nthreads(nthreads) {}
+
+                size_t getNumThreads() const { return _nthreads; }
+                void setNumThreads(size_t nthreads) { _nthreads=nthreads; }
 
                 template<typename Matrix1, typename Matrix2, typename Matrix3>
                 void mul (Matrix1 &c, const Matrix2 &a, const Matrix3 &b, size_t max_rowdeg=0) {
@@ -62,12 +68,17 @@ namespace LinBox {
 			size_t lpts = 0;
 			size_t pts  = 1; while (pts <= deg) { pts= pts<<1; ++lpts; }
                         if ( _p< 536870912ULL  &&  ((_p-1) % pts)==0){				
-				PolynomialMatrixFFTPrimeMulDomain<Field> MulDom(field());
+				PolynomialMatrixFFTPrimeMulDomain<Field> MulDom(field(),_nthreads);
 				MulDom.mul(c,a,b, max_rowdeg);
                         }
+			else if ( _p< 4611686018427387904ULL  &&  ((_p-1) % pts)==0){
+				// one 64-bit FFT prime instead of the multi-modular computation
+				PolynomialMatrixFFTPrime64MulDomain<Field> MulDom(field(),_nthreads);
+				MulDom.mul(c,a,b, max_rowdeg);
+			}
                         else {
 				if (_p< 536870912ULL){
-					PolynomialMatrixThreePrimesFFTMulDomain<Field> MulDom(field());
+					PolynomialMatrixThreePrimesFFTMulDomain<Field> MulDom(field(),_nthreads);
 					MulDom.mul(c,a,b, max_rowdeg);
 				}
 				else {
@@ -75,7 +86,7 @@ namespace LinBox {
 					// -> could be optimized in some cases (e.g. output entries less than 2^64)
 					FFT_PROFILE_START(2);
 					LargeField Fp(_p);
-					PolynomialMatrixFFTMulDomain<LargeField> MulDom(Fp);
+					PolynomialMatrixFFTMulDomain<LargeField> MulDom(Fp,_nthreads);
 					MatrixP_L a2(Fp,a.rowdim(),a.coldim(),a.size());
 					MatrixP_L b2(Fp,b.rowdim(),b.coldim(),b.size());
 					MatrixP_L c2(Fp,c.rowdim(),c.coldim(),c.size());
@@ -95,12 +106,16 @@ namespace LinBox {
                         uint64_t pts= 1<<(integer((uint64_t)a.size()+b.size()-1).bitsize());
                         if (_p< 536870912ULL  &&  ((_p-1) % pts)==0){
 				//std::cout<<"MIDP: Staying with FFT Prime Field"<<std::endl;
-                                PolynomialMatrixFFTPrimeMulDomain<Field> MulDom(field());
+                                PolynomialMatrixFFTPrimeMulDomain<Field> MulDom(field(),_nthreads);
                                 MulDom.midproduct(c,a,b,smallLeft,n0,n1);
                         }
+			else if (_p< 4611686018427387904ULL  &&  ((_p-1) % pts)==0){
+				PolynomialMatrixFFTPrime64MulDomain<Field> MulDom(field(),_nthreads);
+				MulDom.midproduct(c,a,b,smallLeft,n0,n1);
+			}
 			else {
 				if (_p< 536870912ULL){
-					PolynomialMatrixThreePrimesFFTMulDomain<Field> MulDom(field());
+					PolynomialMatrixThreePrimesFFTMulDomain<Field> MulDom(field(),_nthreads);
 					MulDom.midproduct(c,a,b,smallLeft,n0,n1);
 				}
 				else {  // use computation with Givaro::Modular<integer>
@@ -108,7 +123,7 @@ namespace LinBox {
 					FFT_PROFILE_START(2);
 					//std::cout<<"MIDP: Switching to Large Field"<<std::endl;
 					LargeField Fp(_p);
-					PolynomialMatrixFFTMulDomain<LargeField> MulDom(Fp);
+					PolynomialMatrixFFTMulDomain<LargeField> MulDom(Fp,_nthreads);
 					MatrixP_L a2(Fp,a.rowdim(),a.coldim(),a.size());
 					MatrixP_L b2(Fp,b.rowdim(),b.coldim(),b.size());
 					MatrixP_L c2(Fp,c.rowdim(),c.coldim(),c.size());
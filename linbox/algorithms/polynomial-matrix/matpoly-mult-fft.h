@@ -38,6 +38,7 @@
 #include <givaro/zring.h>
 #include "linbox/ring/modular.h"
 #include "givaro/givtimer.h"
+#include "linbox/util/perf-counters.h"
 #include <sstream>
 
 #ifdef FFT_PROFILER
@@ -71,8 +72,9 @@ Givaro::Timer mychrono[3];
     std::cout.precision(6);std::cout<<x<<" s"<<std::endl;		\
   }
 #else
-#define FFT_PROFILE_START(lvl)
-#define FFT_PROFILING(lvl,msg)
+// the phases go to the timers of PerfCounters (nothing without LINBOX_PERF_COUNTERS)
+#define FFT_PROFILE_START(lvl) LINBOX_PERF_LAP_START(lvl)
+#define FFT_PROFILING(lvl,msg) LINBOX_PERF_LAP(lvl,"FFT: " msg)
 #define FFT_PROFILE_GET(lv,x)
 #define FFT_PROFILE(lvl,msg,x)
 #endif // FFT_PROFILER
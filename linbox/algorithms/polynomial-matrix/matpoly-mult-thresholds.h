@@ -0,0 +1,187 @@
+/* -*- mode: C++; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+#ifndef __LINBOX_matpoly_mult_thresholds_H
+#define __LINBOX_matpoly_mult_thresholds_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
+#include "linbox/integer.h"
+
+// file read at the first use of the table (the environment variable wins)
+#ifndef MATPOLY_TUNING_FILE
+#define MATPOLY_TUNING_FILE ""
+#endif
+
+namespace LinBox
+{
+	/* Crossover sizes of the polynomial matrix products, as measured on
+	 * the target machine by benchmarks/tune-matpoly-mult.
+	 *
+	 * The table is a text file with one line per range:
+	 *
+	 *      domain  tag  bits  dim  kara  fft
+	 *
+	 * domain: "matpoly" (PolynomialMatrixMulDomain) or "sigma" (the
+	 * PolynomialMatrixDomain of sigma-basis.h), tag: the element type of
+	 * the field (see fieldTag), bits: the line applies to characteristics
+	 * of at most bits bits, dim: to operands whose largest dimension is
+	 * at most dim, kara/fft: Karatsuba (resp. the FFT) is used when the
+	 * size of the operands (as computed by the domain) is larger.
+	 * Lines starting with '#' are ignored.
+	 *
+	 * It is read from $LINBOX_MATPOLY_TUNING or MATPOLY_TUNING_FILE at
+	 * the first use, and can be changed with load()/set() before the
+	 * domains are created (a domain reads the table once).
+	 */
+	class MatpolyMulThresholds {
+	public:
+		struct Entry {
+			std::string domain;
+			std::string tag;
+			size_t      bits;
+			size_t      dim;
+			size_t      kara;
+			size_t      fft;
+		};
+
+		static std::vector<Entry>& table() {
+			static std::vector<Entry> T(initial());
+			return T;
+		}
+
+		static void set(const std::vector<Entry>& T) { table()=T; }
+
+		// replace the table by the content of file, false if it can not be read
+		static bool load(const std::string& file) {
+			std::vector<Entry> T;
+			if (!read(file,T)) return false;
+			table()=T;
+			return true;
+		}
+
+		static bool save(const std::string& file) {
+			std::ofstream out(file.c_str());
+			if (!out) return false;
+			out<<"# domain tag bits dim kara fft\n";
+			const std::vector<Entry>& T=table();
+			for (size_t i=0;i<T.size();i++)
+				out<<T[i].domain<<" "<<T[i].tag<<" "<<T[i].bits<<" "<<T[i].dim<<" "<<T[i].kara<<" "<<T[i].fft<<"\n";
+			return (bool)out;
+		}
+
+		// e.g. "f64" for Modular<double>, "i64" for Modular<int64_t>, "z0" for multiprecision
+		template<class Field>
+		static std::string fieldTag(const Field&) {
+			typedef typename Field::Element Element;
+			std::string t(std::is_floating_point<Element>::value ? "f" : (std::is_integral<Element>::value ? "i" : "z"));
+			return t+std::to_string(std::is_arithmetic<Element>::value ? 8*sizeof(Element) : 0);
+		}
+
+		template<class Field>
+		static size_t fieldBits(const Field& F) {
+			integer p;
+			F.characteristic(p);
+			return p.bitsize();
+		}
+
+	private:
+		static std::vector<Entry> initial() {
+			std::vector<Entry> T;
+			const char* env=std::getenv("LINBOX_MATPOLY_TUNING");
+			std::string file(env ? env : MATPOLY_TUNING_FILE);
+			if (!file.empty()) read(file,T);
+			return T;
+		}
+
+		static bool read(const std::string& file, std::vector<Entry>& T) {
+			std::ifstream in(file.c_str());
+			if (!in) return false;
+			std::string line;
+			while (std::getline(in,line)) {
+				if (line.empty() || line[0]=='#') continue;
+				std::istringstream is(line);
+				Entry e;
+				if (is>>e.domain>>e.tag>>e.bits>>e.dim>>e.kara>>e.fft)
+					T.push_back(e);
+			}
+			return true;
+		}
+	};
+
+	/* Thresholds used by a domain over a given field: the lines of the
+	 * table for this domain and field are selected once, the lookup by
+	 * dimension is a short scan. Without any line the default thresholds
+	 * (the compile time constants of the domain) are used.
+	 */
+	class MatpolyMulDispatch {
+	public:
+		template<class Field>
+		MatpolyMulDispatch(const std::string& domain, const Field& F, size_t kara, size_t fft)
+			: _kara(kara), _fft(fft) {
+			const std::vector<MatpolyMulThresholds::Entry>& T=MatpolyMulThresholds::table();
+			std::string tag=MatpolyMulThresholds::fieldTag(F);
+			size_t bits=MatpolyMulThresholds::fieldBits(F), best=0;
+			// the smallest bit range containing the field
+			for (size_t i=0;i<T.size();i++)
+				if (T[i].domain==domain && T[i].tag==tag && T[i].bits>=bits && (best==0 || T[i].bits<best))
+					best=T[i].bits;
+			for (size_t i=0;i<T.size();i++)
+				if (T[i].domain==domain && T[i].tag==tag && T[i].bits==best)
+					_rows.push_back(T[i]);
+			std::sort(_rows.begin(),_rows.end(),
+				  [](const MatpolyMulThresholds::Entry& a, const MatpolyMulThresholds::Entry& b){return a.dim<b.dim;});
+		}
+
+		// the operands are in Karatsuba (resp. FFT) range when their size is > karatsuba(dim) (resp. fft(dim))
+		size_t karatsuba(size_t dim) const { return _rows.empty() ? _kara : row(dim).kara; }
+		size_t fft(size_t dim) const { return _rows.empty() ? _fft : row(dim).fft; }
+
+	private:
+		// the first range containing dim, the largest one if dim is larger
+		const MatpolyMulThresholds::Entry& row(size_t dim) const {
+			size_t i=0;
+			while (i+1<_rows.size() && _rows[i].dim<dim) i++;
+			return _rows[i];
+		}
+
+		std::vector<MatpolyMulThresholds::Entry> _rows;
+		size_t                                   _kara;
+		size_t                                    _fft;
+	};
+
+} // end of namespace LinBox
+
+#endif // __LINBOX_matpoly_mult_thresholds_H
+
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,:0,t0,+0,=s
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
@@ -43,6 +43,10 @@
 #include "fflas-ffpack/fflas-ffpack.h"
 #define MBASIS_THRESHOLD_LOG 5
 #define MBASIS_THRESHOLD (1<<MBASIS_THRESHOLD_LOG)
+// default bound on the chunk length of OrderBasisStream
+#ifndef ORDERBASIS_STREAM_MAXCHUNK
+#define ORDERBASIS_STREAM_MAXCHUNK (8*MBASIS_THRESHOLD)
+#endif
 
 
 
@@ -182,6 +186,7 @@ namespace LinBox {
                 PolynomialMatrixMulDomain<Field>   _PMD;
                 BlasMatrixDomain<Field>            _BMD;
                 ET                           _EarlyStop;
+                size_t                         _reached; // orders processed by M_Basis
         public:
 #if  defined(PROFILE_PMBASIS) or defined(__CHECK_MBASIS) or defined(__CHECK_PMBASIS)
                 size_t _idx=0;
@@ -190,11 +195,20 @@ namespace LinBox {
                 std::chrono::time_point<std::chrono::system_clock> _start, _end;
                 bool _started=false;
 #endif
-                OrderBasis(const Field& f) : _field(&f), _PMD(f), _BMD(f) {                 
+                OrderBasis(const Field& f) : _field(&f), _PMD(f), _BMD(f), _reached(0) {                 
                 }
 
                 inline const Field& field() const {return *_field;}
 
+                // state of the early termination, kept between successive calls
+                bool earlyTerminated() const {return _EarlyStop.terminated();}
+                void resetEarlyTerm() {_EarlyStop.reset(); _reached=0;}
+
+                // number of orders processed by M_Basis since resetEarlyTerm():
+                // after an early termination, the sum over the calls of PM_Basis
+                // of the order really reached by their basis
+                size_t reachedOrder() const {return _reached;}
+
                 // serie must have exactly order elements (i.e. its degree = order-1)
                 // sigma can have at most order+1 elements (i.e. its degree = order)
                 template<typename PMatrix1, typename PMatrix2>
@@ -566,6 +580,7 @@ namespace LinBox {
                                 _EarlyStop.update(m-rank,shift); // codimension (m-rank) seems better
                         }
                         
+                        _reached += k;
                         if (_EarlyStop.terminated()) { 
                                 std::cout<<"OrderBasis: Early Termination at :"<<k<<"/"<<order<<std::endl;
                         }
@@ -848,6 +863,149 @@ namespace LinBox {
 
         };
 
+        /* Streaming PM-Basis.
+         *
+         * The coefficients of the serie are given one at a time, as they are
+         * produced (e.g. by a BlackboxBlockContainer), and only the ones still
+         * needed for the next serie update are kept in memory. The order is
+         * increased by chunks: once the chunk F[k..k+L-1] is available the
+         * residual x^-k (sigma.F) mod x^L is obtained by a middle product with
+         * F[k-deg(sigma)..k+L-1], its order basis is computed with PM_Basis and
+         * multiplied to sigma. The coefficients below k+L-deg(sigma) are then
+         * discarded.
+         *
+         * The chunk length doubles with the order (as the top level of
+         * PM_Basis) up to maxchunk (ORDERBASIS_STREAM_MAXCHUNK by default), so
+         * that the memory used by the serie is at most deg(sigma)+maxchunk
+         * coefficients. maxchunk=0 removes the bound: the last chunks are then
+         * half of the order long.
+         *
+         * After an early termination, order() is the order really reached by
+         * sigma, which may be below the end of the last chunk.
+         *
+         * push() computes the update of a completed chunk before returning: the
+         * coefficients are consumed synchronously. Overlapping their generation
+         * with the order basis computation (e.g. producing the next chunk in
+         * another thread) is left to the caller.
+         */
+        template<class Field, class ET=EarlyTerm<(size_t) -1> >
+        class OrderBasisStream {
+        public:
+                typedef PolynomialMatrix<PMType::matfirst,PMStorage::plain,Field> PMatrix;
+                typedef typename PMatrix::Matrix                                  Matrix;
+        private:
+                const Field*                     _field;
+                OrderBasis<Field,ET>                _SB;
+                PolynomialMatrixMulDomain<Field>   _PMD;
+                std::vector<size_t>              _shift;
+                size_t                          _m, _k;
+                size_t                           _order;
+                size_t                        _maxchunk;
+                PMatrix                          _sigma;
+                size_t                             _deg; // degree of _sigma
+                size_t                            _done; // order reached by _sigma
+                PMatrix                         _window; // F[_offset.._offset+_fill-1]
+                size_t                          _offset;
+                size_t                            _fill;
+                bool                              _stop;
+
+                // length of the next chunk
+                size_t chunk() const {
+                        size_t L = std::max((size_t)MBASIS_THRESHOLD, _done);
+                        if (_maxchunk) L = std::min(L, _maxchunk);
+                        return std::min(L, _order-_done);
+                }
+
+                // increase the order of sigma by L using F[_offset.._done+L-1]
+                void update(size_t L){
+                        size_t s = _done-_offset; // position of F[_done] in the window
+                        linbox_check(_fill == s+L);
+                        _window.resize(_fill);
+
+                        PMatrix serie(field(),_m,_k,L);
+                        _PMD.midproductgen(serie, _sigma, _window, true, s+1, s+L);
+
+                        PMatrix sigma2(field(),_m,_m,L+1);
+                        size_t r0 = _SB.reachedOrder();
+                        size_t d2 = _SB.PM_Basis(sigma2, serie, L, _shift);
+                        PMatrix sigma1(field(),_m,_m,_deg+d2+1);
+                        _PMD.mul(sigma1, sigma2, _sigma);
+                        _deg += d2;
+                        _sigma.resize(_deg+1);
+                        _sigma.copy(sigma1,0,_deg);
+                        _stop  = _SB.earlyTerminated();
+                        // sigma2 may stop before L on early termination
+                        _done += (_stop ? std::min(L, _SB.reachedOrder()-r0) : L);
+
+                        // discard the coefficients which are no more needed
+                        size_t offset = _done-std::min(_done,_deg);
+                        size_t t      = offset-_offset;
+                        for (size_t i=0;i+t<_fill;i++)
+                                _window[i]=_window[i+t];
+                        _fill  -= t;
+                        _offset = offset;
+                        _window.resize(_fill);
+                }
+
+        public:
+                // m x k is the dimension of the serie, sigma is m x m
+                OrderBasisStream(const Field& F, size_t m, size_t k, size_t order,
+                                 const std::vector<size_t>& shift, size_t maxchunk=ORDERBASIS_STREAM_MAXCHUNK)
+                        : _field(&F), _SB(F), _PMD(F), _shift(shift), _m(m), _k(k), _order(order), _maxchunk(maxchunk),
+                          _sigma(F,m,m,1), _deg(0), _done(0), _window(F,m,k,0), _offset(0), _fill(0), _stop(false)
+                {
+                        linbox_check(shift.size()==m);
+                        for (size_t i=0;i<m;i++)
+                                field().assign(_sigma.ref(i,i,0),field().one);
+                        _SB.resetEarlyTerm();
+                }
+
+                inline const Field& field() const {return *_field;}
+
+                // give the next coefficient of the serie, return false
+                // when no more coefficients are needed
+                bool push(const Matrix& Fi){
+                        if (terminated()) return false;
+                        linbox_check(Fi.rowdim()==_m && Fi.coldim()==_k);
+                        if (_fill==_window.size())
+                                _window.resize(_done+chunk()-_offset);
+                        _window[_fill++]=Fi;
+                        if (_offset+_fill==_done+chunk())
+                                update(chunk());
+                        return !terminated();
+                }
+
+                // read the serie from a sequence iterator (*it gives the current
+                // coefficient, ++it launches the next one)
+                template<class Iterator>
+                size_t consume(Iterator& it, size_t len){
+                        size_t i=0;
+                        while (i<len && !terminated()){
+                                push(*it);
+                                if (++i<len && !terminated()) ++it;
+                        }
+                        return i;
+                }
+
+                // use the coefficients given so far even if the chunk is not complete
+                void flush(){
+                        if (!terminated() && _offset+_fill>_done)
+                                update(_offset+_fill-_done);
+                }
+
+                bool terminated() const {return _stop || _done>=_order;}
+
+                // order basis of the serie up to order()
+                const PMatrix& sigma() const {return _sigma;}
+                size_t degree() const {return _deg;}
+                // order reached by sigma (exact after an early termination)
+                size_t order() const {return _done;}
+                const std::vector<size_t>& shift() const {return _shift;}
+
+                // number of serie coefficients currently stored
+                size_t stored() const {return _fill;}
+        };
+
         
         typedef Givaro::Modular<RecInt::ruint128,RecInt::ruint256>   MYRECINT;
         template<>
@@ -870,6 +1028,7 @@ namespace LinBox {
                 //std::cout<<"Serie1: "<<serie1<<std::endl;
 
                 size_t d= SB.M_Basis(sigma1,serie1,order,shift);
+                _reached += SB.reachedOrder();
                 sigma.copy(sigma1,0,d);
                 
                 //std::cout<<"Sigma1: "<<sigma1<<std::endl;
@@ -0,0 +1,308 @@
+/* -*- mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+// vim:sts=4:sw=4:ts=4:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
+/*
+ * Copyright (C) 2014  Pascal Giorgi, Romain Lebreton
+ *
+ * Written by Pascal Giorgi <pascal.giorgi@lirmm.fr>
+ *            Romain Lebreton <romain.lebreton@lirmm.fr>
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+
+#ifndef __LINBOX_polynomial_fft_transform_64_H
+#define __LINBOX_polynomial_fft_transform_64_H
+
+#include "linbox/algorithms/polynomial-matrix/polynomial-fft-transform.h"
+#include "linbox/vector/vector-simd.h"
+
+// The IFMA kernels are compiled with target attributes whatever the
+// compilation flags, as the VectorSIMD ones, and chosen at run time.
+#ifdef __LINBOX_VECTOR_SIMD_X86
+#define __LINBOX_FFT64_IFMA
+#define __LINBOX_TARGET_IFMA __attribute__((target("avx512f,avx512ifma")))
+#endif
+
+namespace LinBox {
+
+	// true if the processor has AVX-512 IFMA and LINBOX_SIMD does not lower
+	// the choice below avx512
+	inline bool cpuSupportsIFMA () {
+#ifdef __LINBOX_FFT64_IFMA
+		static const bool ifma = (VectorSIMD::level() == VectorSIMD::AVX512) && __builtin_cpu_supports("avx512ifma");
+		return ifma;
+#else
+		return false;
+#endif
+	}
+
+	// high 64 bits of the product a.b
+	inline uint64_t mulhi64 (uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+		return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+		// schoolbook product on 32-bit halves
+		uint64_t a0 = a & 0xFFFFFFFF, a1 = a >> 32;
+		uint64_t b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+		uint64_t t  = a1 * b0 + ((a0 * b0) >> 32);
+		uint64_t u  = a0 * b1 + (t & 0xFFFFFFFF);
+		return a1 * b1 + (t >> 32) + (u >> 32);
+#endif
+	}
+
+	// a.b mod p, p < 2^63
+	inline uint64_t mulmod64 (uint64_t a, uint64_t b, uint64_t p) {
+#ifdef __SIZEOF_INT128__
+		return (uint64_t)(((unsigned __int128)a * b) % p);
+#else
+		uint64_t r = 0;
+		a %= p;
+		for (; b != 0; b >>= 1) {
+			if (b & 1) { r += a; if (r >= p) r -= p; }
+			a <<= 1; if (a >= p) a -= p;
+		}
+		return r;
+#endif
+	}
+
+	inline uint64_t powmod64 (uint64_t a, uint64_t e, uint64_t p) {
+		uint64_t r = 1;
+		for (; e != 0; e >>= 1) {
+			if (e & 1) r = mulmod64 (r, a, p);
+			a = mulmod64 (a, a, p);
+		}
+		return r;
+	}
+
+	// Shoup's precomputation floor(a.2^64/p) for a < p < 2^63
+	inline uint64_t shoup64 (uint64_t a, uint64_t p) {
+#ifdef __SIZEOF_INT128__
+		return (uint64_t)(((unsigned __int128)a << 64) / p);
+#else
+		uint64_t q = 0;
+		for (size_t i = 0; i < 64; i++) {
+			a <<= 1; q <<= 1;
+			if (a >= p) { a -= p; q |= 1; }
+		}
+		return q;
+#endif
+	}
+
+	/*
+	 * Twiddle tables of a transform of size K = 2^ln over Fp with p < 2^62,
+	 * same layout as FFT_tables, with 64-bit Shoup's precomputations
+	 * floor(pow_w * 2^64 / p). When p < 2^50 and the processor has
+	 * AVX-512 IFMA, pow_wq holds the 52-bit ones floor(pow_w * 2^52 / p).
+	 */
+	struct FFT_tables64 {
+		typedef std::vector<uint64_t,AlignedAllocator<uint64_t, Alignment::DEFAULT> > VECT;
+
+		uint64_t                      p;
+		uint64_t                     ln;
+		uint64_t                      w;
+		uint64_t                   invw;
+		VECT                      pow_w;
+		VECT                     pow_wp;
+		VECT                     pow_wq;
+
+		FFT_tables64 (uint64_t p2, uint64_t ln2, uint64_t w2)
+			: p (p2), ln (ln2), w (w2), pow_w ((1UL << ln2) - 1), pow_wp ((1UL << ln2) - 1) {
+			linbox_check((p >> 62) == 0 ); // 4*p < 2^64 for Harvey's butterflies
+
+			// compute w^(-1) mod p = w^(2^lpts - 1)
+			invw = powmod64 (w, ((uint64_t)1<<ln) - 1, p);
+
+			if (ln == 0) return;
+			size_t tpts = (size_t)1 << (ln - 1);
+			size_t pos  = 0;
+			uint64_t wi = 1;
+			for (; pos < tpts; pos++) {
+				pow_w[pos]  = wi;
+				pow_wp[pos] = shoup64 (wi, p);
+				wi = mulmod64 (wi, w, p);
+			}
+			// Other pow_w elements can be read from previously computed pow_w
+			for (size_t k = 2; k <= tpts; k <<= 1)
+				for (size_t i = 0; i < tpts; i += k, pos++) {
+					pow_w[pos]  = pow_w[i];
+					pow_wp[pos] = pow_wp[i];
+				}
+#ifdef __LINBOX_FFT64_IFMA
+			if ((p >> 50) == 0 && cpuSupportsIFMA()) {
+				pow_wq.resize (pow_wp.size());
+				for (size_t i = 0; i < pow_wp.size(); i++)
+					pow_wq[i] = pow_wp[i] >> 12;
+			}
+#endif
+		}
+
+		// a primitive 2^ln-th root of unity modulo p
+		static uint64_t findRoot (uint64_t p, uint64_t ln) {
+			uint64_t _val2p = 0;
+			uint64_t     _m = p - 1;
+			while ((_m & 1) == 0) {
+				_m >>= 1;
+				_val2p++;
+			}
+			linbox_check(ln <= _val2p);
+			// g^m has order 2^val2p iff (g^m)^(2^(val2p-1)) != 1
+			for (uint64_t g = 2; ; g++) {
+				uint64_t z = powmod64 (g, _m, p);
+				if (powmod64 (z, (uint64_t)1 << (_val2p - 1), p) != 1)
+					return powmod64 (z, (uint64_t)1 << (_val2p - ln), p);
+			}
+		}
+	};
+
+	typedef FFT_plan_cache_t<FFT_tables64> FFT_plan_cache64;
+
+	/*
+	 * FFT transform over prime fields Fp with p < 2^62, on 64-bit words,
+	 * with Harvey's lazy butterflies and Shoup's multiplication (the high
+	 * part of the 64x64 bits products is emulated when there is no 128-bit
+	 * integer type). The AVX-512 IFMA kernels are used for p < 2^50 when
+	 * the processor has them (cpuSupportsIFMA), the choice is made at run
+	 * time from the modulus and the processor.
+	 */
+	template <class Field>
+	class FFT_transform64 {
+	public:
+		typedef typename Field::Element Element;
+		typedef FFT_tables64::VECT         VECT;
+
+		const Field                *fld;
+		uint64_t              _pl, _dpl;
+		uint64_t                      n;
+		uint64_t                     ln;
+		uint64_t                     _w;
+		uint64_t                  _invw;
+		std::shared_ptr<const FFT_tables64> _tables;
+		const uint64_t           *pow_w;
+		const uint64_t          *pow_wp;
+		const uint64_t          *pow_wq;  // 52-bit precomputations (IFMA)
+		bool                      _ifma;
+		VECT                      _data;
+
+		inline const Field & field() const { return *fld; }
+
+		// transform with its own tables, for the root w (a primitive 2^ln2-th root if w = 0)
+		FFT_transform64 (const Field& fld2, size_t ln2, uint64_t w = 0)
+			: fld (&fld2), n ((1UL << ln2)), ln (ln2), _data(n) {
+			init ();
+			setTables (std::make_shared<const FFT_tables64> (_pl, ln, w ? w : FFT_tables64::findRoot (_pl, ln)));
+		}
+
+		// transform sharing the given tables, e.g. FFT_plan_cache64::get (p, ln2)
+		FFT_transform64 (const Field& fld2, size_t ln2, std::shared_ptr<const FFT_tables64> T)
+			: fld (&fld2), n ((1UL << ln2)), ln (ln2), _data(n) {
+			init ();
+			linbox_check(T->p == _pl && T->ln == ln);
+			setTables (T);
+		}
+
+		uint64_t getRoot() const {return _w;}
+		uint64_t getInvRoot() const {return _invw;}
+
+		// in place transforms, input and output reduced modulo p
+		void FFT_DIF (uint64_t *fft) {
+#ifdef __LINBOX_FFT64_IFMA
+			if (_ifma) FFT_DIF_Harvey_mod2p_iterative8x1_IFMA (fft);
+			else
+#endif
+				FFT_DIF_Harvey_mod2p_iterative (fft);
+			for (uint64_t i = 0; i < n; i++)
+				if (fft[i] >= _pl) fft[i] -= _pl;
+		}
+
+		void FFT_DIT (uint64_t *fft) {
+#ifdef __LINBOX_FFT64_IFMA
+			if (_ifma) FFT_DIT_Harvey_mod4p_iterative8x1_IFMA (fft);
+			else
+#endif
+				FFT_DIT_Harvey_mod4p_iterative (fft);
+			for (uint64_t i = 0; i < n; i++) {
+				if (fft[i] >= _dpl) fft[i] -= _dpl;
+				if (fft[i] >= _pl) fft[i] -= _pl;
+			}
+		}
+
+		// other element types go through the conversion buffer data (size n)
+		template <class T>
+		void FFT_DIF (T *fft, VECT &data) {
+			for (size_t i = 0; i < n; i++) data[i] = (uint64_t)fft[i];
+			FFT_DIF (data.data());
+			for (size_t i = 0; i < n; i++) fft[i] = (T)data[i];
+		}
+
+		template <class T>
+		void FFT_DIT (T *fft, VECT &data) {
+			for (size_t i = 0; i < n; i++) data[i] = (uint64_t)fft[i];
+			FFT_DIT (data.data());
+			for (size_t i = 0; i < n; i++) fft[i] = (T)data[i];
+		}
+
+		void FFT_DIF (uint64_t *fft, VECT &) { FFT_DIF (fft); }
+		void FFT_DIT (uint64_t *fft, VECT &) { FFT_DIT (fft); }
+
+		template <class T>
+		void FFT_DIF (T *fft) { FFT_DIF (fft, _data); }
+		template <class T>
+		void FFT_DIT (T *fft) { FFT_DIT (fft, _data); }
+
+	private:
+		void init () {
+			_pl  = fld->characteristic();
+			_dpl = (_pl << 1);
+			linbox_check((_pl >> 62) == 0 );
+		}
+
+		void setTables (std::shared_ptr<const FFT_tables64> T) {
+			_tables = T;
+			_w      = T->w;
+			_invw   = T->invw;
+			pow_w   = T->pow_w.data();
+			pow_wp  = T->pow_wp.data();
+			pow_wq  = T->pow_wq.data();
+			_ifma   = (ln > 0) && (T->pow_wq.size() == T->pow_w.size());
+		}
+
+		/*
+		 * Butterflies with Harvey's trick, on 64-bit words
+		 */
+		inline void Butterfly_DIT_mod4p (uint64_t& A, uint64_t& B, const uint64_t& alpha, const uint64_t& alphap);
+		inline void Butterfly_DIF_mod2p (uint64_t& A, uint64_t& B, const uint64_t& alpha, const uint64_t& alphap);
+
+		void FFT_DIF_Harvey_mod2p_iterative (uint64_t *fft);
+		void FFT_DIT_Harvey_mod4p_iterative (uint64_t *fft);
+#ifdef __LINBOX_FFT64_IFMA
+		inline void Butterfly_DIF_mod2p_8x1_IFMA (uint64_t* A, uint64_t* B, const uint64_t* alpha, const uint64_t* alphaq,
+												  const __m512i& P, const __m512i& P2);
+		inline void Butterfly_DIT_mod4p_8x1_IFMA (uint64_t* A, uint64_t* B, const uint64_t* alpha, const uint64_t* alphaq,
+												  const __m512i& P, const __m512i& P2);
+		void FFT_DIF_Harvey_mod2p_iterative8x1_IFMA (uint64_t *fft);
+		void FFT_DIT_Harvey_mod4p_iterative8x1_IFMA (uint64_t *fft);
+#endif
+	}; // class FFT_transform64
+
+} // end of namespace LinBox
+
+#include "linbox/algorithms/polynomial-matrix/polynomial-fft-transform-64.inl"
+
+#endif // __LINBOX_polynomial_fft_transform_64_H
+
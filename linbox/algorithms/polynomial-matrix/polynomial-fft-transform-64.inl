@@ -0,0 +1,177 @@
+/* -*- mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+// vim:sts=4:sw=4:ts=4:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
+/*
+ * Copyright (C) 2014  Pascal Giorgi, Romain Lebreton
+ *
+ * Written by Pascal Giorgi <pascal.giorgi@lirmm.fr>
+ *            Romain Lebreton <romain.lebreton@lirmm.fr>
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+namespace LinBox {
+
+	template <class Field>
+	inline void FFT_transform64<Field>::Butterfly_DIT_mod4p(uint64_t& A, uint64_t& B, const uint64_t& alpha, const uint64_t& alphap) {
+		// Harvey's algorithm
+		// 0 <= A,B < 4*p, p < 2^64 / 4
+		// alphap = Floor(alpha * 2^ 64 / p])
+		if (A >= _dpl) A -= _dpl;
+		uint64_t tmp = mulhi64 (alphap, B);
+		tmp = alpha * B - tmp * _pl;
+		B = A + (_dpl - tmp);
+		A += tmp;
+	}
+
+	template <class Field>
+	inline void FFT_transform64<Field>::Butterfly_DIF_mod2p(uint64_t& A, uint64_t& B, const uint64_t& alpha, const uint64_t& alphap) {
+		// Harvey's algorithm
+		// 0 <= A,B < 2*p, p < 2^64 / 4
+		// alphap = Floor(alpha * 2^ 64 / p])
+		uint64_t tmp = A;
+		A += B;
+		if (A >= _dpl) A -= _dpl;
+		B = tmp + (_dpl - B);
+		tmp = mulhi64 (alphap, B);
+		B = alpha * B - tmp * _pl;
+	}
+
+	template <class Field>
+	void FFT_transform64<Field>::FFT_DIF_Harvey_mod2p_iterative (uint64_t *fft) {
+		const uint64_t * tab_w = pow_w;
+		const uint64_t * tab_wp= pow_wp;
+		for (size_t w = n >> 1, f = 1; w != 0; tab_w+=w, tab_wp+=w, w >>= 1, f <<= 1)
+			// w : witdh of butterflies
+			// f : # families of butterflies
+			for (size_t i = 0; i < f; i++)
+				for (size_t j = 0; j < w; j++)
+					Butterfly_DIF_mod2p(fft[(i << 1)*w+j], fft[((i << 1)+1)*w+j], tab_w[j], tab_wp[j]);
+	}
+
+	template <class Field>
+	void FFT_transform64<Field>::FFT_DIT_Harvey_mod4p_iterative (uint64_t *fft) {
+		for (size_t w = 1, f = n >> 1; f >= 1; w <<= 1, f >>= 1) {
+			// the butterflies of width w use the twiddle factors at n-2w
+			const uint64_t * tab_w = pow_w  + (n-2*w);
+			const uint64_t * tab_wp= pow_wp + (n-2*w);
+			for (size_t i = 0; i < f; i++)
+				for (size_t j = 0; j < w; j++)
+					Butterfly_DIT_mod4p(fft[(i << 1)*w+j], fft[((i << 1)+1)*w+j], tab_w[j], tab_wp[j]);
+		}
+	}
+
+
+#ifdef __LINBOX_FFT64_IFMA
+
+	/*-----------------------------------------------------*/
+	/*--  DIF/DIT with AVX-512 IFMA (p < 2^50)         ----*/
+	/*-----------------------------------------------------*/
+
+	// a.b mod p in [0,2p) for a < 2^52 with the 52-bit Shoup's precomputation bq
+	__LINBOX_TARGET_IFMA inline __m512i mul_mod_ifma (const __m512i a, const __m512i b, const __m512i p, const __m512i bq) {
+		const __m512i zero = _mm512_setzero_si512();
+		const __m512i mask = _mm512_set1_epi64((1LL << 52) - 1);
+		__m512i q = _mm512_madd52hi_epu64(zero,a,bq);
+		__m512i c = _mm512_madd52lo_epu64(zero,a,b);
+		__m512i t = _mm512_madd52lo_epu64(zero,q,p);
+		return _mm512_and_si512(_mm512_sub_epi64(c,t),mask);
+	}
+
+	template <class Field>
+	__LINBOX_TARGET_IFMA inline void FFT_transform64<Field>::Butterfly_DIF_mod2p_8x1_IFMA (uint64_t* A, uint64_t* B,
+																	   const uint64_t* alpha, const uint64_t* alphaq,
+																	   const __m512i& P, const __m512i& P2) {
+		__m512i V1,V2,V3,W,Wq,T;
+		V1 = _mm512_loadu_si512(A);
+		V2 = _mm512_loadu_si512(B);
+		W  = _mm512_loadu_si512(alpha);
+		Wq = _mm512_loadu_si512(alphaq);
+
+		// V3 = V1 + V2 mod 2P
+		V3 = _mm512_add_epi64(V1,V2);
+		V3 = _mm512_min_epu64(V3,_mm512_sub_epi64(V3,P2));
+		_mm512_storeu_si512(A,V3);
+
+		// (V1+(2P-V2))alpha mod 2P
+		T = _mm512_sub_epi64(_mm512_add_epi64(V1,P2),V2);
+		_mm512_storeu_si512(B,mul_mod_ifma(T,W,P,Wq));
+	}
+
+	template <class Field>
+	__LINBOX_TARGET_IFMA inline void FFT_transform64<Field>::Butterfly_DIT_mod4p_8x1_IFMA (uint64_t* A, uint64_t* B,
+																	   const uint64_t* alpha, const uint64_t* alphaq,
+																	   const __m512i& P, const __m512i& P2) {
+		__m512i V1,V2,W,Wq,T;
+		V1 = _mm512_loadu_si512(A);
+		V2 = _mm512_loadu_si512(B);
+		W  = _mm512_loadu_si512(alpha);
+		Wq = _mm512_loadu_si512(alphaq);
+
+		// V1 mod 2P
+		V1 = _mm512_min_epu64(V1,_mm512_sub_epi64(V1,P2));
+		// V2 * W mod P
+		T  = mul_mod_ifma(V2,W,P,Wq);
+		_mm512_storeu_si512(A,_mm512_add_epi64(V1,T));
+		_mm512_storeu_si512(B,_mm512_sub_epi64(_mm512_add_epi64(V1,P2),T));
+	}
+
+	// the butterflies of width < 8 are done with the scalar code, values
+	// stay below 4p < 2^52 in any case
+	template <class Field>
+	__LINBOX_TARGET_IFMA void FFT_transform64<Field>::FFT_DIF_Harvey_mod2p_iterative8x1_IFMA (uint64_t *fft) {
+		__m512i P,P2;
+		P  = _mm512_set1_epi64((int64_t)_pl);
+		P2 = _mm512_set1_epi64((int64_t)_dpl);
+		const uint64_t * tab_w = pow_w;
+		const uint64_t * tab_wq= pow_wq;
+		const uint64_t * tab_wp= pow_wp;
+		size_t w, f;
+		for (w = n >> 1, f = 1; w >= 8; tab_w+=w, tab_wq+=w, tab_wp+=w, w >>= 1, f <<= 1)
+			for (size_t i = 0; i < f; i++)
+				for (size_t j = 0; j < w; j+=8)
+					Butterfly_DIF_mod2p_8x1_IFMA(&fft[(i << 1)*w+j], &fft[((i << 1)+1)*w+j], tab_w+j, tab_wq+j, P, P2);
+		for (; w != 0; tab_w+=w, tab_wp+=w, w >>= 1, f <<= 1)
+			for (size_t i = 0; i < f; i++)
+				for (size_t j = 0; j < w; j++)
+					Butterfly_DIF_mod2p(fft[(i << 1)*w+j], fft[((i << 1)+1)*w+j], tab_w[j], tab_wp[j]);
+	}
+
+	template <class Field>
+	__LINBOX_TARGET_IFMA void FFT_transform64<Field>::FFT_DIT_Harvey_mod4p_iterative8x1_IFMA (uint64_t *fft) {
+		__m512i P,P2;
+		P  = _mm512_set1_epi64((int64_t)_pl);
+		P2 = _mm512_set1_epi64((int64_t)_dpl);
+		for (size_t w = 1, f = n >> 1; f >= 1; w <<= 1, f >>= 1) {
+			const uint64_t * tab_w = pow_w  + (n-2*w);
+			const uint64_t * tab_wp= pow_wp + (n-2*w);
+			const uint64_t * tab_wq= pow_wq + (n-2*w);
+			for (size_t i = 0; i < f; i++)
+				if (w >= 8)
+					for (size_t j = 0; j < w; j+=8)
+						Butterfly_DIT_mod4p_8x1_IFMA(&fft[(i << 1)*w+j], &fft[((i << 1)+1)*w+j], tab_w+j, tab_wq+j, P, P2);
+				else
+					for (size_t j = 0; j < w; j++)
+						Butterfly_DIT_mod4p(fft[(i << 1)*w+j], fft[((i << 1)+1)*w+j], tab_w[j], tab_wp[j]);
+		}
+	}
+
+#endif // end of IFMA section
+
+} // end of namespace LinBox
+
@@ -337,8 +337,8 @@ namespace LinBox {
 		_vect128_t P,P2;
 		P  = Simd128<uint32_t>::set1(_pl);
 		P2 = Simd128<uint32_t>::set1(_dpl);
-		uint32_t * tab_w = &pow_w [0];
-		uint32_t * tab_wp= &pow_wp[0];
+		const uint32_t * tab_w = &pow_w [0];
+		const uint32_t * tab_wp= &pow_wp[0];
 		size_t w, f;
 		for (w = n >> 1, f = 1; w >= 4; tab_w+=w, tab_wp+=w, w >>= 1, f <<= 1){
 				// w : witdh of butterflies
@@ -380,8 +380,8 @@ namespace LinBox {
 		_vect128_t P,P2;
 		P  = Simd128<uint32_t>::set1(_pl);
 		P2 = Simd128<uint32_t>::set1(_dpl);
-		uint32_t * tab_w =  &pow_w[0];
-		uint32_t * tab_wp= &pow_wp[0];
+		const uint32_t * tab_w =  &pow_w[0];
+		const uint32_t * tab_wp= &pow_wp[0];
 		for (w = n >> 1, f = 1; w >= 8; tab_w+=w+(w>>1), tab_wp+=w+(w>>1), w >>= 2, f <<= 2)
 			// w : witdh of butterflies
 			// f : # families of butterflies
@@ -450,8 +450,8 @@ namespace LinBox {
 				for (size_t i = 0; i < n; i+=8)
 					Butterfly_DIT_mod4p_4x2_SSE_first2step(&fft[i],&fft[i+4],W,Wp,P,P2);
 
-				uint32_t * tab_w = &pow_w [n-8];
-				uint32_t * tab_wp= &pow_wp[n-8];
+				const uint32_t * tab_w = &pow_w [n-8];
+				const uint32_t * tab_wp= &pow_wp[n-8];
 				for (size_t w = 4, f = n >> 3; f >= 1; w <<= 1, f >>= 1, tab_w-=w, tab_wp-=w){
 						// w : witdh of butterflies
 						// f : # families of butterflies
@@ -466,8 +466,8 @@ namespace LinBox {
 
 					}
 			} else {
-				uint32_t * tab_w = &pow_w [n-2];
-				uint32_t * tab_wp= &pow_wp[n-2];
+				const uint32_t * tab_w = &pow_w [n-2];
+				const uint32_t * tab_wp= &pow_wp[n-2];
 				for (size_t w = 1, f = n >> 1; f >= 1; w <<= 1, f >>= 1, tab_w-=w, tab_wp-=w)
 					for (size_t i = 0; i < f; i++)
 						for (size_t j = 0; j < w; j++)
@@ -613,14 +613,21 @@ namespace LinBox {
 
 	template <class Field>
 	void FFT_transform<Field>::FFT_DIF_Harvey_mod2p_iterative8x1_AVX (uint32_t *fft) {
+		FFT_DIF_Harvey_mod2p_iterative8x1_AVX (fft, n);
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::FFT_DIF_Harvey_mod2p_iterative8x1_AVX (uint32_t *fft, uint64_t wmax) {
 		_vect256_t P,P2;
 		P = Simd256<uint32_t>::set1(_pl);
 		P2 = Simd256<uint32_t>::set1(_dpl);
 
-		uint32_t * tab_w = &pow_w [0];
-		uint32_t * tab_wp= &pow_wp[0];
+		const uint32_t * tab_w = &pow_w [0];
+		const uint32_t * tab_wp= &pow_wp[0];
 		size_t w, f;
-		for (w = n >> 1, f = 1; w >= 8; tab_w+=w, tab_wp+=w, w >>= 1, f <<= 1){
+		// skip the steps already done (width >= wmax)
+		for (w = n >> 1, f = 1; w >= wmax; tab_w+=w, tab_wp+=w, w >>= 1, f <<= 1) ;
+		for (; w >= 8; tab_w+=w, tab_wp+=w, w >>= 1, f <<= 1){
 				// w : witdh of butterflies
 				// f : # families of butterflies
 				for (size_t i = 0; i < f; i++)
@@ -796,6 +803,11 @@ namespace LinBox {
 
 	template <class Field>
 	void FFT_transform<Field>::FFT_DIT_Harvey_mod4p_iterative8x1_AVX (uint32_t *fft) {
+		FFT_DIT_Harvey_mod4p_iterative8x1_AVX (fft, n);
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::FFT_DIT_Harvey_mod4p_iterative8x1_AVX (uint32_t *fft, uint64_t wmax) {
 		_vect256_t P,P2;
 		P = Simd256<uint32_t>::set1(_pl);
 		P2 = Simd256<uint32_t>::set1(_dpl);
@@ -818,9 +830,9 @@ namespace LinBox {
 				betap = Simd256<uint32_t>::loadu(tmp);
 				for (uint64_t i = 0; i < n; i+=16)
 					Butterfly_DIT_mod4p_8x3_AVX_first3step(&fft[i],&fft[i+8],alpha,alphap,beta,betap,P,P2);
-				uint32_t * tab_w = &pow_w [n-16];
-				uint32_t * tab_wp= &pow_wp[n-16];
-				for (size_t w = 8, f = n >> 4; f >= 1; w <<= 1, f >>= 1, tab_w-=w, tab_wp-=w){
+				const uint32_t * tab_w = &pow_w [n-16];
+				const uint32_t * tab_wp= &pow_wp[n-16];
+				for (size_t w = 8, f = n >> 4; f >= 1 && w < wmax; w <<= 1, f >>= 1, tab_w-=w, tab_wp-=w){
 						// w : witdh of butterflies
 						// f : # families of butterflies
 						for (size_t i = 0; i < f; i++)
@@ -832,8 +844,8 @@ namespace LinBox {
 #undef A4
 					}
 			} else {
-				uint32_t * tab_w = &pow_w [n-2];
-				uint32_t * tab_wp= &pow_wp[n-2];
+				const uint32_t * tab_w = &pow_w [n-2];
+				const uint32_t * tab_wp= &pow_wp[n-2];
 				for (size_t w = 1, f = n >> 1; f >= 1; w <<= 1, f >>= 1, tab_w-=w, tab_wp-=w)
 					for (size_t i = 0; i < f; i++)
 						for (size_t j = 0; j < w; j++)
@@ -846,6 +858,146 @@ namespace LinBox {
 
 #endif // end of AVX2 section
 
+
+	/******************************************************************************************************************
+	 ******************************************************************************************************************
+	 ***********************************   FFT with AVX-512 CODE  *****************************************************
+	 ******************************************************************************************************************
+	 ******************************************************************************************************************/
+
+#ifdef __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+
+	// high 32 bits of the products of the unsigned 32-bit lanes
+	inline _vect512_t mulhi512_epu32 (const _vect512_t a, const _vect512_t b) {
+		_vect512_t even = _mm512_srli_epi64(_mm512_mul_epu32(a,b),32);
+		_vect512_t odd  = _mm512_mul_epu32(_mm512_srli_epi64(a,32),_mm512_srli_epi64(b,32));
+		return _mm512_mask_blend_epi32(0xAAAA,even,odd);
+	}
+
+	// a - p if a >= p (a < 2p)
+	inline _vect512_t reduce512 (const _vect512_t a, const _vect512_t p) {
+		return _mm512_min_epu32(a,_mm512_sub_epi32(a,p));
+	}
+
+	// a.b mod p in [0,2p) with Shoup's precomputation bp
+	inline _vect512_t mul_mod512 (const _vect512_t a, const _vect512_t b, const _vect512_t p, const _vect512_t bp) {
+		_vect512_t q = mulhi512_epu32(a,bp);
+		_vect512_t c = _mm512_mullo_epi32(a,b);
+		_vect512_t t = _mm512_mullo_epi32(q,p);
+		return _mm512_sub_epi32(c,t);
+	}
+
+	template <class Field>
+	inline void FFT_transform<Field>::reduce512_modp(uint32_t* ABCD, const _vect512_t& P) {
+		_vect512_t V1;
+		V1 = _mm512_loadu_si512(ABCD);
+		V1 = reduce512(V1, P);
+		_mm512_storeu_si512(ABCD,V1);
+	}
+
+	/*---------------------------------------------------*/
+	/*--  implementation of DIF with 512-bits AVX    ----*/
+	/*---------------------------------------------------*/
+
+	template <class Field>
+	inline void FFT_transform<Field>::Butterfly_DIF_mod2p_16x1_AVX512(uint32_t* A, uint32_t* B,
+																	  const uint32_t* alpha,
+																	  const uint32_t* alphap,
+																	  const _vect512_t& P, const _vect512_t& P2) {
+		_vect512_t V1,V2,V3,V4,W,Wp,T;
+		V1 = _mm512_loadu_si512(A);
+		V2 = _mm512_loadu_si512(B);
+		W  = _mm512_loadu_si512(alpha);
+		Wp = _mm512_loadu_si512(alphap);
+
+		// V3 = V1 + V2 mod 2P
+		V3 = reduce512(_mm512_add_epi32(V1,V2),P2);
+		_mm512_storeu_si512(A,V3);
+
+		// V4 = (V1+(2P-V2))alpha mod 2P
+		T  = _mm512_sub_epi32(V2,P2);
+		V4 = _mm512_sub_epi32(V1,T);
+		T  = mul_mod512(V4,W,P,Wp);
+		_mm512_storeu_si512(B,T);
+	}
+
+	// The steps with butterflies of width >= 16 use 16 lanes, the last
+	// four ones are those of the AVX2 code
+	template <class Field>
+	void FFT_transform<Field>::FFT_DIF_Harvey_mod2p_iterative16x1_AVX512 (uint32_t *fft) {
+		_vect512_t P,P2;
+		P  = _mm512_set1_epi32((int32_t)_pl);
+		P2 = _mm512_set1_epi32((int32_t)_dpl);
+
+		const uint32_t * tab_w = &pow_w [0];
+		const uint32_t * tab_wp= &pow_wp[0];
+		for (size_t w = n >> 1, f = 1; w >= 16; tab_w+=w, tab_wp+=w, w >>= 1, f <<= 1)
+			// w : witdh of butterflies
+			// f : # families of butterflies
+			for (size_t i = 0; i < f; i++)
+				for (size_t j = 0; j < w; j+=16)
+#define A0 &fft[0] +  (i << 1)   *w+ j
+#define A4 &fft[0] + ((i << 1)+1)*w+ j
+					Butterfly_DIF_mod2p_16x1_AVX512(A0,A4, tab_w+j,tab_wp+j,P,P2);
+#undef A0
+#undef A4
+		FFT_DIF_Harvey_mod2p_iterative8x1_AVX(fft, 16);
+	}
+
+	/*---------------------------------------------------*/
+	/*--  implementation of DIT with 512-bits AVX    ----*/
+	/*---------------------------------------------------*/
+
+	template <class Field>
+	inline void FFT_transform<Field>::Butterfly_DIT_mod4p_16x1_AVX512(uint32_t* A, uint32_t* B,
+																	  const uint32_t* alpha,
+																	  const uint32_t* alphap,
+																	  const _vect512_t& P, const _vect512_t& P2) {
+		_vect512_t V1,V2,V3,V4,W,Wp,T;
+		V1 = _mm512_loadu_si512(A);
+		V2 = _mm512_loadu_si512(B);
+		W  = _mm512_loadu_si512(alpha);
+		Wp = _mm512_loadu_si512(alphap);
+
+		// V3 = V1 mod 2P
+		V3 = reduce512(V1, P2);
+
+		// V4 = V2 * W mod P
+		V4 = mul_mod512(V2,W,P,Wp);
+
+		// V1 = V3 + V4
+		V1 = _mm512_add_epi32(V3,V4);
+		_mm512_storeu_si512(A,V1);
+
+		// V2 = V3 - (V4 - 2P)
+		T  = _mm512_sub_epi32(V4,P2);
+		V2 = _mm512_sub_epi32(V3,T);
+		_mm512_storeu_si512(B,V2);
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::FFT_DIT_Harvey_mod4p_iterative16x1_AVX512 (uint32_t *fft) {
+		FFT_DIT_Harvey_mod4p_iterative8x1_AVX(fft, 16);
+
+		_vect512_t P,P2;
+		P  = _mm512_set1_epi32((int32_t)_pl);
+		P2 = _mm512_set1_epi32((int32_t)_dpl);
+		// the butterflies of width w use the twiddle factors at n-2w
+		for (size_t w = 16, f = n >> 5; f >= 1; w <<= 1, f >>= 1) {
+			const uint32_t * tab_w = &pow_w [n-2*w];
+			const uint32_t * tab_wp= &pow_wp[n-2*w];
+			for (size_t i = 0; i < f; i++)
+				for (size_t j = 0; j < w; j+=16)
+#define A0 &fft[0] +  (i << 1)   *w+ j
+#define A4 &fft[0] + ((i << 1)+1)*w+ j
+					Butterfly_DIT_mod4p_16x1_AVX512(A0,A4, tab_w+j,tab_wp+j,P,P2);
+#undef A0
+#undef A4
+		}
+	}
+
+#endif // end of AVX-512 section
+
 } // enf of namespace LinBox
 
 #endif //end of file
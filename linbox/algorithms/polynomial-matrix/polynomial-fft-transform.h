@@ -30,6 +30,11 @@
 #define __LINBOX_polynomial_fft_transform_H
 
 #include <iostream>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <memory>
+#include <mutex>
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
 #include "givaro/givinteger.h"
@@ -63,6 +68,13 @@ typedef __m256i  _vect256_t;
 
 #endif
 
+#ifdef __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+/* 512 bits CODE */
+// define 512 bits simd vector type
+typedef __m512i  _vect512_t;
+
+#endif
+
 // define 128 bits simd vector type
 typedef __m128i  _vect128_t;
 
@@ -71,169 +83,242 @@ typedef __m128i  _vect128_t;
 namespace LinBox {
 
 
-	// class to handle FFT transform over wordsize prime field Fp (p < 2^29)
-	template <class Field>
-	class FFT_transform {
-	public:
-		typedef typename Field::Element Element;
-
-		const Field                *fld;
-		uint64_t              _pl, _dpl;
-		uint64_t                      n;
-		uint64_t                     ln;
-		//uint64_t                  _logp;
-		//uint64_t                     _I;
-		//double                    _pinv;
-		uint32_t                      _w;
-		uint32_t                   _invw;
+	/*
+	 * Twiddle tables of a transform of size K = 2^ln over Fp (p < 2^29)
+	 * for the primitive K-th root of unity w:
+	 *   pow_w = table of roots of unity. If w = primitive K-th root, then the table is:
+	 *           1, w, w^2, ..., w^{K/2-1},
+	 *           1, w^2, w^4, ..., w^{K/2-2},
+	 *           1, w^4, w^8, ..., w^{K/2-4}
+	 *           ...
+	 *           1, w^{K/8}, w^{K/4}, w^{3K/8},
+	 *           1, w^{K/4},
+	 *           1.
+	 *   pow_wp = Shoup's precomputations floor(pow_w * 2^32 / p).
+	 * The tables never change once built, so they can be shared by any
+	 * number of transforms and threads (see FFT_plan_cache).
+	 */
+	struct FFT_tables {
 		typedef std::vector<uint32_t,AlignedAllocator<uint32_t, Alignment::DEFAULT> > VECT;
-		VECT    pow_w;
-		VECT   pow_wp; // Precomputations in shoup
-		VECT    _data;
-		Element                      _p;
-		//   pow_w = table of roots of unity. If w = primitive K-th root, then the table is:
-		//           1, w, w^2, ..., w^{K/2-1},
-		//           1, w^2, w^4, ..., w^{K/2-2},
-		//           1, w^4, w^8, ..., w^{K/2-4}
-		//           ...
-		//           1, w^{K/8}, w^{K/4}, w^{3K/8},
-		//           1, w^{K/4},
-		//           1.
 
-		inline const Field & field() const { return *fld; }
-
-		uint64_t find_gen (uint64_t _m, uint64_t _val2p) {
-			// find a primitive 2^k root of unity where
-			// _p - 1 = 2^val2p * m
-			srand((unsigned int) time(NULL));
-			uint64_t y,z,j;
-			uint64_t _gen;
-			for (;;) {
-				_gen = rand() % _pl; if (_gen <= 0) continue;
-				z = 1;
-				for (unsigned long i=0; i < _m; ++i) z = z*_gen % _pl;
-				if (z == 1) continue;
-				// _gen^i =/ 1 pour 0 <= i < m
-				_gen = z;
-				j = 0;
-				do {
-					y = z;
-					z = y*y % _pl;
-					j++;
-				} while (j != _val2p && z != 1);
-				if (j == _val2p)
-					break;
-			}
-			return _gen;
-		}
+		uint64_t                      p;
+		uint64_t                     ln;
+		uint32_t                      w;
+		uint32_t                   invw;
+		VECT                      pow_w;
+		VECT                     pow_wp;
 
-		FFT_transform (const Field& fld2, size_t ln2, Element w = 0)
-			: fld (&fld2), n ((1UL << ln2)), ln (ln2), pow_w(n - 1), pow_wp(n - 1), _data(n) {
-			_pl = fld->characteristic();
-			_p  = fld->characteristic();
+		FFT_tables (uint64_t p2, uint64_t ln2, uint32_t w2)
+			: p (p2), ln (ln2), w (w2), pow_w ((1UL << ln2) - 1), pow_wp ((1UL << ln2) - 1) {
+			linbox_check((p >> 29) == 0 ); // 8*p < 2^31 for Harvey's butterflies
 
-			linbox_check((_pl >> 29) == 0 ); // 8*p < 2^31 for Harvey's butterflies
-			_dpl = (_pl << 1);
-			//_pinv = 1 / (double) _pl;
-			Givaro::Timer chrono;
-			
-			if (w == 0){   // find a pseudo 2^lpts-th primitive root of unity
-
-				chrono.start();
-
-				uint64_t _val2p = 0;
-				uint64_t     _m = _pl;
-				_m = _pl - 1;
-				while ((_m & 1) == 0) {
-					_m >>= 1;
-					_val2p++;
-				}
-				//_I = (1L << (_logp << 1)) / _pl;
-				uint64_t _gen = find_gen (_m, _val2p);
-				_w = Givaro::powmod(_gen, 1<<(_val2p-ln), _pl);
-		
-			}
-			else {
-				_w = (uint32_t)w;
-			}
-			chrono.clear();
-			chrono.start();
-			
 			// compute w^(-1) mod p = w^(2^lpts - 1)
-			_invw = Givaro::powmod(_w, ((uint64_t)1<<ln) - 1, _pl);
-			
+			invw = (uint32_t)Givaro::powmod(w, ((uint64_t)1<<ln) - 1, p);
+
 			size_t pos = 0;
-			//uint64_t wi = 1;
 			uint32_t wi = 1;
-			uint32_t __w = _w;
-			uint64_t  _logp = Givaro::Integer(_pl).bitsize() -1;
-			uint32_t BAR= (Givaro::Integer(1)<<(32+_logp))/Givaro::Integer(_pl);
-			uint32_t Q;
-			//cout<<"log Bar: "<<Integer(BAR).bitsize()<<endl;
+			uint32_t __w = w;
 			if (ln>0){
 #ifdef MYOLD_FFTINIT
 				size_t tpts = 1 << (ln - 1);
 				while (tpts > 0) {
 					for (size_t i = 0; i < tpts; i++, pos++) {
 						pow_w[pos] = wi;
-						pow_wp[pos] = ((uint64_t) pow_w[pos] << 32UL) / _pl;
-						wi= (wi*__w)%_pl;
+						pow_wp[pos] = ((uint64_t) pow_w[pos] << 32UL) / p;
+						wi= ((uint64_t)wi*__w)%p;
 					}
 					wi = 1;
-					__w = (__w * __w) % _pl;
-					//field().mulin(__w, __w);
+					__w = ((uint64_t)__w * __w) % p;
 					tpts >>= 1;
 				}
 #else
-//				using simd=Simd<uint32_t>;
-//				using vect_t =typename simd::vect_t;
-				
+				uint64_t  _logp = Givaro::Integer(p).bitsize() -1;
+				uint32_t BAR= (Givaro::Integer(1)<<(32+_logp))/Givaro::Integer(p);
+				uint32_t Q;
 				size_t tpts = 1 << (ln - 1);
 				size_t i=0;
-//				for( ;i<std::min(simd::vect_size+1, tpts);i++,pos++){
 				// Precompute pow_wp[1] for faster mult by pow_w[1]
 				for( ;i<std::min((size_t) 2, tpts);i++,pos++){
 					pow_w[pos] = wi;
-					pow_wp[pos] = ((uint64_t) pow_w[pos] << 32UL) / _pl;
-					wi= ((uint64_t)wi*__w)%_pl;
+					pow_wp[pos] = ((uint64_t) pow_w[pos] << 32UL) / p;
+					wi= ((uint64_t)wi*__w)%p;
 				}
-				/*
-				vect_t wp_vect, Q_vect,BAR_vect,w_vect,pow_w_vect,pow_wp_vect, pl_vect;
-				BAR_vect= simd::set1(BAR);
-				wp_vect = simd::set1(pow_wp[simd::vect_size]);
-				w_vect  = simd::set1(pow_w[simd::vect_size]);
-				pl_vect = simd::set1(_pl);
-				for (; i < ROUND_DOWN(tpts,simd::vect_size);
-					 i+=simd::vect_size,pos+=simd::vect_size) {
-					pow_w_vect  = simd::loadu((int32_t*)pow_w.data()+pos-simd::vect_size);
-					Q_vect=simd::mulhi(pow_w_vect,wp_vect);
-					pow_w_vect = simd::sub(simd::mullo(pow_w_vect,w_vect),simd::mullo(Q_vect,pl_vect));
-					pow_w_vect=simd::sub(pow_w_vect, simd::vandnot(simd::greater(pow_w_vect,pl_vect),pl_vect));
-					simd::storeu((int32_t*)pow_w.data()+pos,pow_w_vect);
-					pow_wp_vect= simd::mulhi(simd::sll(pow_w_vect,32-_logp),BAR_vect);
-					simd::storeu((int32_t*)pow_wp.data()+pos,pow_wp_vect);
-				}
-				*/
 				// Use pow_wp[1] for speed-up mult by pow_w[1]
 				for( ;i<tpts;i++,pos++){
 					pow_w[pos] = wi;
 					pow_wp[pos]= (((uint64_t)wi*BAR)>>_logp);
 					Q= ((uint64_t)wi*pow_wp[1])>>32;
-					wi= (uint32_t)(wi*__w - Q*_pl);
-					wi-=(wi>=_pl?_pl:0);
+					wi= (uint32_t)(wi*__w - Q*p);
+					wi-=(wi>=p?p:0);
 				}
-				
+
 				// Other pow_w elements can be read from previously computed pow_w
 				for(size_t k=2;k<=tpts;k<<=1)
 					for(size_t i=0;i<tpts;i+=k,pos++){
 						pow_w[pos]  = pow_w[i];
 						pow_wp[pos] = pow_wp[i];
 					}
-#endif	
-				
-			}	
-			chrono.stop();
-			//cout<<"FFT: table="<<chrono<<endl;
+#endif
+			}
+		}
+
+		// a primitive 2^val2p root of unity where p - 1 = 2^val2p * m
+		static uint64_t findGenerator (uint64_t p, uint64_t _m, uint64_t _val2p) {
+			srand((unsigned int) time(NULL));
+			uint64_t y,z,j;
+			uint64_t _gen;
+			for (;;) {
+				_gen = rand() % p; if (_gen <= 0) continue;
+				z = 1;
+				for (unsigned long i=0; i < _m; ++i) z = z*_gen % p;
+				if (z == 1) continue;
+				// _gen^i =/ 1 pour 0 <= i < m
+				_gen = z;
+				j = 0;
+				do {
+					y = z;
+					z = y*y % p;
+					j++;
+				} while (j != _val2p && z != 1);
+				if (j == _val2p)
+					break;
+			}
+			return _gen;
+		}
+
+		// a pseudo 2^ln-th primitive root of unity modulo p
+		static uint32_t findRoot (uint64_t p, uint64_t ln) {
+			uint64_t _val2p = 0;
+			uint64_t     _m = p - 1;
+			while ((_m & 1) == 0) {
+				_m >>= 1;
+				_val2p++;
+			}
+			linbox_check(ln <= _val2p);
+			uint64_t _gen = findGenerator (p, _m, _val2p);
+			return (uint32_t)Givaro::powmod(_gen, (uint64_t)1<<(_val2p-ln), p);
+		}
+	};
+
+	/*
+	 * Process-wide cache of the FFT twiddle tables, keyed by (modulus, log
+	 * size, direction). Lookups are thread-safe and the tables are handed
+	 * out as shared pointers to const, so a cleared cache never invalidates
+	 * the plans in use. The inverse plan of a given (p, ln) uses the inverse
+	 * of the root of the direct plan, so that direct and inverse transforms
+	 * obtained from the cache always agree.
+	 * Tables must be constructible from (p, ln, w) and provide findRoot
+	 * and invw, as FFT_tables does.
+	 */
+	template <class Tables>
+	class FFT_plan_cache_t {
+	public:
+		typedef std::shared_ptr<const Tables> Plan;
+
+		static Plan get (uint64_t p, uint64_t ln, bool inverse = false) {
+			Cache &C = cache();
+			std::lock_guard<std::mutex> lock (C.mutex);
+			auto it = C.plans.find(Key(p,ln,inverse));
+			if (it != C.plans.end())
+				return it->second;
+
+			Plan direct;
+			it = C.plans.find(Key(p,ln,false));
+			if (it != C.plans.end())
+				direct = it->second;
+			else {
+				direct = std::make_shared<const Tables> (p, ln, Tables::findRoot(p,ln));
+				C.plans[Key(p,ln,false)] = direct;
+			}
+			if (!inverse)
+				return direct;
+
+			Plan inv = std::make_shared<const Tables> (p, ln, direct->invw);
+			C.plans[Key(p,ln,true)] = inv;
+			return inv;
+		}
+
+		// number of cached plans
+		static size_t size () {
+			Cache &C = cache();
+			std::lock_guard<std::mutex> lock (C.mutex);
+			return C.plans.size();
+		}
+
+		// release the cached tables (plans still referenced stay alive)
+		static void clear () {
+			Cache &C = cache();
+			std::lock_guard<std::mutex> lock (C.mutex);
+			C.plans.clear();
+		}
+
+	private:
+		typedef std::tuple<uint64_t,uint64_t,bool> Key;
+
+		struct Cache {
+			std::mutex                mutex;
+			std::map<Key,Plan>        plans;
+		};
+
+		static Cache & cache () {
+			static Cache C;
+			return C;
+		}
+	};
+
+	typedef FFT_plan_cache_t<FFT_tables> FFT_plan_cache;
+
+	// class to handle FFT transform over wordsize prime field Fp (p < 2^29)
+	template <class Field>
+	class FFT_transform {
+	public:
+		typedef typename Field::Element Element;
+
+		const Field                *fld;
+		uint64_t              _pl, _dpl;
+		uint64_t                      n;
+		uint64_t                     ln;
+		uint32_t                      _w;
+		uint32_t                   _invw;
+		typedef FFT_tables::VECT   VECT;
+		std::shared_ptr<const FFT_tables> _tables;
+		const uint32_t         *pow_w;  // table of roots of unity, see FFT_tables
+		const uint32_t        *pow_wp;  // Precomputations in shoup
+		VECT    _data;
+		Element                      _p;
+
+		inline const Field & field() const { return *fld; }
+
+		uint64_t find_gen (uint64_t _m, uint64_t _val2p) {
+			return FFT_tables::findGenerator (_pl, _m, _val2p);
+		}
+
+		// transform with its own tables, for the root w (a random one if w = 0)
+		FFT_transform (const Field& fld2, size_t ln2, Element w = 0)
+			: fld (&fld2), n ((1UL << ln2)), ln (ln2), _data(n) {
+			_pl = fld->characteristic();
+			_p  = fld->characteristic();
+			_dpl = (_pl << 1);
+			uint32_t root = (w == 0) ? FFT_tables::findRoot (_pl, ln) : (uint32_t)w;
+			setTables (std::make_shared<const FFT_tables> (_pl, ln, root));
+		}
+
+		// transform sharing the given tables, e.g. FFT_plan_cache::get (p, ln2)
+		FFT_transform (const Field& fld2, size_t ln2, std::shared_ptr<const FFT_tables> T)
+			: fld (&fld2), n ((1UL << ln2)), ln (ln2), _data(n) {
+			_pl = fld->characteristic();
+			_p  = fld->characteristic();
+			_dpl = (_pl << 1);
+			linbox_check(T->p == _pl && T->ln == ln);
+			setTables (T);
+		}
+
+		void setTables (std::shared_ptr<const FFT_tables> T) {
+			_tables = T;
+			_w      = T->w;
+			_invw   = T->invw;
+			pow_w   = T->pow_w.data();
+			pow_wp  = T->pow_wp.data();
 		}
 
 
@@ -243,8 +328,19 @@ namespace LinBox {
 		
 		void FFT_DIF_Harvey (uint32_t *fft) {
 #ifdef __LINBOX_HAVE_SSE4_1_INSTRUCTIONS
-#ifdef __LINBOX_HAVE_AVX_INSTRUCTIONS2
+#ifdef __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+			FFT_DIF_Harvey_mod2p_iterative16x1_AVX512(fft);
+			if (n>=16){
+				_vect512_t P;
+				P = _mm512_set1_epi32((int32_t)_pl);
+				for (uint64_t i = 0; i < n; i += 16)
+					reduce512_modp(fft+i,P);
+				return;
+			}
+#elif defined(__LINBOX_HAVE_AVX_INSTRUCTIONS2)
 			FFT_DIF_Harvey_mod2p_iterative8x1_AVX(fft);
+#endif
+#ifdef __LINBOX_HAVE_AVX_INSTRUCTIONS2
 			if (n>=8){
 				_vect256_t P;
 				P = Simd256<uint32_t>::set1(_pl);
@@ -276,8 +372,22 @@ namespace LinBox {
 		
 		void FFT_DIT_Harvey (uint32_t *fft) {
 #ifdef __LINBOX_HAVE_SSE4_1_INSTRUCTIONS
-#ifdef __LINBOX_HAVE_AVX_INSTRUCTIONS2
+#ifdef __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+			FFT_DIT_Harvey_mod4p_iterative16x1_AVX512(fft);
+			if (n>=16){
+				_vect512_t P,P2;
+				P = _mm512_set1_epi32((int32_t)_pl);
+				P2 = _mm512_set1_epi32((int32_t)_dpl);
+				for (uint64_t i = 0; i < n; i += 16){
+					reduce512_modp(&fft[i],P2);
+					reduce512_modp(&fft[i],P);
+				}
+				return;
+			}
+#elif defined(__LINBOX_HAVE_AVX_INSTRUCTIONS2)
 			FFT_DIT_Harvey_mod4p_iterative8x1_AVX(fft);
+#endif
+#ifdef __LINBOX_HAVE_AVX_INSTRUCTIONS2
 			if (n>=8){
 				_vect256_t P,P2;
 				P = Simd256<uint32_t>::set1( _pl);
@@ -326,36 +436,105 @@ namespace LinBox {
 		FFT_DIT (T *fft) {
 			FFT_DIT_Harvey(fft);
 		}
-		
+		template <class T=Element>
+		typename std::enable_if<std::is_same<T,uint32_t>::value>::type
+		FFT_DIF (T *fft, VECT &) {
+			FFT_DIF_Harvey(fft);
+		}
+		template <class T=Element>
+		typename std::enable_if<std::is_same<T,uint32_t>::value>::type
+		FFT_DIT (T *fft, VECT &) {
+			FFT_DIT_Harvey(fft);
+		}
+
 		// FFT with conversion from Element to uint32_t
 		template <typename T=Element>
 		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
 		FFT_DIF (T *fft) {
-			// for(uint64_t i=0;i<n;i++)
-			// 	_data[i]=fft[i];
-			// FFT_DIF_Harvey(&_data[0]);
-			// for(uint64_t i=0;i<n;i++)
-			// 	fft[i]=_data[i];
-			std::copy(fft,fft+n,_data.data());
-			FFT_DIF_Harvey(_data.data());
-			std::copy(_data.begin(),_data.end(),fft);
-
+			FFT_DIF(fft,_data);
 		}
 		template <typename T=Element>
 		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
 		FFT_DIT (T *fft) {
-			// for(uint64_t i=0;i<n;i++)
-			// 	_data[i]=fft[i];
-			// FFT_DIT_Harvey(&_data[0]);
-			// for(uint64_t i=0;i<n;i++)
-			// 	fft[i]=_data[i];
-			std::copy(fft,fft+n,_data.data());
-			FFT_DIT_Harvey(_data.data());
-			std::copy(_data.begin(),_data.end(),fft);
+			FFT_DIT(fft,_data);
+		}
 
+		// Same with a caller provided conversion buffer (of size n): the
+		// transform itself only reads the tables, so several threads may
+		// share one FFT_transform as long as each has its own buffer.
+		template <typename T=Element>
+		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
+		FFT_DIF (T *fft, VECT &data) {
+			std::copy(fft,fft+n,data.data());
+			FFT_DIF_Harvey(data.data());
+			std::copy(data.begin(),data.begin()+n,fft);
+		}
+		template <typename T=Element>
+		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
+		FFT_DIT (T *fft, VECT &data) {
+			std::copy(fft,fft+n,data.data());
+			FFT_DIT_Harvey(data.data());
+			std::copy(data.begin(),data.begin()+n,fft);
+		}
 
+		/*
+		 * Truncated Fourier transforms (van der Hoeven), L <= n.
+		 * TFT_DIF computes the first L entries of the output of FFT_DIF
+		 * (bit reversed order), the input being zero from L on; the
+		 * entries L..n-1 are used as scratch.
+		 * TFT_DIT is the inverse of TFT_DIF up to the same factor n as
+		 * FFT_DIT: from these L values it recovers the first L
+		 * coefficients (times n), the other ones being zero on output.
+		 */
+		template <class T=Element>
+		typename std::enable_if<std::is_same<T,uint32_t>::value>::type
+		TFT_DIF (T *fft, size_t L) {
+			TFT_DIF_Harvey(fft, L);
+		}
+		template <class T=Element>
+		typename std::enable_if<std::is_same<T,uint32_t>::value>::type
+		TFT_DIT (T *fft, size_t L) {
+			TFT_DIT_Harvey(fft, L);
+		}
+		template <class T=Element>
+		typename std::enable_if<std::is_same<T,uint32_t>::value>::type
+		TFT_DIF (T *fft, size_t L, VECT &) {
+			TFT_DIF_Harvey(fft, L);
+		}
+		template <class T=Element>
+		typename std::enable_if<std::is_same<T,uint32_t>::value>::type
+		TFT_DIT (T *fft, size_t L, VECT &) {
+			TFT_DIT_Harvey(fft, L);
+		}
+		template <typename T=Element>
+		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
+		TFT_DIF (T *fft, size_t L) {
+			TFT_DIF(fft,L,_data);
+		}
+		template <typename T=Element>
+		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
+		TFT_DIT (T *fft, size_t L) {
+			TFT_DIT(fft,L,_data);
+		}
+		template <typename T=Element>
+		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
+		TFT_DIF (T *fft, size_t L, VECT &data) {
+			std::copy(fft,fft+L,data.data());
+			std::fill(data.begin()+L,data.begin()+n,0);
+			TFT_DIF_Harvey(data.data(), L);
+			std::copy(data.begin(),data.begin()+L,fft);
+		}
+		template <typename T=Element>
+		typename std::enable_if<!std::is_same<T,uint32_t>::value>::type
+		TFT_DIT (T *fft, size_t L, VECT &data) {
+			std::copy(fft,fft+L,data.data());
+			TFT_DIT_Harvey(data.data(), L);
+			std::copy(data.begin(),data.begin()+n,fft);
 		}
 
+		void TFT_DIF_Harvey (uint32_t *fft, size_t L);
+		void TFT_DIT_Harvey (uint32_t *fft, size_t L);
+
 		/*
 		 * Different implementations for the butterfly operations
 		 */
@@ -388,6 +567,13 @@ namespace LinBox {
 														   const __m256i& beta ,const __m256i& betap, const __m256i& P    ,const __m256i& P2);
 
 
+#endif
+#ifdef __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+		inline void reduce512_modp(uint32_t*, const __m512i&);
+		inline void Butterfly_DIF_mod2p_16x1_AVX512(uint32_t* A, uint32_t* B, const uint32_t* alpha,const uint32_t* alphap,
+													const __m512i& P, const __m512i& P2);
+		inline void Butterfly_DIT_mod4p_16x1_AVX512(uint32_t* A, uint32_t* B, const uint32_t* alpha,const uint32_t* alphap,
+													const __m512i& P, const __m512i& P2);
 #endif
 
 		/*
@@ -407,8 +593,43 @@ namespace LinBox {
 #ifdef __LINBOX_HAVE_AVX_INSTRUCTIONS2
 		void FFT_DIF_Harvey_mod2p_iterative8x1_AVX (uint32_t *fft);
 		void FFT_DIT_Harvey_mod4p_iterative8x1_AVX (uint32_t *fft);
+		// only the steps with butterflies of width < wmax
+		void FFT_DIF_Harvey_mod2p_iterative8x1_AVX (uint32_t *fft, uint64_t wmax);
+		void FFT_DIT_Harvey_mod4p_iterative8x1_AVX (uint32_t *fft, uint64_t wmax);
+#endif
+#ifdef __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+		void FFT_DIF_Harvey_mod2p_iterative16x1_AVX512 (uint32_t *fft);
+		void FFT_DIT_Harvey_mod4p_iterative16x1_AVX512 (uint32_t *fft);
 #endif
 
+	private:
+		/*
+		 * Recursive steps of the truncated transforms on a block x of
+		 * size s whose twiddle factors are pow_w[j*f]
+		 */
+		// full DIF/DIT on the block (lazy, results < 2p resp. < 4p)
+		void DIF_block (uint32_t *x, size_t s, size_t f);
+		void DIT_block (uint32_t *x, size_t s, size_t f);
+		// first L outputs, input zero from L on
+		void TFT_DIF_rec (uint32_t *x, size_t s, size_t L, size_t f);
+		// first L outputs, any input
+		void TFT_DIF_rec_dense (uint32_t *x, size_t s, size_t L, size_t f);
+		// x[0..L) are values and x[L..s) are known coefficients (times s)
+		void TFT_DIT_rec (uint32_t *x, size_t s, size_t L, size_t f);
+
+		inline uint32_t reduce_mod4p (uint32_t a) const {
+			if (a >= _dpl) a -= (uint32_t)_dpl;
+			if (a >= _pl)  a -= (uint32_t)_pl;
+			return a;
+		}
+		// a * pow_w[j] mod p for a < p
+		inline uint32_t mul_pow (uint32_t a, size_t j) const {
+			uint64_t q = ((uint64_t)pow_wp[j] * a) >> 32;
+			uint64_t r = (uint64_t)pow_w[j] * a - q * _pl;
+			while (r >= _pl) r -= _pl;
+			return (uint32_t)r;
+		}
+
 	}; // class FFT_transform
 
 } // end of namespace LinBox
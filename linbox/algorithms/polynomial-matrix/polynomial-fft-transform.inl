@@ -243,4 +243,124 @@ namespace LinBox {
 	}
 
 
+
+	/*
+	 * Truncated Fourier transforms
+	 */
+
+	template <class Field>
+	void FFT_transform<Field>::DIF_block (uint32_t *x, size_t s, size_t f) {
+		for (size_t w = s >> 1; w != 0; f <<= 1, w >>= 1)
+			for (size_t i = 0; i < s; i += (w << 1))
+				for (size_t j = 0; j < w; j++)
+					Butterfly_DIF_mod2p(x[i+j], x[i+j+w], pow_w[j*f], pow_wp[j*f]);
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::DIT_block (uint32_t *x, size_t s, size_t f) {
+		for (size_t w = 1, g = f*(s >> 1); w < s; w <<= 1, g >>= 1)
+			for (size_t i = 0; i < s; i += (w << 1))
+				for (size_t j = 0; j < w; j++)
+					Butterfly_DIT_mod4p(x[i+j], x[i+j+w], pow_w[j*g], pow_wp[j*g]);
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::TFT_DIF_rec_dense (uint32_t *x, size_t s, size_t L, size_t f) {
+		if (L == 0) return;
+		if (L == s) { DIF_block(x, s, f); return; }
+		size_t h = s >> 1;
+		if (L <= h) {
+			// only the sums x[i]+x[i+h] are needed
+			for (size_t i = 0; i < h; i++) {
+				x[i] += x[i+h];
+				if (x[i] >= _dpl) x[i] -= (uint32_t)_dpl;
+			}
+			TFT_DIF_rec_dense(x, h, L, f << 1);
+		}
+		else {
+			for (size_t i = 0; i < h; i++)
+				Butterfly_DIF_mod2p(x[i], x[i+h], pow_w[i*f], pow_wp[i*f]);
+			DIF_block(x, h, f << 1);
+			TFT_DIF_rec_dense(x+h, h, L-h, f << 1);
+		}
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::TFT_DIF_rec (uint32_t *x, size_t s, size_t L, size_t f) {
+		if (L == 0) return;
+		if (L == s) { DIF_block(x, s, f); return; }
+		size_t h = s >> 1;
+		if (L <= h) {
+			// the second half is zero
+			TFT_DIF_rec(x, h, L, f << 1);
+			return;
+		}
+		for (size_t i = 0; i < L-h; i++)
+			Butterfly_DIF_mod2p(x[i], x[i+h], pow_w[i*f], pow_wp[i*f]);
+		for (size_t i = L-h; i < h; i++) {
+			x[i+h] = 0;
+			Butterfly_DIF_mod2p(x[i], x[i+h], pow_w[i*f], pow_wp[i*f]);
+		}
+		DIF_block(x, h, f << 1);
+		TFT_DIF_rec_dense(x+h, h, L-h, f << 1);
+	}
+
+	// With u[i] = c[i]+c[i+h] and v[i] = (c[i]-c[i+h]) w^i, the first
+	// half of the values are the transform of u and the second half
+	// the transform of v.
+	template <class Field>
+	void FFT_transform<Field>::TFT_DIT_rec (uint32_t *x, size_t s, size_t L, size_t f) {
+		if (L == 0) return;
+		if (L == s) { DIT_block(x, s, f); return; }
+		size_t h = s >> 1;
+		if (L < h) {
+			// all of v is known: complete u (times h) and recurse on it
+			for (size_t i = L; i < h; i++) {
+				uint32_t a = reduce_mod4p(x[i]) + reduce_mod4p(x[i+h]);
+				if (a >= _pl) a -= (uint32_t)_pl;
+				x[i] = (a & 1) ? (uint32_t)((a + _pl) >> 1) : (a >> 1);
+			}
+			TFT_DIT_rec(x, h, L, f << 1);
+			// s c[i] = 2 h u[i] - s c[i+h]
+			for (size_t i = 0; i < h; i++) {
+				uint64_t a = 2 * (uint64_t)reduce_mod4p(x[i]) + _pl - reduce_mod4p(x[i+h]);
+				x[i] = (uint32_t)(a % _pl);
+			}
+		}
+		else {
+			// all of u is known (times h), complete v (times h) and recurse on it
+			DIT_block(x, h, f << 1);
+			for (size_t i = L-h; i < h; i++) {
+				uint32_t a = reduce_mod4p(x[i]), b = reduce_mod4p(x[i+h]);
+				// h v[i] = (h u[i] - s c[i+h]) w^i, with w^i = -w^-(h-i)
+				if (i == 0)
+					x[h] = (a >= b) ? a - b : a + (uint32_t)_pl - b;
+				else
+					x[i+h] = mul_pow((b >= a) ? b - a : b + (uint32_t)_pl - a, (h-i)*f);
+			}
+			TFT_DIT_rec(x+h, h, L-h, f << 1);
+			for (size_t i = 0; i < h; i++)
+				Butterfly_DIT_mod4p(x[i], x[i+h], pow_w[i*f], pow_wp[i*f]);
+		}
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::TFT_DIF_Harvey (uint32_t *fft, size_t L) {
+		linbox_check(L <= n);
+		if (L == n) { FFT_DIF_Harvey(fft); return; }
+		TFT_DIF_rec(fft, n, L, 1);
+		for (size_t i = 0; i < L; i++)
+			if (fft[i] >= _pl) fft[i] -= (uint32_t)_pl;
+	}
+
+	template <class Field>
+	void FFT_transform<Field>::TFT_DIT_Harvey (uint32_t *fft, size_t L) {
+		linbox_check(L <= n);
+		if (L == n) { FFT_DIT_Harvey(fft); return; }
+		std::fill(fft+L, fft+n, 0);
+		TFT_DIT_rec(fft, n, L, 1);
+		for (size_t i = 0; i < n; i++)
+			fft[i] = reduce_mod4p(fft[i]);
+	}
+
 }
@@ -33,6 +33,7 @@
 #include "linbox/algorithms/polynomial-matrix/matpoly-mult-naive.h"
 #include "linbox/algorithms/polynomial-matrix/matpoly-mult-kara.h"
 #include "linbox/algorithms/polynomial-matrix/matpoly-mult-fft.h"
+#include "linbox/algorithms/polynomial-matrix/matpoly-mult-thresholds.h"
 #include <algorithm>
 
 
@@ -46,9 +47,11 @@ namespace LinBox
 		PolynomialMatrixFFTMulDomain<Field>      _fft;
 		PolynomialMatrixNaiveMulDomain<Field>  _naive;
 		const Field*                           _field;
+		MatpolyMulDispatch                _thresholds; // tuned crossovers (see matpoly-mult-thresholds.h)
 	public:
 		PolynomialMatrixMulDomain (const Field &F) :
-			_kara(F), _fft(F), _naive(F), _field(&F) {}
+			_kara(F), _fft(F), _naive(F), _field(&F),
+			_thresholds("matpoly", F, KARA_DEG_THRESHOLD, FFT_DEG_THRESHOLD) {}
 
 		inline const Field& field() const {return *_field;}
 
@@ -56,12 +59,13 @@ namespace LinBox
 		void mul(PMatrix1 &c, const PMatrix2 &a, const PMatrix3 &b, size_t max_rowdeg=0)
 		{
 			size_t d = a.size()+b.size();
-                        if (d > FFT_DEG_THRESHOLD){
+			size_t dim = std::max(a.rowdim(),std::max(a.coldim(),b.coldim()));
+                        if (d > _thresholds.fft(dim)){
                                 //std::cout<<"PolMul FFT"<<std::endl;
 				_fft.mul(c,a,b,max_rowdeg);
                         }
 			else
-				if ( d > KARA_DEG_THRESHOLD){
+				if ( d > _thresholds.karatsuba(dim)){
                                         //std::cout<<"PolMul Kara"<<std::endl;
 					_kara.mul(c,a,b);
                                 }
@@ -80,10 +84,11 @@ namespace LinBox
 		void midproduct (PMatrix1 &c, const PMatrix2 &a, const PMatrix3 &b)
 		{
 			size_t d = b.size();
-			if (d > FFT_DEG_THRESHOLD)
+			size_t dim = std::max(a.rowdim(),std::max(a.coldim(),b.coldim()));
+			if (d > _thresholds.fft(dim))
 				_fft.midproduct(c,a,b);
 			else
-				if ( d > KARA_DEG_THRESHOLD)
+				if ( d > _thresholds.karatsuba(dim))
 					_kara.midproduct(c,a,b);
 				else
 					_naive.midproduct(c,a,b);
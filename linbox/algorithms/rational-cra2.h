@@ -30,6 +30,7 @@
 
 #include "givaro/zring.h"
 #include "linbox/vector/blas-vector.h"
+#include "linbox/util/perf-counters.h"
 #include "linbox/algorithms/rational-reconstruction-base.h"
 #include "linbox/algorithms/classic-rational-reconstruction.h"
 
@@ -114,6 +115,7 @@ namespace LinBox
 				DomainElement r; D.init(r);
 				Builder_.initialize( D, Iteration(r, D) );
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 			}
 
 			int coprime =0;
@@ -150,6 +152,7 @@ namespace LinBox
 					}
 				}
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 			}
 			Integer g;
 			Builder_.result(num,den);
@@ -170,6 +173,7 @@ namespace LinBox
 
 			if ((IterCounter==0) && (k != 0)) {
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				++genprime;
 				Domain D(*genprime);
 				DomainElement r; D.init(r);
@@ -201,6 +205,7 @@ namespace LinBox
 				Builder_.progress( D, Iteration(r, D) );
 				//if (RR_.scheduled(IterCounter-1)) {
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 #if 0
 
 				Integer M ; Builder_.getModulus(M);
@@ -238,6 +243,7 @@ namespace LinBox
 		{
 			{
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				++genprime;
 				Domain D(*genprime);
 				Vect<DomainElement, Alloc<DomainElement>  > r;
@@ -319,6 +325,7 @@ namespace LinBox
 					}
 				}
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 			}
 			Builder_.result(num,den);
 
@@ -331,6 +338,7 @@ namespace LinBox
 		{
 			{
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				++genprime;
 				Domain D(*genprime);
 				BlasVector<Domain> r(D);
@@ -413,6 +421,7 @@ namespace LinBox
 					}
 				}
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 			}
 			Builder_.result(num,den);
 
@@ -430,6 +439,7 @@ namespace LinBox
 		{
 			if ((IterCounter==0) && (k != 0)) {
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				++genprime;
 				Domain D(*genprime);
 				Vect<DomainElement, Alloc<DomainElement>  > r;
@@ -458,6 +468,7 @@ namespace LinBox
 				Builder_.progress( D, Iteration(r, D) );
 				//if (RR_.scheduled(IterCounter-1))
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 
 #if 0
 				Integer M ; Builder_.getModulus(M);
@@ -515,6 +526,7 @@ namespace LinBox
 		{
 			if ((IterCounter==0) && (k != 0)) {
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 				++genprime;
 				Domain D(*genprime);
 				BlasVector<Domain> r(D);
@@ -544,6 +556,7 @@ namespace LinBox
 				Builder_.progress( D, Iteration(r, D) );
 				//if (RR_.scheduled(IterCounter-1))
 				++IterCounter;
+				LINBOX_PERF_COUNT(PERF_CRA_PRIME, 1);
 
 #if 0
 				Integer M ; Builder_.getModulus(M);
@@ -36,6 +36,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/perf-counters.h"
 
 // #include "linbox/field/multimod-field.h"
 #include "linbox/solutions/methods.h"
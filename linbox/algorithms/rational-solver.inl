@@ -104,6 +104,7 @@ namespace LinBox
 								       const bool old,
 								       int maxPrimes) const
 	{
+		LINBOX_PERF_TIMER("Wiedemann: solve");
 		SolverReturnStatus status=SS_FAILED;
 
 		switch (A.rowdim() == A.coldim() ? solveNonsingular(num, den, A,b) : SS_SINGULAR) {
@@ -212,6 +213,7 @@ namespace LinBox
 										     const Vector2& b,
 										     int maxPrimes) const
 	{
+		LINBOX_PERF_TIMER("Wiedemann: solveSingular");
 		std::cerr<<"in singular solver\n";
 
 		typedef BlasVector<Ring>  IVector;
@@ -507,6 +509,7 @@ namespace LinBox
 										       const Vector2& b,
 										       int maxPrimes) const
 	{
+		LINBOX_PERF_TIMER("BlockWiedemann: solveNonsingular");
 		// checking if matrix is square
 		linbox_check(A.rowdim() == A.coldim());
 
@@ -618,6 +621,7 @@ namespace LinBox
 									     bool oldMatrix,
 									     int maxPrimes) const
 	{
+		LINBOX_PERF_TIMER("Dixon: solveNonsingular");
 
 		// std::cout<<"DIXON\n\n\n\n";
 #ifdef DEBUG_DIXON
@@ -794,6 +798,7 @@ namespace LinBox
 										     int maxPrimes,
 										     const SolverLevel level) const
 	{
+		LINBOX_PERF_TIMER("Dixon: monolithicSolve");
 
 		if (level == SL_MONTECARLO && maxPrimes > 1)
 			std::cout << "WARNING: Even if maxPrimes > 1, SL_MONTECARLO uses just one prime." << std::endl;
@@ -1376,6 +1381,7 @@ namespace LinBox
 										   size_t blocksize,
 										   int maxPrimes) const
 	{
+		LINBOX_PERF_TIMER("BlockHankel: solveNonsingular");
 
 		linbox_check(A.rowdim() == A.coldim());
 		linbox_check(A.rowdim() % blocksize == 0);
@@ -1471,6 +1477,7 @@ namespace LinBox
 												     const Vector2& b,
 												     int maxPrimes) const
 	{
+		LINBOX_PERF_TIMER("SparseElimination: solveNonsingular");
 
 		linbox_check(A.rowdim() == A.coldim());
 
@@ -41,6 +41,9 @@
 #include "linbox/algorithms/echelon-form.h"
 #include "linbox/vector/subvector.h"
 #include "linbox/util/timer.h"
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
 
 
 //#define OPTMIZED_SIGMA_UPDATE
@@ -50,6 +53,11 @@
  */
 #define MBASIS_THRESHOLD 16
 
+// number of field operations from which the M-Basis updates are threaded
+#ifndef SIGMA_BASIS_THREAD_THRESHOLD
+#define SIGMA_BASIS_THREAD_THRESHOLD 262144
+#endif
+
 namespace LinBox
 {
 
@@ -476,6 +484,14 @@ namespace LinBox
 
 		// Computation of a minimal Sigma Base of a Power Serie up to length
 		// algorithm is from Giorgi, Jeannerod and Villard  ISSAC'03
+		//
+		// Sigma is updated in place in a buffer allocated once for the
+		// whole computation, which stores the coefficients side by side
+		// (the m x m(length+1) matrix [Sigma_0 Sigma_1 ...]), and the
+		// Serie is stacked once in reverse order: each step is one
+		// product for the discrepancy, one triangular solve and one
+		// permutation on the whole of Sigma, cut into ranges of
+		// coefficients among the threads when it is large enough.
 		template <class Polynomial1, class Polynomial2>
 		void M_Basis(Polynomial1        &SigmaBase,
 			     Polynomial2       &PowerSerie,
@@ -492,14 +508,21 @@ namespace LinBox
 			// Set some useful constants
 			const Coefficient Zero(field(),m,m);
 
-			// Reserve memory for the Sigma Base and set SigmaBase[0] to Identity
-			SigmaBase.reserve(length+1);
-			SigmaBase.resize(1,Zero);
-			Coefficient Identity(field(),m,m);
+			// The Sigma Base gains at most one coefficient per step,
+			// Sigma_j is at the columns j*m.. of the buffer and starts at Identity
+			const size_t ld = m*(length+1);
+			std::vector<Element> Sigma(m*ld, field().zero);
 			for (size_t i=0;i< m;++i)
-				Identity.setEntry(i,i,field().one);
-			// SigmaBase.resize(1,Identity) won't work
-			SigmaBase[0] = Identity;
+				field().assign(Sigma[i*ld+i], field().one);
+			size_t size=1;
+
+			// Stacked Serie: the block b (rows b*m..) is PowerSerie[length-1-b], so that
+			// [S_k; S_k-1; ...; S_k-size+1] are the consecutive blocks from length-1-k
+			std::vector<Element> Serie(length*m*n);
+			for (size_t k=0;k<length;++k)
+				for (size_t i=0;i<m;++i)
+					for (size_t j=0;j<n;++j)
+						field().assign(Serie[((length-1-k)*m+i)*n+j], PowerSerie[k].getEntry(i,j));
 
 			// Keep track on Sigma Base's row degree
 			// I adjust the degree with the maximal difference between defects
@@ -517,10 +540,11 @@ namespace LinBox
 
 			// Discrepancy
 			Coefficient Discrepancy(field(),m,n);
+			TriangularBlasMatrix<Field> L(field(), m, m,
+						      Tag::Shape::Lower, Tag::Diag::Unit);
+			std::vector<size_t> Perm1(m);
+			std::vector<Element> Partial;
 			Timer chrono;
-#ifdef  _BM_TIMING
-			int cptr=0;
-#endif
 
 			// Compute the minimal Sigma Base of the PowerSerie up to length
 			for (size_t k=0; k< length; ++k) {
@@ -529,9 +553,6 @@ namespace LinBox
 				chrono.start();
 #endif
 				// compute BPerm1 such that BPerm1.defect is in increasing order
-				std::vector<size_t> Perm1(m);
-				for (size_t i=0;i<m;++i)
-					Perm1[i]=i;
 				for (size_t i=0;i<m;++i) {
 					size_t idx_min=i;
 					for (size_t j=i+1;j<m;++j)
@@ -540,13 +561,11 @@ namespace LinBox
 					std::swap(defect[i], defect[idx_min]);
 					Perm1[i]=idx_min;
 				}
-				BlasPermutation<size_t> BPerm1(Perm1);
 
 				// permute row degree
 				for (size_t i=0;i<m;++i)
 					std::swap(degree[i], degree[Perm1[i]]);
 
-
 #ifdef  _BM_TIMING
 				chrono.stop();
 				ttPermutation+=chrono;
@@ -554,8 +573,8 @@ namespace LinBox
 				chrono.start();
 #endif
 				// Apply Bperm1 to the current SigmaBase
-				for (size_t i=0;i<SigmaBase.size();++i)
-					_BMD.mulin_right(BPerm1,SigmaBase[i]);
+				FFPACK::applyP(field(), FFLAS::FflasLeft, FFLAS::FflasNoTrans,
+					       m*size, 0, m, Sigma.data(), ld, Perm1.data());
 
 #ifdef  _BM_TIMING
 				chrono.stop();
@@ -563,43 +582,24 @@ namespace LinBox
 				chrono.clear();
 				chrono.start();
 #endif
-				// Compute Discrepancy
-                                _BMD.mul(Discrepancy,SigmaBase[0],PowerSerie[k]);
-				for (size_t i=1;i<SigmaBase.size();++i){
-					_BMD.axpyin(Discrepancy,SigmaBase[i],PowerSerie[k-i]);
-				}
+				// Compute Discrepancy = [Sigma_0 ... Sigma_size-1] . [S_k; ...; S_k-size+1]
+				discrepancy(Discrepancy, Sigma.data(), ld, Serie.data()+(length-1-k)*m*n, m, n, size, Partial);
 
 #ifdef  _BM_TIMING
-				cptr+=SigmaBase.size();
 				chrono.stop();
 				ttResidueUp+=chrono;
 				chrono.clear();
 				chrono.start();
 #endif
 
-				//std::cout<<"MBasis: Discrepancy\n";
-				//Discrepancy.write(std::cout,field());
-
-
 				// Compute LQUP of Discrepancy
 				BlasPermutation<size_t> Qt(Discrepancy.rowdim());
 				BlasPermutation<size_t> P(Discrepancy.coldim());
 				LQUPMatrix<Field> LQUP(Discrepancy,P,Qt);
 
 				// Get L from LQUP
-				TriangularBlasMatrix<Field> L(field(), m, m,
-							      Tag::Shape::Lower, Tag::Diag::Unit);
 				LQUP.getL(L);
 
-				// get the transposed permutation of Q from LQUP
-				// BlasPermutation<size_t> Qt =LQUP.getQ();
-
-
-				// Compute the inverse of L
-				TriangularBlasMatrix<Field> invL(field(), m, m,
-								 Tag::Shape::Lower, Tag::Diag::Unit);
-				FFPACK::trinv_left((const Field &)field(),m,L.getPointer(),L.getStride(),invL.getWritePointer(),invL.getStride());
-
 #ifdef  _BM_TIMING
 				chrono.stop();
 				ttTransformation+=chrono;
@@ -608,8 +608,7 @@ namespace LinBox
 #endif
 				// Update Sigma by L^(-1)
 				// Sigma = L^(-1) . Sigma
-				for (size_t i=0;i<SigmaBase.size();++i)
-					_BMD.mulin_right(invL,SigmaBase[i]);
+				solveL(L, Sigma.data(), ld, m, size);
 
 #ifdef  _BM_TIMING
 				chrono.stop();
@@ -617,8 +616,6 @@ namespace LinBox
 				chrono.clear();
 				chrono.start();
 #endif
-				//std::cout<<"BaseBis"<<k<<":=";
-				//write_maple(F,SigmaBase);
 				// Increase  degree and defect according to row choosen as pivot in LQUP
 				for (size_t i=0;i<n;++i){
 					defect[*(Qt.getPointer()+i)]++;
@@ -631,23 +628,16 @@ namespace LinBox
 						max_degree=degree[*(Qt.getPointer()+i)];
 				}
 
-
-				size_t size=SigmaBase.size();
-				if (SigmaBase.size()<= max_degree)
-				{
-					SigmaBase.resize(size+1,Zero);
+				// the new coefficient is still zero in the buffer
+				if (size<= max_degree && size <= length)
 					size++;
-				}
+
 				// Mulitply by x the rows of Sigma involved as pivot in LQUP
 				for (size_t i=0;i<n;++i){
-					for (int j= (int) size-2;j>=0; --j){
-						for (size_t l=0;l<m;++l)
-							//BB: #warning Q[i] pour i>r ne veut rien dire...
-							field().assign(SigmaBase[(size_t)j+1].refEntry(*(Qt.getPointer()+i),l),
-								  SigmaBase[(size_t)j].getEntry(*(Qt.getPointer()+i),l));
-					}
-					for (size_t l=0;l<m;++l)
-						field().assign(SigmaBase[0].refEntry(*(Qt.getPointer()+i),l),field().zero);
+					//BB: #warning Q[i] pour i>r ne veut rien dire...
+					typename std::vector<Element>::iterator row=Sigma.begin()+(*(Qt.getPointer()+i))*ld;
+					std::copy_backward(row, row+m*(size-1), row+m*size);
+					std::fill(row, row+m, field().zero);
 				}
 #ifdef  _BM_TIMING
 				chrono.stop();
@@ -655,10 +645,65 @@ namespace LinBox
 				chrono.clear();
 				chrono.start();
 #endif
-				//write_maple("SS1",SigmaBase);
 			}
+
+			// copy out the coefficients
+			SigmaBase.resize(size,Zero);
+			for (size_t j=0;j<size;++j)
+				for (size_t i=0;i<m;++i)
+					std::copy(Sigma.begin()+i*ld+j*m, Sigma.begin()+i*ld+(j+1)*m,
+						  SigmaBase[j].getWritePointer()+i*SigmaBase[j].getStride());
+		}
+
+	private:
+
+		size_t numThreads(size_t work) const
+		{
+#ifdef __LINBOX_USE_OPENMP
+			if (work >= SIGMA_BASIS_THREAD_THRESHOLD)
+				return (size_t) omp_get_max_threads();
+#endif
+			return 1;
+		}
+
+		// D = [Sigma_0 ... Sigma_size-1] . [S_0; ...; S_size-1], with one product per
+		// range of coefficients (Partial holds the products of the other ranges)
+		void discrepancy(Coefficient &D, const Element *Sigma, size_t ld, const Element *S,
+				 size_t m, size_t n, size_t size, std::vector<Element> &Partial)
+		{
+			size_t nt = std::min(size, numThreads(m*m*n*size));
+			if (nt == 1) {
+				FFLAS::fgemm(field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans, m, n, m*size,
+					     field().one, Sigma, ld, S, n, field().zero, D.getWritePointer(), D.getStride());
+				return;
+			}
+			Partial.resize((nt-1)*m*n);
+#pragma omp parallel for num_threads(nt) schedule(static)
+			for (index_t t = 0; t < (index_t)nt; ++t) {
+				size_t j0 = (size_t)t*size/nt, j1 = ((size_t)t+1)*size/nt;
+				Element *R = (t == 0) ? D.getWritePointer() : Partial.data()+((size_t)t-1)*m*n;
+				size_t  ldr = (t == 0) ? D.getStride() : n;
+				FFLAS::fgemm(field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans, m, n, m*(j1-j0),
+					     field().one, Sigma+j0*m, ld, S+j0*m*n, n, field().zero, R, ldr);
+			}
+			for (size_t t = 1; t < nt; ++t)
+				FFLAS::faddin(field(), m, n, Partial.data()+(t-1)*m*n, n, D.getWritePointer(), D.getStride());
 		}
 
+		// [Sigma_0 ... Sigma_size-1] = L^-1 [Sigma_0 ... Sigma_size-1], by ranges of coefficients
+		void solveL(const TriangularBlasMatrix<Field> &L, Element *Sigma, size_t ld, size_t m, size_t size)
+		{
+			size_t nt = std::min(size, numThreads(m*m*m*size));
+#pragma omp parallel for num_threads(nt) schedule(static) if(nt > 1)
+			for (index_t t = 0; t < (index_t)nt; ++t) {
+				size_t j0 = (size_t)t*size/nt, j1 = ((size_t)t+1)*size/nt;
+				FFLAS::ftrsm(field(), FFLAS::FflasLeft, FFLAS::FflasLower, FFLAS::FflasNoTrans, FFLAS::FflasUnit,
+					     m, m*(j1-j0), field().one, L.getPointer(), L.getStride(), Sigma+j0*m, ld);
+			}
+		}
+
+	public:
+
 
 		// Multiply a Power Serie by a Sigma Base.
 		// only affect coefficients of the Power Serie between degree1 and degree1+degree2
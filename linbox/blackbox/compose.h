@@ -32,6 +32,9 @@
 #include "linbox/linbox-config.h"
 #include "linbox/blackbox/blackbox-interface.h"
 #include "linbox/vector/blas-vector.h"
+#include "linbox/vector/vector-traits.h"
+#include "linbox/matrix/sparse-formats.h"
+#include "linbox/util/field-axpy.h"
 
 namespace LinBox
 {
@@ -40,6 +43,258 @@ namespace LinBox
 
 	template <class _Blackbox1, class _Blackbox2 = _Blackbox1>
 	class ComposeOwner;
+
+	template<class Field, class Trait>
+	class Diagonal;
+
+	template <class Field_>
+	class ScalarMatrix;
+
+	template<class _Field, class _Matrix>
+	class Permutation;
+
+	template<class _Field, class _Storage>
+	class SparseMatrix;
+}
+
+namespace LinBox
+{
+	/// Structure of a factor of a product, as seen by Compose.
+	namespace ComposeFactorTag {
+		struct Generic {} ;     //!< only apply/applyTranspose
+		struct Diagonal {} ;    //!< \f$y_i = d_i x_i\f$, entries in getData()
+		struct Scalar {} ;      //!< \f$y = s x\f$, getScalar()
+		struct Permutation {} ; //!< \f$y_i = x_{p_i}\f$, p_i given by operator[]
+		struct SparseCSR {} ;   //!< getStart/getEnd/getColid/getData
+	}
+
+	/** Tags the blackboxes whose structure Compose may exploit.
+	 * Unknown blackboxes are Generic, and they are applied through the
+	 * intermediate vector as before.
+	 */
+	template <class Blackbox>
+	struct ComposeFactorTraits {
+		typedef ComposeFactorTag::Generic category;
+	};
+
+	template <class Field>
+	struct ComposeFactorTraits<Diagonal<Field, VectorCategories::DenseVectorTag> > {
+		typedef ComposeFactorTag::Diagonal category;
+	};
+
+	template <class Field>
+	struct ComposeFactorTraits<ScalarMatrix<Field> > {
+		typedef ComposeFactorTag::Scalar category;
+	};
+
+	template <class Field, class Matrix>
+	struct ComposeFactorTraits<Permutation<Field, Matrix> > {
+		typedef ComposeFactorTag::Permutation category;
+	};
+
+	template <class Field>
+	struct ComposeFactorTraits<SparseMatrix<Field, SparseMatrixFormat::CSR> > {
+		typedef ComposeFactorTag::SparseCSR category;
+	};
+
+	/** Applies of \f$AB\f$, fused according to the factor tags.
+	 *
+	 * - a diagonal or scalar factor on the output side is applied in
+	 *   place on \p y, after the other factor wrote it;
+	 * - a CSR matrix followed by a diagonal or a permutation is applied in
+	 *   one pass, the diagonal scaling the values (resp. the permutation
+	 *   the column indices) on the fly.
+	 *
+	 * Hence \f$D_1 A D_2\f$, with \f$A\f$ in CSR, needs no intermediate
+	 * vector at all.  Other cases go through \p z.
+	 */
+	template <class Blackbox1, class Blackbox2>
+	struct ComposeFused {
+		typedef typename ComposeFactorTraits<Blackbox1>::category Tag1;
+		typedef typename ComposeFactorTraits<Blackbox2>::category Tag2;
+
+		/// y = A (B x)
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+					 const InVector& x, TmpVector& z)
+		{
+			return apply (y, A, B, x, z, Tag1(), Tag2());
+		}
+
+		/// y = B^T (A^T x)
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& applyTranspose (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+						  const InVector& x, TmpVector& z)
+		{
+			return applyTranspose (y, A, B, x, z, Tag1(), Tag2());
+		}
+
+	private:
+
+		template <class Vect, class Blackbox>
+		static Vect& scaleIn (Vect& y, const Blackbox& D, ComposeFactorTag::Diagonal)
+		{
+			const typename Blackbox::Field & F = D.field();
+			const typename Blackbox::Vector_t & d = D.getData();
+			for (size_t i = 0; i < D.rowdim(); ++i)
+				F.mulin (y[i], d[i]);
+			return y;
+		}
+
+		template <class Vect, class Blackbox>
+		static Vect& scaleIn (Vect& y, const Blackbox& S, ComposeFactorTag::Scalar)
+		{
+			const typename Blackbox::Field & F = S.field();
+			typename Blackbox::Element s;
+			F.init (s);
+			S.getScalar (s);
+			if (F.isOne (s))
+				return y;
+			// y has the size of the other factor's output, not of S
+			for (size_t i = 0; i < y.size(); ++i)
+				F.mulin (y[i], s);
+			return y;
+		}
+
+		// generic: through z
+		template <class OutVector, class InVector, class TmpVector, class T1, class T2>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+					 const InVector& x, TmpVector& z, T1, T2)
+		{
+			B.apply (z, x);
+			return A.apply (y, z);
+		}
+
+		// left diagonal or scalar: scale B x in place
+		template <class OutVector, class InVector, class TmpVector, class T2>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+					 const InVector& x, TmpVector&, ComposeFactorTag::Diagonal, T2)
+		{
+			B.apply (y, x);
+			return scaleIn (y, A, Tag1());
+		}
+
+		template <class OutVector, class InVector, class TmpVector, class T2>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+					 const InVector& x, TmpVector&, ComposeFactorTag::Scalar, T2)
+		{
+			B.apply (y, x);
+			return scaleIn (y, A, Tag1());
+		}
+
+		// right scalar commutes: scale A x in place
+		template <class OutVector, class InVector, class TmpVector, class T1>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+					 const InVector& x, TmpVector&, T1, ComposeFactorTag::Scalar)
+		{
+			A.apply (y, x);
+			return scaleIn (y, B, Tag2());
+		}
+
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+					 const InVector& x, TmpVector&, ComposeFactorTag::Diagonal, ComposeFactorTag::Scalar)
+		{
+			B.apply (y, x);
+			return scaleIn (y, A, Tag1());
+		}
+
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+					 const InVector& x, TmpVector&, ComposeFactorTag::Scalar, ComposeFactorTag::Scalar)
+		{
+			B.apply (y, x);
+			return scaleIn (y, A, Tag1());
+		}
+
+		// CSR times diagonal: y_i = sum_k a_ik (d_k x_k)
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& D,
+					 const InVector& x, TmpVector&, ComposeFactorTag::SparseCSR, ComposeFactorTag::Diagonal)
+		{
+			typedef typename Blackbox1::Field Field;
+			const Field & F = A.field();
+			const typename Blackbox2::Vector_t & d = D.getData();
+			typename Field::Element t;
+			F.init (t);
+			FieldAXPY<Field> accu (F);
+			for (size_t i = 0; i < A.rowdim(); ++i) {
+				accu.reset();
+				for (size_t k = A.getStart(i); k < (size_t)A.getEnd(i); ++k) {
+					const size_t j = A.getColid(k);
+					accu.mulacc (A.getData(k), F.mul (t, d[j], x[j]));
+				}
+				accu.get (y[i]);
+			}
+			return y;
+		}
+
+		// CSR times permutation: y_i = sum_k a_ik x_{p_k}
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& apply (OutVector& y, const Blackbox1& A, const Blackbox2& P,
+					 const InVector& x, TmpVector&, ComposeFactorTag::SparseCSR, ComposeFactorTag::Permutation)
+		{
+			FieldAXPY<typename Blackbox1::Field> accu (A.field());
+			for (size_t i = 0; i < A.rowdim(); ++i) {
+				accu.reset();
+				for (size_t k = A.getStart(i); k < (size_t)A.getEnd(i); ++k)
+					accu.mulacc (A.getData(k), x[P[A.getColid(k)]]);
+				accu.get (y[i]);
+			}
+			return y;
+		}
+
+		// generic: through z
+		template <class OutVector, class InVector, class TmpVector, class T1, class T2>
+		static OutVector& applyTranspose (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+						  const InVector& x, TmpVector& z, T1, T2)
+		{
+			A.applyTranspose (z, x);
+			return B.applyTranspose (y, z);
+		}
+
+		// right diagonal or scalar (symmetric): scale A^T x in place
+		template <class OutVector, class InVector, class TmpVector, class T1>
+		static OutVector& applyTranspose (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+						  const InVector& x, TmpVector&, T1, ComposeFactorTag::Diagonal)
+		{
+			A.applyTranspose (y, x);
+			return scaleIn (y, B, Tag2());
+		}
+
+		template <class OutVector, class InVector, class TmpVector, class T1>
+		static OutVector& applyTranspose (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+						  const InVector& x, TmpVector&, T1, ComposeFactorTag::Scalar)
+		{
+			A.applyTranspose (y, x);
+			return scaleIn (y, B, Tag2());
+		}
+
+		// left scalar commutes: scale B^T x in place
+		template <class OutVector, class InVector, class TmpVector, class T2>
+		static OutVector& applyTranspose (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+						  const InVector& x, TmpVector&, ComposeFactorTag::Scalar, T2)
+		{
+			B.applyTranspose (y, x);
+			return scaleIn (y, A, Tag1());
+		}
+
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& applyTranspose (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+						  const InVector& x, TmpVector&, ComposeFactorTag::Scalar, ComposeFactorTag::Diagonal)
+		{
+			A.applyTranspose (y, x);
+			return scaleIn (y, B, Tag2());
+		}
+
+		template <class OutVector, class InVector, class TmpVector>
+		static OutVector& applyTranspose (OutVector& y, const Blackbox1& A, const Blackbox2& B,
+						  const InVector& x, TmpVector&, ComposeFactorTag::Scalar, ComposeFactorTag::Scalar)
+		{
+			A.applyTranspose (y, x);
+			return scaleIn (y, B, Tag2());
+		}
+	};
 }
 
 
@@ -142,10 +397,8 @@ namespace LinBox
 		template <class OutVector, class InVector>
 		inline OutVector& apply (OutVector& y, const InVector& x) const
 		{
-			if ((_A_ptr != 0) && (_B_ptr != 0)) {
-				_B_ptr->apply (_z, x);
-				_A_ptr->apply (y, _z);
-			}
+			if ((_A_ptr != 0) && (_B_ptr != 0))
+				ComposeFused<Blackbox1, Blackbox2>::apply (y, *_A_ptr, *_B_ptr, x, _z);
 
 			return y;
 		}
@@ -160,10 +413,8 @@ namespace LinBox
 		template <class OutVector, class InVector>
 		inline OutVector& applyTranspose (OutVector& y, const InVector& x) const
 		{
-			if ((_A_ptr != 0) && (_B_ptr != 0)) {
-				_A_ptr->applyTranspose (_z, x);
-				_B_ptr->applyTranspose (y, _z);
-			}
+			if ((_A_ptr != 0) && (_B_ptr != 0))
+				ComposeFused<Blackbox1, Blackbox2>::applyTranspose (y, *_A_ptr, *_B_ptr, x, _z);
 
 			return y;
 		}
@@ -531,7 +782,7 @@ namespace LinBox
 		template <class OutVector, class InVector>
 		inline OutVector& apply (OutVector& y, const InVector& x) const
 		{
-			return _A_data.apply (y, _B_data.apply (_z, x));
+			return ComposeFused<Blackbox1, Blackbox2>::apply (y, _A_data, _B_data, x, _z);
 		}
 
 		/** row vector * matrix product \f$y= (A \times B)^T \cdot x\f$.
@@ -543,7 +794,7 @@ namespace LinBox
 		template <class OutVector, class InVector>
 		inline OutVector& applyTranspose (OutVector& y, const InVector& x) const
 		{
-			return _B_data.applyTranspose (y, _A_data.applyTranspose (_z, x));
+			return ComposeFused<Blackbox1, Blackbox2>::applyTranspose (y, _A_data, _B_data, x, _z);
 		}
 
 		template<typename _Tp1, typename _Tp2 = _Tp1>
@@ -0,0 +1,263 @@
+/* linbox/blackbox/multimod-sparse.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/multimod-sparse.h
+ * @ingroup blackbox
+ * @brief Sparse integer matrix applied modulo several primes at once.
+ */
+
+#ifndef __LINBOX_blackbox_multimod_sparse_H
+#define __LINBOX_blackbox_multimod_sparse_H
+
+#include "linbox/linbox-config.h"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "linbox/util/debug.h"
+#include "linbox/integer.h"
+#include "linbox/field/multimod-field.h"
+#include "linbox/blackbox/blackbox-interface.h"
+
+namespace LinBox
+{
+
+	/** \brief Sparse matrix with small integer entries over a MultiModDouble.
+	 * \ingroup blackbox
+	 *
+	 * The integer CRA algorithms rebind their blackbox to each prime,
+	 * reading and reducing every nonzero once by prime. This blackbox
+	 * stores the integer entries once (CSR, as doubles) and applies them
+	 * modulo the k primes of a MultiModDouble in a single pass over the
+	 * nonzeros: each nonzero is multiplied with the residues of its
+	 * column, a contiguous loop across the (padded) primes that the
+	 * compiler vectorizes. The products are accumulated unreduced as long
+	 * as they stay below 2^52 and reduced by blocks, with
+	 * VectorSIMD::reduceLanes.
+	 *
+	 * The vectors of residues are either vectors of
+	 * MultiModDouble::Element (apply, applyTranspose) or row major
+	 * n x s arrays, s = F.paddedSize(), the residues of x_j being
+	 * x[j*s..j*s+s-1] (applyRNS, applyTransposeRNS), which avoids the
+	 * packing.
+	 *
+	 * changeField() sets new primes without reading the matrix again,
+	 * which is how ChineseRemainderMultiMod uses it: one matrix, k new
+	 * primes by pass.
+	 */
+	class MultiModSparseMatrix : public BlackboxInterface {
+	public:
+		typedef MultiModDouble                Field;
+		typedef MultiModDouble::Element     Element;
+		typedef MultiModSparseMatrix         Self_t;
+
+		/** Reads the nonzeros of the integer matrix A.
+		 * @param F  the primes, < 2^26.5 (see MultiModDouble)
+		 * @param A  a matrix over the integers with a ConstIndexedIterator
+		 *           (the SparseMatrix formats), with entries of absolute
+		 *           value a such that a (p-1) < 2^52 for the primes p of F.
+		 */
+		template<class IMatrix>
+		MultiModSparseMatrix (const MultiModDouble &F, const IMatrix &A) :
+			_m(A.rowdim()), _n(A.coldim()), _start(A.rowdim()+1, 0), _amax(0)
+		{
+			std::vector<size_t> rows;
+			std::vector<double> vals;
+			const integer bound = (uint64_t)1 << 52;
+			integer v;
+			for (typename IMatrix::ConstIndexedIterator it = A.IndexedBegin(); it != A.IndexedEnd(); ++it) {
+				A.field().convert(v, it.value());
+				if (v == 0) continue;
+				if (v >= bound || v <= -bound)
+					throw PreconditionFailed(LB_FILE_LOC, "MultiModSparseMatrix: the entries must be small integers");
+				rows.push_back(it.rowIndex());
+				_colid.push_back(it.colIndex());
+				vals.push_back((double)v);
+				_amax = std::max(_amax, std::fabs(vals.back()));
+			}
+			// counting sort by row
+			for (size_t t = 0; t < rows.size(); ++t)
+				++_start[rows[t]+1];
+			for (size_t i = 0; i < _m; ++i)
+				_start[i+1] += _start[i];
+			std::vector<size_t> pos(_start.begin(), _start.end()-1), col(_colid.size());
+			_data.resize(vals.size());
+			for (size_t t = 0; t < rows.size(); ++t) {
+				size_t q = pos[rows[t]]++;
+				col[q] = _colid[t];
+				_data[q] = vals[t];
+			}
+			_colid.swap(col);
+			changeField(F);
+		}
+
+		MultiModSparseMatrix (const MultiModSparseMatrix &B) :
+			_field(B._field), _m(B._m), _n(B._n),
+			_start(B._start), _colid(B._colid), _data(B._data), _amax(B._amax),
+			_k(B._k), _stride(B._stride), _block(B._block)
+		{}
+
+		/** Applies the matrix modulo the primes of F from now on.
+		 * The integer entries are kept: no pass over the integer matrix.
+		 */
+		void changeField (const MultiModDouble &F)
+		{
+			_field = &F;
+			_k = F.size();
+			_stride = F.paddedSize();
+			double pmax = 2;
+			for (size_t l = 0; l < _k; ++l)
+				pmax = std::max(pmax, (double)F.getModulo(l));
+			// |y| < p + t amax (p-1) <= 2^52 after t unreduced products
+			double b = std::floor((std::ldexp(1., 52) - pmax) / (std::max(_amax, 1.) * (pmax - 1)));
+			if (b < 1)
+				throw PreconditionFailed(LB_FILE_LOC, "MultiModSparseMatrix: entries too large for these primes");
+			_block = (b > (double)_data.size()) ? _data.size() + 1 : (size_t)b;
+		}
+
+		/** y = A x modulo the k primes, y and x row major arrays of residues.
+		 * x must be reduced (in [0,p)), y is.
+		 */
+		double *applyRNS (double *y, const double *x) const
+		{
+			const size_t k = _stride;
+			for (size_t i = 0; i < _m; ++i) {
+				double *yi = y + i * k;
+				std::fill(yi, yi + k, 0.);
+				size_t c = 0;
+				for (size_t t = _start[i]; t < _start[i+1]; ++t) {
+					const double a = _data[t];
+					const double *xj = x + _colid[t] * k;
+					for (size_t l = 0; l < k; ++l)
+						yi[l] += a * xj[l];
+					if (++c == _block) {
+						reduce(yi);
+						c = 0;
+					}
+				}
+				reduce(yi);
+			}
+			return y;
+		}
+
+		/// y = A^T x modulo the k primes, as applyRNS
+		double *applyTransposeRNS (double *y, const double *x) const
+		{
+			const size_t k = _stride;
+			std::fill(y, y + _n * k, 0.);
+			std::vector<size_t> c(_n, 0);
+			for (size_t i = 0; i < _m; ++i) {
+				const double *xi = x + i * k;
+				for (size_t t = _start[i]; t < _start[i+1]; ++t) {
+					const double a = _data[t];
+					double *yj = y + _colid[t] * k;
+					for (size_t l = 0; l < k; ++l)
+						yj[l] += a * xi[l];
+					if (++c[_colid[t]] == _block) {
+						reduce(yj);
+						c[_colid[t]] = 0;
+					}
+				}
+			}
+			for (size_t j = 0; j < _n; ++j)
+				reduce(y + j * k);
+			return y;
+		}
+
+		/** y = A x, for vectors of MultiModDouble::Element.
+		 * The residues are packed in arrays for applyRNS.
+		 */
+		template<class OutVector, class InVector>
+		OutVector &apply (OutVector &y, const InVector &x) const
+		{
+			std::vector<double> X(_n * _stride), Y(_m * _stride);
+			pack(X, x, _n);
+			applyRNS(Y.data(), X.data());
+			return unpack(y, Y, _m);
+		}
+
+		/// y = A^T x, for vectors of MultiModDouble::Element
+		template<class OutVector, class InVector>
+		OutVector &applyTranspose (OutVector &y, const InVector &x) const
+		{
+			std::vector<double> X(_m * _stride), Y(_n * _stride);
+			pack(X, x, _m);
+			applyTransposeRNS(Y.data(), X.data());
+			return unpack(y, Y, _n);
+		}
+
+		size_t rowdim () const { return _m; }
+		size_t coldim () const { return _n; }
+		size_t size () const { return _data.size(); }
+		const Field &field () const { return *_field; }
+
+		/// number of primes of the field
+		size_t nbPrimes () const { return _k; }
+
+	protected:
+		/// y[l] mod p_l in [0,p_l), for |y[l]| <= 2^52
+		inline void reduce (double *y) const
+		{
+			VectorSIMD::reduceLanes(y, y, _field->moduli(), _field->invModuli(), _stride);
+		}
+
+		template<class InVector>
+		void pack (std::vector<double> &X, const InVector &x, size_t n) const
+		{
+			linbox_check(x.size() == n);
+			for (size_t j = 0; j < n; ++j)
+				for (size_t l = 0; l < _k; ++l)
+					X[j * _stride + l] = x[j][l];
+		}
+
+		template<class OutVector>
+		OutVector &unpack (OutVector &y, const std::vector<double> &Y, size_t n) const
+		{
+			linbox_check(y.size() == n);
+			for (size_t i = 0; i < n; ++i)
+				y[i].assign(Y.begin() + i * _stride, Y.begin() + (i+1) * _stride);
+			return y;
+		}
+
+		const MultiModDouble *_field;
+		size_t                   _m;
+		size_t                   _n;
+		std::vector<size_t>  _start;
+		std::vector<size_t>  _colid;
+		std::vector<double>   _data; //!< the integer entries
+		double                _amax; //!< max of their absolute values
+		size_t                   _k; //!< number of primes
+		size_t              _stride; //!< residues by entry of the vectors, k padded
+		size_t               _block; //!< products accumulated before a reduction
+	};
+
+} // LinBox
+
+#endif // __LINBOX_blackbox_multimod_sparse_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
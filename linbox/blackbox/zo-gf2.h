@@ -28,6 +28,8 @@
 #define __LINBOX_zo_gf2_H
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
 #include "linbox/blackbox/zero-one.h"
 #include "linbox/field/gf2.h"
 #include <givaro/zring.h>
@@ -57,27 +59,27 @@ namespace LinBox
 		const GF2 *_field;
 
 		ZeroOne(const GF2& ) :
-			_nnz(0)
+			_nnz(0), _colIndexed(false), _colIndexValid(false)
 		{}
 		ZeroOne(const GF2& , const size_t m) :
-			Father_t(m), _rowdim(m), _coldim(m),_nnz(0)
+			Father_t(m), _rowdim(m), _coldim(m),_nnz(0), _colIndexed(false), _colIndexValid(false)
 		{}
 		ZeroOne(const GF2& , const size_t m, const size_t n) :
-			Father_t(m), _rowdim(m), _coldim(n),_nnz(0)
+			Father_t(m), _rowdim(m), _coldim(n),_nnz(0), _colIndexed(false), _colIndexValid(false)
 		{}
 
 		ZeroOne():
-			_nnz(0)
+			_nnz(0), _colIndexed(false), _colIndexValid(false)
 		{}
 		ZeroOne(const size_t m) :
-			Father_t(m), _rowdim(m), _coldim(m),_nnz(0)
+			Father_t(m), _rowdim(m), _coldim(m),_nnz(0), _colIndexed(false), _colIndexValid(false)
 		{}
 		ZeroOne(const size_t m, const size_t n) :
-			Father_t(m), _rowdim(m), _coldim(n),_nnz(0)
+			Father_t(m), _rowdim(m), _coldim(n),_nnz(0), _colIndexed(false), _colIndexValid(false)
 		{}
 
 		ZeroOne(const GF2& , VectorStream<Row_t>& stream) :
-			Father_t(stream.m()), _rowdim(stream.m()), _coldim(stream.n()), _nnz(0)
+			Father_t(stream.m()), _rowdim(stream.m()), _coldim(stream.n()), _nnz(0), _colIndexed(false), _colIndexValid(false)
 		{
 			for (Father_t::iterator row=begin(); row != end(); ++row) {
 				stream >> *row;
@@ -86,12 +88,12 @@ namespace LinBox
 		}
 
 		ZeroOne(const Self_t& A) :
-			Father_t(static_cast<const Father_t&>(A)), _rowdim(A._rowdim), _coldim(A._coldim), _nnz(A._nnz)
+			Father_t(static_cast<const Father_t&>(A)), _rowdim(A._rowdim), _coldim(A._coldim), _nnz(A._nnz), _colIndexed(A._colIndexed), _colIndexValid(false)
 		{ }
 
 		ZeroOne(const GF2& , size_t* rowP, size_t* colP,
 			const size_t m, const size_t n, const size_t Nnz, const bool ,const bool) :
-			Father_t(m), _rowdim(m), _coldim(n), _nnz(Nnz)
+			Father_t(m), _rowdim(m), _coldim(n), _nnz(Nnz), _colIndexed(false), _colIndexValid(false)
 		{
 			for(size_t k=0; k<Nnz; ++k)
 				this->operator[](rowP[k]).push_back(colP[k]);
@@ -112,6 +114,27 @@ namespace LinBox
 		template<class OutVector, class InVector>
 		OutVector& applyTranspose(OutVector& y, const InVector& x) const; // y = A^T x
 
+		/** Block apply, Y = A X.
+		 * X and Y are blocks of 64 vectors packed as one uint64_t word per
+		 * row (bit k of X[j] is the j-th entry of the k-th vector).
+		 */
+		template<class OutBlock, class InBlock>
+		OutBlock& applyBlock(OutBlock& Y, const InBlock& X) const;
+
+		/// Block transpose apply, Y = A^T X, same packing as applyBlock.
+		template<class OutBlock, class InBlock>
+		OutBlock& applyTransposeBlock(OutBlock& Y, const InBlock& X) const;
+
+		/** Keep a column major index of the matrix.
+		 * When set, transposed applies are done as gathers over the
+		 * columns (in parallel for blocks) instead of scattered writes.
+		 * The index is built on the next transposed apply and reused
+		 * until setEntry or read; rows modified directly through the
+		 * container interface require a new call to indexColumns.
+		 * Concurrent transposed applies build it once.
+		 */
+		void indexColumns(bool b = true) { _colIndexed = b; invalidateColumnIndex(); }
+
 		/** Read the matrix from a stream in ANY format
 		 *  entries are read as "long int" and set to 1 if they are odd,
 		 *  0 otherwise
@@ -137,7 +160,7 @@ namespace LinBox
 
 		template<typename _Tp1>
 		ZeroOne(ZeroOne<_Tp1>& A, const GF2 F2) :
-			Father_t(A.rowdim()), _rowdim(A.rowdim()), _coldim(A.coldim()), _nnz(0)
+			Father_t(A.rowdim()), _rowdim(A.rowdim()), _coldim(A.coldim()), _nnz(0), _colIndexed(false), _colIndexValid(false)
 		{
 			for(typename ZeroOne<_Tp1>::IndexIterator it = A.indexBegin();
 			    it != A.indexEnd(); ++it,++_nnz) {
@@ -170,6 +193,30 @@ namespace LinBox
 
 	private:
 		size_t _rowdim, _coldim, _nnz;
+
+		// column major index: rows of the entries of column j are
+		// _rowIndex[_colStart[j].._colStart[j+1]-1]
+		bool _colIndexed;
+		mutable bool _colIndexValid;
+		mutable std::vector<size_t> _colStart, _rowIndex;
+
+		// once_flag of the index build, a new one after each invalidation
+		struct IndexOnce {
+			std::unique_ptr<std::once_flag> flag;
+			IndexOnce () : flag(new std::once_flag) {}
+			IndexOnce (const IndexOnce&) : flag(new std::once_flag) {}
+			IndexOnce &operator= (const IndexOnce&) { flag.reset(new std::once_flag); return *this; }
+		};
+		mutable IndexOnce _colIndexOnce;
+
+		bool columnIndex() const;
+		void buildColumnIndex() const;
+		void invalidateColumnIndex()
+		{
+			if (! _colIndexValid) return;
+			_colIndexValid = false;
+			_colIndexOnce.flag.reset(new std::once_flag);
+		}
 	};
 
 }
@@ -78,9 +78,42 @@ namespace LinBox
 	}
 #endif
 
+	inline bool ZeroOne<GF2>::columnIndex() const
+	{
+		if (! _colIndexed) return false;
+		std::call_once(*_colIndexOnce.flag, &ZeroOne<GF2>::buildColumnIndex, this);
+		return true;
+	}
+
+	inline void ZeroOne<GF2>::buildColumnIndex() const
+	{
+		_colStart.assign(_coldim+1, 0);
+		for(Self_t::const_iterator row = this->begin(); row != this->end(); ++row)
+			for(Row_t::const_iterator loc = row->begin(); loc != row->end(); ++loc)
+				++_colStart[*loc+1];
+		for(size_t j = 0; j < _coldim; ++j)
+			_colStart[j+1] += _colStart[j];
+		_rowIndex.resize(_colStart[_coldim]);
+		std::vector<size_t> fill(_colStart.begin(), _colStart.end()-1);
+		size_t i = 0;
+		for(Self_t::const_iterator row = this->begin(); row != this->end(); ++row, ++i)
+			for(Row_t::const_iterator loc = row->begin(); loc != row->end(); ++loc)
+				_rowIndex[fill[*loc]++] = i;
+		_colIndexValid = true;
+	}
+
 	template<class OutVector, class InVector>
 	inline OutVector & ZeroOne<GF2>::applyTranspose(OutVector & y, const InVector & x) const
 	{
+		if (columnIndex()) {
+			for(size_t j = 0; j < _coldim; ++j) {
+				bool tmp(false);
+				for(size_t l = _colStart[j]; l < _colStart[j+1]; ++l)
+					field().addin(tmp,x[_rowIndex[l]]);
+				y[j] = tmp;
+			}
+			return y;
+		}
 		std::fill(y.begin(),y.end(),false);
 		typename InVector::const_iterator xit = x.begin();
 		Self_t::const_iterator row = this->begin();
@@ -93,7 +126,53 @@ namespace LinBox
 	}
 
 
+	template<class OutBlock, class InBlock>
+	inline OutBlock & ZeroOne<GF2>::applyBlock(OutBlock & Y, const InBlock & X) const
+	{
+		linbox_check(Y.size() >= _rowdim);
+		linbox_check(X.size() >= _coldim);
+		const long m = (long)_rowdim;
+#pragma omp parallel for
+		for(long i = 0; i < m; ++i) {
+			const Row_t& row = this->operator[]((size_t)i);
+			uint64_t tmp(0);
+			for(Row_t::const_iterator loc = row.begin(); loc != row.end(); ++loc)
+				tmp ^= X[*loc];
+			Y[(size_t)i] = tmp;
+		}
+		return Y;
+	}
+
+	template<class OutBlock, class InBlock>
+	inline OutBlock & ZeroOne<GF2>::applyTransposeBlock(OutBlock & Y, const InBlock & X) const
+	{
+		linbox_check(Y.size() >= _coldim);
+		linbox_check(X.size() >= _rowdim);
+		if (columnIndex()) {
+			const long n = (long)_coldim;
+#pragma omp parallel for
+			for(long j = 0; j < n; ++j) {
+				uint64_t tmp(0);
+				for(size_t l = _colStart[(size_t)j]; l < _colStart[(size_t)j+1]; ++l)
+					tmp ^= X[_rowIndex[l]];
+				Y[(size_t)j] = tmp;
+			}
+			return Y;
+		}
+		std::fill(Y.begin(), Y.begin()+(long)_coldim, uint64_t(0));
+		typename InBlock::const_iterator xit = X.begin();
+		Self_t::const_iterator row = this->begin();
+		for( ; row != this->end(); ++row, ++xit) {
+			const uint64_t xi = *xit;
+			if (! xi) continue;
+			for(Row_t::const_iterator loc = row->begin(); loc != row->end(); ++loc)
+				Y[*loc] ^= xi;
+		}
+		return Y;
+	}
+
 	inline void ZeroOne<GF2>::setEntry(size_t i, size_t j, const Element& v) {
+		invalidateColumnIndex();
 		Row_t& rowi = this->operator[](i);
 		Row_t::iterator there = std::lower_bound(rowi.begin(), rowi.end(), j);
 		if (! field().isZero(v) ) {
@@ -136,6 +215,7 @@ namespace LinBox
 		MatrixStream<Givaro::ZRing<long> > S(Ints, is);
 		S.getDimensions( _rowdim, _coldim );
 		this->resize(_rowdim);
+		invalidateColumnIndex();
 		Index r, c;
 		long v;
 		_nnz = 0;
@@ -0,0 +1,483 @@
+/* linbox/field/modular-montgomery.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file field/modular-montgomery.h
+ * @ingroup field
+ * @brief Prime fields of up to 63 bits in Montgomery representation.
+ */
+
+#ifndef __LINBOX_field_modular_montgomery_H
+#define __LINBOX_field_modular_montgomery_H
+
+#include "linbox/linbox-config.h"
+#include <iostream>
+#include <random>
+#include <ctime>
+#include <cstdint>
+#include <cmath>
+
+#include "linbox/util/debug.h"
+#include "linbox/integer.h"
+#include "linbox/field/field-interface.h"
+#include "linbox/field/field-traits.h"
+#include "linbox/util/field-axpy.h"
+#include "linbox/vector/vector-domain.h"
+
+namespace LinBox
+{
+
+	class ModularMontgomery;
+	class ModularMontgomeryRandIter;
+
+	template <class Ring>
+	struct ClassifyRing;
+
+	template <>
+	struct ClassifyRing<ModularMontgomery> {
+		typedef RingCategories::ModularTag categoryTag;
+	};
+
+	/** \brief Integers modulo an odd prime p < 2^63, in Montgomery representation.
+	 * \ingroup field
+	 *
+	 * The element a is stored as the word a 2^64 mod p, so that a product
+	 * is one 64x64->128 bits multiplication and one Montgomery reduction
+	 * (two multiplications, no division). The reductions and the
+	 * additions are branch free. init() and convert() are the only
+	 * conversions between the representations: the elements of a
+	 * computation (vectors, blackboxes, FieldAXPY) stay in Montgomery form.
+	 *
+	 * FieldAXPY accumulates the 128 bits products and reduces once by dot
+	 * product, so that the sparse applies and VectorDomain cost one
+	 * multiplication and a few additions by nonzero.
+	 */
+	class ModularMontgomery : public FieldInterface {
+	public:
+		typedef uint64_t                     Element;
+		typedef uint64_t                    Residu_t;
+		typedef unsigned __int128          DoubleWord;
+		typedef ModularMontgomeryRandIter   RandIter;
+
+		Element zero, one, mOne;
+
+		/** @name Object Management
+		 */
+		//@{
+		ModularMontgomery () :
+			zero(0), one(0), mOne(0), _p(0), _pinv(0), _r2(0)
+		{}
+
+		ModularMontgomery (const integer &p, const integer &e = 1)
+		{
+			if (p < (integer)minCardinality() || p >= (integer)maxCardinality() || (p & 1) == 0)
+				throw PreconditionFailed(LB_FILE_LOC,"modulus must be an odd prime < 2^63");
+			if (e != 1)
+				throw PreconditionFailed(LB_FILE_LOC,"exponent must be 1");
+			setModulus((uint64_t)p);
+		}
+
+		ModularMontgomery (const ModularMontgomery &F) :
+			zero(F.zero), one(F.one), mOne(F.mOne), _p(F._p), _pinv(F._pinv), _r2(F._r2)
+		{}
+
+		ModularMontgomery &operator = (const ModularMontgomery &F)
+		{
+			zero = F.zero; one = F.one; mOne = F.mOne;
+			_p = F._p; _pinv = F._pinv; _r2 = F._r2;
+			return *this;
+		}
+
+		static inline uint64_t minCardinality () { return 3; }
+		static inline uint64_t maxCardinality () { return (uint64_t)1 << 63; }
+
+		inline Residu_t characteristic () const { return _p; }
+		inline Residu_t cardinality () const { return _p; }
+
+		template<class T>
+		inline T &characteristic (T &c) const { return c = (T)_p; }
+		inline integer &characteristic (integer &c) const { return c = integer(_p); }
+		inline integer &cardinality (integer &c) const { return c = integer(_p); }
+
+		/// a mod p, in Montgomery form
+		inline Element &init (Element &x) const { return x = 0; }
+
+		inline Element &init (Element &x, const integer &y) const
+		{
+			integer r = y % integer(_p);
+			if (r < 0) r += integer(_p);
+			return x = toMontgomery((uint64_t)r);
+		}
+
+		inline Element &init (Element &x, const int64_t y) const
+		{
+			int64_t r = y % (int64_t)_p;
+			return x = toMontgomery((uint64_t)(r < 0 ? r + (int64_t)_p : r));
+		}
+
+		inline Element &init (Element &x, const uint64_t y) const { return x = toMontgomery(y % _p); }
+		inline Element &init (Element &x, const int32_t y) const { return init(x, (int64_t)y); }
+		inline Element &init (Element &x, const uint32_t y) const { return init(x, (uint64_t)y); }
+		inline Element &init (Element &x, const long long y) const { return init(x, (int64_t)y); }
+		inline Element &init (Element &x, const unsigned long long y) const { return init(x, (uint64_t)y); }
+
+		/// y is truncated to an integer, reduced exactly (p need not be a double)
+		inline Element &init (Element &x, const double y) const
+		{
+			if (std::fabs(y) < 9223372036854775808.) // 2^63
+				return init(x, (int64_t)y);
+			return init(x, integer(y));
+		}
+
+		inline Element &init (Element &x, const float y) const { return init(x, (double)y); }
+
+		/// the representative in [0,p) of x
+		inline integer &convert (integer &y, const Element &x) const { return y = integer(fromMontgomery(x)); }
+		inline double &convert (double &y, const Element &x) const { return y = (double)fromMontgomery(x); }
+
+		template<class T>
+		inline T &convert (T &y, const Element &x) const { return y = (T)fromMontgomery(x); }
+
+		inline Element &assign (Element &x, const Element &y) const { return x = y; }
+		//@}
+
+		/** @name Montgomery representation
+		 */
+		//@{
+		/// a 2^64 mod p, for a < p
+		inline Element toMontgomery (const uint64_t a) const { return reduce((DoubleWord)a * _r2); }
+
+		/// a 2^-64 mod p
+		inline uint64_t fromMontgomery (const Element a) const { return reduce((DoubleWord)a); }
+
+		/** t 2^-64 mod p in [0,p), for t < p 2^64.
+		 * With m = t p^-1 mod 2^64, t - m p is divisible by 2^64 and the
+		 * result is its high word, corrected by p if it is negative.
+		 */
+		inline Element reduce (const DoubleWord t) const
+		{
+			uint64_t m = (uint64_t)t * _pinv;
+			uint64_t h = (uint64_t)(t >> 64), mh = (uint64_t)(((DoubleWord)m * _p) >> 64);
+			return fix(h - mh);
+		}
+
+		/// x in [0,p) from x in (-p,p) computed modulo 2^64
+		inline Element fix (const uint64_t x) const { return x + (_p & (0 - (x >> 63))); }
+		//@}
+
+		/** @name Arithmetic Operations
+		 */
+		//@{
+		inline bool areEqual (const Element &x, const Element &y) const { return x == y; }
+		inline bool isZero (const Element &x) const { return x == 0; }
+		inline bool isOne (const Element &x) const { return x == one; }
+		inline bool isMOne (const Element &x) const { return x == mOne; }
+		inline bool isUnit (const Element &x) const { return x != 0; }
+
+		inline Element &add (Element &x, const Element &y, const Element &z) const { return x = fix(y + z - _p); }
+		inline Element &sub (Element &x, const Element &y, const Element &z) const { return x = fix(y - z); }
+		inline Element &mul (Element &x, const Element &y, const Element &z) const { return x = reduce((DoubleWord)y * z); }
+		inline Element &neg (Element &x, const Element &y) const { return x = fix(0 - y); }
+
+		inline Element &inv (Element &x, const Element &y) const
+		{
+			// extended Euclid on the representative, back in Montgomery form
+			int64_t r0 = (int64_t)_p, r1 = (int64_t)fromMontgomery(y), u0 = 0, u1 = 1;
+			while (r1 != 0) {
+				int64_t q = r0 / r1, t;
+				t = r0 - q * r1; r0 = r1; r1 = t;
+				t = u0 - q * u1; u0 = u1; u1 = t;
+			}
+			return x = toMontgomery((uint64_t)(u0 < 0 ? u0 + (int64_t)_p : u0));
+		}
+
+		inline Element &div (Element &x, const Element &y, const Element &z) const
+		{
+			Element iz;
+			return mul(x, y, inv(iz, z));
+		}
+
+		/// r = a x + y
+		inline Element &axpy (Element &r, const Element &a, const Element &x, const Element &y) const
+		{
+			return r = reduce(mulacc((DoubleWord)y << 64, a, x));
+		}
+
+		/// r = a x - y
+		inline Element &axmy (Element &r, const Element &a, const Element &x, const Element &y) const
+		{
+			Element t;
+			return sub(r, mul(t, a, x), y);
+		}
+
+		/// r = y - a x
+		inline Element &maxpy (Element &r, const Element &a, const Element &x, const Element &y) const
+		{
+			Element t;
+			return sub(r, y, mul(t, a, x));
+		}
+
+		inline Element &addin (Element &x, const Element &y) const { return add(x, x, y); }
+		inline Element &subin (Element &x, const Element &y) const { return sub(x, x, y); }
+		inline Element &mulin (Element &x, const Element &y) const { return mul(x, x, y); }
+		inline Element &divin (Element &x, const Element &y) const { return div(x, x, y); }
+		inline Element &negin (Element &x) const { return neg(x, x); }
+		inline Element &invin (Element &x) const { return inv(x, x); }
+		inline Element &axpyin (Element &r, const Element &a, const Element &x) const { return axpy(r, a, x, r); }
+		inline Element &axmyin (Element &r, const Element &a, const Element &x) const { return axmy(r, a, x, r); }
+		inline Element &maxpyin (Element &r, const Element &a, const Element &x) const { return maxpy(r, a, x, r); }
+		//@}
+
+		/** @name Batched kernels
+		 * Elements in Montgomery form, accumulated in 128 bits and
+		 * reduced once.
+		 */
+		//@{
+		/// t + a b, with t < p 2^64 kept by subtracting p 2^64
+		inline DoubleWord mulacc (const DoubleWord t, const Element a, const Element b) const
+		{
+			DoubleWord s = t + (DoubleWord)a * b;
+			uint64_t h = (uint64_t)(s >> 64);
+			return s - ((DoubleWord)(_p & (0 - (uint64_t)(h >= _p))) << 64);
+		}
+
+		/// sum x[i] y[i]
+		inline Element dot (const Element *x, const Element *y, size_t n) const
+		{
+			DoubleWord s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				s0 = mulacc(s0, x[i], y[i]);
+				s1 = mulacc(s1, x[i+1], y[i+1]);
+				s2 = mulacc(s2, x[i+2], y[i+2]);
+				s3 = mulacc(s3, x[i+3], y[i+3]);
+			}
+			for (; i < n; ++i)
+				s0 = mulacc(s0, x[i], y[i]);
+			Element r = reduce(s0);
+			addin(r, reduce(s1));
+			addin(r, reduce(s2));
+			return addin(r, reduce(s3));
+		}
+
+		/// y <- y + a x
+		inline void axpyin (Element *y, const Element a, const Element *x, size_t n) const
+		{
+			for (size_t i = 0; i < n; ++i)
+				axpyin(y[i], a, x[i]);
+		}
+		//@}
+
+		/** @name Input/Output
+		 */
+		//@{
+		std::ostream &write (std::ostream &os) const
+		{
+			return os << "Montgomery modular field mod " << _p;
+		}
+
+		std::istream &read (std::istream &is)
+		{
+			integer p;
+			is >> p;
+			setModulus((uint64_t)p);
+			return is;
+		}
+
+		std::ostream &write (std::ostream &os, const Element &x) const
+		{
+			return os << fromMontgomery(x);
+		}
+
+		std::istream &read (std::istream &is, Element &x) const
+		{
+			integer y;
+			is >> y;
+			init(x, y);
+			return is;
+		}
+		//@}
+
+	protected:
+		void setModulus (uint64_t p)
+		{
+			_p = p;
+			// p^-1 mod 2^64 by Newton iteration, 6 bits -> 64 bits
+			_pinv = p;
+			for (int i = 0; i < 5; ++i)
+				_pinv *= 2 - p * _pinv;
+			uint64_t r = (uint64_t)(((DoubleWord)1 << 64) % p);
+			_r2 = (uint64_t)(((DoubleWord)r * r) % p);
+			zero = 0;
+			one = r;
+			mOne = p - r;
+		}
+
+		uint64_t    _p;
+		uint64_t _pinv; //!< p^-1 mod 2^64
+		uint64_t   _r2; //!< 2^128 mod p
+	};
+
+	/// uniform random elements of ModularMontgomery
+	class ModularMontgomeryRandIter {
+	public:
+		typedef ModularMontgomery::Element Element;
+
+		ModularMontgomeryRandIter (const ModularMontgomery &F, const integer & /*size*/ = 0, const uint64_t seed = 0) :
+			_field(F), _generator(seed ? seed : (uint64_t)time(NULL)),
+			_distribution(0, F.characteristic() - 1)
+		{}
+
+		ModularMontgomeryRandIter (const ModularMontgomeryRandIter &R) :
+			_field(R._field), _generator(R._generator), _distribution(R._distribution)
+		{}
+
+		Element &random (Element &a) const
+		{
+			// uniform in [0,p) is uniform in Montgomery form too
+			return a = _distribution(_generator);
+		}
+
+		const ModularMontgomery &ring () const { return _field; }
+
+	protected:
+		ModularMontgomery                                      _field;
+		mutable std::mt19937_64                            _generator;
+		mutable std::uniform_int_distribution<uint64_t> _distribution;
+	};
+
+	//! Specialization of FieldAXPY: the products are summed in 128 bits.
+	template <>
+	class FieldAXPY<ModularMontgomery> {
+	public:
+		typedef ModularMontgomery::Element       Element;
+		typedef ModularMontgomery::DoubleWord   Abnormal;
+		typedef ModularMontgomery                  Field;
+
+		FieldAXPY (const Field &F) :
+			_field (&F), _y (0)
+		{}
+
+		FieldAXPY (const FieldAXPY &faxpy) :
+			_field (faxpy._field), _y (faxpy._y)
+		{}
+
+		FieldAXPY<Field> &operator = (const FieldAXPY &faxpy)
+		{
+			_field = faxpy._field;
+			_y = faxpy._y;
+			return *this;
+		}
+
+		inline Abnormal &mulacc (const Element &a, const Element &x)
+		{
+			return _y = field().mulacc(_y, a, x);
+		}
+
+		inline Abnormal &accumulate (const Element &t)
+		{
+			// t 2^64, reduced by the Montgomery reduction of get()
+			return _y = field().mulacc(_y, t, field().one) ;
+		}
+
+		inline Element &get (Element &y)
+		{
+			return y = field().reduce(_y);
+		}
+
+		inline FieldAXPY &assign (const Element y)
+		{
+			_y = (Abnormal) y << 64;
+			return *this;
+		}
+
+		inline void reset ()
+		{
+			_y = 0;
+		}
+
+		inline const Field &field () const { return *_field; }
+
+	protected:
+		const Field *_field;
+		Abnormal         _y;
+	};
+
+	//! Specialization of DotProductDomain: batched products, one reduction.
+	template <>
+	class DotProductDomain<ModularMontgomery> : public VectorDomainBase<ModularMontgomery> {
+	public:
+		typedef ModularMontgomery::Element Element;
+		typedef ModularMontgomery::DoubleWord DoubleWord;
+
+		DotProductDomain () {}
+		DotProductDomain (const ModularMontgomery &F) :
+			VectorDomainBase<ModularMontgomery> (F)
+		{}
+
+		using VectorDomainBase<ModularMontgomery>::field;
+
+	protected:
+		template <class Vector1, class Vector2>
+		inline Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
+		{
+			const Element *x1 = VectorSIMD::typed<Element>(VectorSIMD::contiguous(v1));
+			const Element *x2 = VectorSIMD::typed<Element>(VectorSIMD::contiguous(v2));
+			if (x1 && x2)
+				return res = field().dot(x1, x2, v1.size());
+
+			DoubleWord s0 = 0, s1 = 0;
+			size_t i = 0;
+			for (; i + 2 <= v1.size(); i += 2) {
+				s0 = field().mulacc(s0, v1[i], v2[i]);
+				s1 = field().mulacc(s1, v1[i+1], v2[i+1]);
+			}
+			if (i < v1.size())
+				s0 = field().mulacc(s0, v1[i], v2[i]);
+			return field().add(res, field().reduce(s0), field().reduce(s1));
+		}
+
+		template <class Vector1, class Vector2>
+		inline Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
+		{
+			DoubleWord s0 = 0, s1 = 0;
+			size_t i = 0, n = v1.first.size();
+			for (; i + 2 <= n; i += 2) {
+				s0 = field().mulacc(s0, v1.second[i], v2[v1.first[i]]);
+				s1 = field().mulacc(s1, v1.second[i+1], v2[v1.first[i+1]]);
+			}
+			if (i < n)
+				s0 = field().mulacc(s0, v1.second[i], v2[v1.first[i]]);
+			return field().add(res, field().reduce(s0), field().reduce(s1));
+		}
+	};
+
+} // LinBox
+
+#endif // __LINBOX_field_modular_montgomery_H
+
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,:0,t0,+0,=s
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
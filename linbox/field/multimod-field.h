@@ -43,7 +43,10 @@
 #include "linbox/field/field-traits.h"
 #include "linbox/util/field-axpy.h"
 #include <cmath>
+#include <ctime>
 #include <vector>
+#include <random>
+#include <algorithm>
 
 
 
@@ -63,12 +66,27 @@ namespace LinBox
 		typedef RingCategories::ModularTag categoryTag;
 	};
 
+	/** \brief Residue number system of word size primes.
+	 *
+	 * An element is the vector of its residues modulo the k primes
+	 * (< 2^26.5). The residues are stored as a structure of arrays: the
+	 * moduli, their inverses and the residues of an element are arrays
+	 * of doubles padded to a multiple of \c lanes, the padding lanes
+	 * having modulus 1 and residue 0. Additions, subtractions,
+	 * multiplications and axpy are then computed across the primes with
+	 * the VectorSIMD::*Lanes kernels, whatever k.
+	 *
+	 * Elements must be sized by init() (paddedSize() residues).
+	 */
 	class MultiModDouble : public FieldInterface {
 
 	protected:
 
 		std::vector<Givaro::Modular<double> >              _fields;
 		size_t                                       _size;
+		size_t                                    _padsize; //!< _size rounded up to lanes
+		std::vector<double>                        _moduli; //!< p_i, 1 in the padding
+		std::vector<double>                     _invmoduli; //!< 1/p_i
 		std::vector<integer>                 _crt_constant;
 		std::vector<double >                  _crt_inverse;
 		integer                                _crt_modulo;
@@ -83,49 +101,26 @@ namespace LinBox
 		typedef std::vector<double>              Element;
 		typedef MultiModRandIter                RandIter;
 
+		/// residues of an AVX-512 register
+		static const size_t lanes = 8;
+
 		MultiModDouble () :
-		       	_size(0)
+		       	_size(0), _padsize(0)
 		{}
 
-		MultiModDouble (const std::vector<integer> &primes) :
-			_fields(primes.size()), _size(primes.size()),
-			_crt_constant(primes.size()), _crt_inverse(primes.size())
+		MultiModDouble (const std::vector<integer> &primes)
 		{
-			_crt_modulo=1;
-			for (size_t i=0; i<_size; ++i){
-				_fields[i] = ( Givaro::Modular<double> (primes[i]) );
-				_crt_modulo *= primes[i];
-			}
-			double tmp;
-			for (size_t i=0; i<_size; ++i){
-				_crt_constant[i]= _crt_modulo/(integer)primes[i];
-				_fields[i].init(tmp, _crt_constant[i]);
-				_fields[i].inv(_crt_inverse[i],tmp);
-			}
-
+			setModuli(primes);
 		}
 
-
-		MultiModDouble (const std::vector<double> &primes) :
-			_fields(primes.size()), _size(primes.size()),
-			_crt_constant(primes.size()), _crt_inverse(primes.size())
+		MultiModDouble (const std::vector<double> &primes)
 		{
-			_crt_modulo=1;
-			for (size_t i=0; i<_size; ++i){
-				_fields[i] = ( Givaro::Modular<double> (primes[i]) );
-				_crt_modulo *= primes[i];
-			}
-			double tmp;
-			for (size_t i=0; i<_size; ++i){
-				_crt_constant[i]= _crt_modulo/(integer)primes[i];
-				_fields[i].init(tmp, _crt_constant[i]);
-				_fields[i].inv(_crt_inverse[i],tmp);
-			}
+			setModuli(primes);
 		}
 
-
 		MultiModDouble(const MultiModDouble& F) :
-			_fields(F._fields), _size(F._size),
+			_fields(F._fields), _size(F._size), _padsize(F._padsize),
+			_moduli(F._moduli), _invmoduli(F._invmoduli),
 			_crt_constant(F._crt_constant), _crt_inverse(F._crt_inverse),
 			_crt_modulo(F._crt_modulo) {}
 
@@ -133,6 +128,9 @@ namespace LinBox
 		{
 			_fields       = F._fields;
 			_size         = F._size;
+			_padsize      = F._padsize;
+			_moduli       = F._moduli;
+			_invmoduli    = F._invmoduli;
 			_crt_constant = F._crt_constant;
 			_crt_modulo   = F._crt_modulo;
 			_crt_inverse  = F._crt_inverse;
@@ -143,6 +141,18 @@ namespace LinBox
 		size_t size() const
 		{return this->_size;}
 
+		/// number of residues of an element, a multiple of lanes
+		size_t paddedSize() const
+		{return this->_padsize;}
+
+		/// the paddedSize() moduli
+		const double *moduli() const
+		{return _moduli.data();}
+
+		/// their inverses, as doubles
+		const double *invModuli() const
+		{return _invmoduli.data();}
+
 		const Givaro::Modular<double>& getBase(size_t i) const
 		{ return this->_fields[i]; }
 
@@ -155,11 +165,7 @@ namespace LinBox
 
 		integer &cardinality (integer &c) const
 		{
-			c=1;
-			for (size_t i=0; i<_size; ++i){
-				c*=getModulo(i);
-			}
-			return c;
+			return c = _crt_modulo;
 		}
 
 		integer &characteristic (integer &c) const
@@ -167,26 +173,18 @@ namespace LinBox
 			return c=integer(0);
 		}
 
+		/// the integer in [0, prod p_i) of residues y, by the CRT formula
 		integer &convert (integer &x, const Element &y) const
 		{
-			x=0;
-			double tmp;
-			for (size_t i=0;i<_size; ++i){
-				_fields[i].mul(tmp, y[i], _crt_inverse[i]);
-				integer res= tmp;
-				x= x + ( res*_crt_constant[i]);
-				if (x > _crt_modulo)
-					x-= _crt_modulo;
-			}
-			return x;
-		}
-
-#if 0
-		double &convert (double &x, const Element& y) const
-		{
-			return x=y;
+			linbox_check(y.size() >= _size);
+			// t_i = y_i (M/p_i)^-1 mod p_i for all i at once, then x = sum t_i M/p_i mod M
+			Element t(_padsize);
+			VectorSIMD::mulLanes(t.data(), y.data(), _crt_inverse.data(), moduli(), invModuli(), _size);
+			x = 0;
+			for (size_t i=0;i<_size; ++i)
+				Integer::axpyin(x, _crt_constant[i], (uint64_t)t[i]);
+			return x %= _crt_modulo;
 		}
-#endif
 
 		std::ostream &write (std::ostream &os) const
 		{
@@ -211,9 +209,9 @@ namespace LinBox
 		std::ostream &write (std::ostream &os, const Element &x) const
 		{
 			os<<"(";
-			for (size_t i=0;i<x.size()-1;++i)
+			for (size_t i=0;i<_size-1;++i)
 				os<<x[i]<<",";
-			os<<x[x.size()-1]<<")\n";
+			os<<x[_size-1]<<")\n";
 			return os;
 		}
 
@@ -227,7 +225,7 @@ namespace LinBox
 
 
 		Element &init (Element &x, const integer &y) const  {
-			x.resize(_size);
+			x.assign(_padsize, 0.);
 			for (size_t i=0;i<_size; ++i)
 				_fields[i].init(x[i], y);
 			return x;
@@ -235,9 +233,15 @@ namespace LinBox
 
 		inline Element& init(Element& x, double y =0) const
 		{
-			x.resize(_size);
-			for (size_t i=0;i<_size; ++i)
-				_fields[i].init(x[i], y);
+			x.assign(_padsize, 0.);
+			if (std::fabs(y) <= 4503599627370496.) { // 2^52
+				for (size_t i=0;i<_size; ++i)
+					x[i] = y;
+				VectorSIMD::reduceLanes(x.data(), x.data(), moduli(), invModuli(), _padsize);
+			}
+			else
+				for (size_t i=0;i<_size; ++i)
+					_fields[i].init(x[i], y);
 			return x;
 		}
 
@@ -251,66 +255,68 @@ namespace LinBox
 
 		inline bool areEqual (const Element &x, const Element &y) const
 		{
-			return x == y;
+			return std::equal(x.begin(), x.begin()+_size, y.begin());
 		}
 
 		inline  bool isZero (const Element &x) const
 		{
-			return x == std::vector<double> (_size, 0.);
+			for (size_t i=0;i<_size;++i)
+				if (x[i] != 0.) return false;
+			return true;
 		}
 
 		inline bool isOne (const Element &x) const
 		{
-			return x == std::vector<double>(_size, 1.);
+			for (size_t i=0;i<_size;++i)
+				if (x[i] != 1.) return false;
+			return true;
 		}
 
 		inline bool isMOne (const Element &x) const
 		{
-			return x == std::vector<double>(_size, -1.); // bug
+			for (size_t i=0;i<_size;++i)
+				if (x[i] != _moduli[i]-1) return false;
+			return true;
 		}
 
 		inline Element &add (Element &x, const Element &y, const Element &z) const
 		{
-			for (size_t i=0;i<_size;++i) {
-				_fields[i].add(x[i], y[i], z[i]);
-			}
+			linbox_check(x.size() >= _padsize && y.size() >= _padsize && z.size() >= _padsize);
+			VectorSIMD::addLanes(x.data(), y.data(), z.data(), moduli(), _padsize);
 			return x;
 		}
 
 		inline Element &sub (Element &x, const Element &y, const Element &z) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].sub(x[i], y[i], z[i]);
-			}
+			linbox_check(x.size() >= _padsize && y.size() >= _padsize && z.size() >= _padsize);
+			VectorSIMD::subLanes(x.data(), y.data(), z.data(), moduli(), _padsize);
 			return x;
 		}
 
 		inline Element &mul (Element &x, const Element &y, const Element &z) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].mul(x[i], y[i], z[i]);
-			}
+			linbox_check(x.size() >= _padsize && y.size() >= _padsize && z.size() >= _padsize);
+			VectorSIMD::mulLanes(x.data(), y.data(), z.data(), moduli(), invModuli(), _padsize);
 			return x;
 		}
 
 		inline Element &div (Element &x, const Element &y, const Element &z) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].div(x[i], y[i], z[i]);
-			}
-			return x;
+			Element iz(_padsize);
+			return mul(x, y, inv(iz, z));
 		}
 
 		inline Element &neg (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].neg(x[i], y[i]);
-			}
+			linbox_check(x.size() >= _padsize && y.size() >= _padsize);
+			VectorSIMD::negLanes(x.data(), y.data(), moduli(), _padsize);
 			return x;
 		}
 
+		// the inverses are computed prime by prime (extended gcd)
 		inline Element &inv (Element &x, const Element &y) const
 		{
+			linbox_check(x.size() >= _size && y.size() >= _size);
 			for (size_t i=0;i<_size;++i){
 				_fields[i].inv(x[i], y[i]);
 			}
@@ -322,73 +328,81 @@ namespace LinBox
 				      const Element &x,
 				      const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].axpy(r[i], a[i], x[i], y[i]);
-			}				\
+			linbox_check(r.size() >= _padsize && a.size() >= _padsize && x.size() >= _padsize && y.size() >= _padsize);
+			VectorSIMD::axpyLanes(r.data(), a.data(), x.data(), y.data(), moduli(), invModuli(), _padsize);
 			return r;
 		}
 
 		inline Element &addin (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].addin(x[i], y[i]);
-			}
-			return x;
+			return add(x, x, y);
 		}
 
 		inline Element &subin (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].subin(x[i], y[i]);
-			}
-			return x;
+			return sub(x, x, y);
 		}
 
 		inline Element &mulin (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].mulin(x[i], y[i]);
-			}
-			return x;
+			return mul(x, x, y);
 		}
 
 		inline Element &divin (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].divin(x[i], y[i]);
-			}
-			return x;
+			return div(x, x, y);
 		}
 
 		inline Element &negin (Element &x) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].negin(x[i]);
-			}
-			return x;
+			return neg(x, x);
 		}
 
 		inline Element &invin (Element &x) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].invin(x[i]);
-			}
-			return x;
+			return inv(x, x);
 		}
 
 		inline Element &axpyin (Element &r, const Element &a, const Element &x) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].axpyin(r[i], a[i], x[i]);
-			}
-			return r;
+			return axpy(r, a, x, r);
 		}
 
 		static inline double maxCardinality()
 		{ return 94906265.0; } // floor( 2^26.5 )
 
+	protected:
+		template<class Vect>
+		void setModuli (const Vect &primes)
+		{
+			_size = primes.size();
+			_padsize = ((_size + lanes - 1) / lanes) * lanes;
+			_fields.resize(_size);
+			_moduli.assign(_padsize, 1.);
+			_invmoduli.assign(_padsize, 1.);
+			_crt_constant.resize(_size);
+			_crt_inverse.assign(_padsize, 0.);
+			_crt_modulo=1;
+			for (size_t i=0; i<_size; ++i){
+				_fields[i] = ( Givaro::Modular<double> (primes[i]) );
+				_moduli[i] = (double)getModulo(i);
+				_invmoduli[i] = 1./_moduli[i];
+				_crt_modulo *= primes[i];
+			}
+			double tmp;
+			for (size_t i=0; i<_size; ++i){
+				_crt_constant[i]= _crt_modulo/(integer)primes[i];
+				_fields[i].init(tmp, _crt_constant[i]);
+				_fields[i].inv(_crt_inverse[i],tmp);
+			}
+		}
+
 	};// end of class MultiModField
 
+	/** \brief Random elements of MultiModDouble.
+	 * One generator draws uniform doubles of [0,1) for all the primes,
+	 * which are scaled to residues across the lanes.
+	 */
 	class MultiModRandIter {
 
 	public:
@@ -398,32 +412,34 @@ namespace LinBox
 		MultiModRandIter(const MultiModDouble &F,
 				 const integer   &size=0,
 				 const size_t   &seed=0) :
-			_field(F), _size(size), _seed(seed), _randiter(F._size)
-		{
-			for (size_t i=0;i< F._size;++i)
-				_randiter[i] = new Givaro::Modular<double>::RandIter(F._fields[i],seed) ;
-		}
+			_field(F), _size(size), _seed(seed ? seed : (size_t)time(NULL)),
+			_generator(_seed), _unit(F.paddedSize(), 0.)
+		{}
 
-		~MultiModRandIter()
-		{
-			for (size_t i=0;i< _randiter.size();++i) 
-				if (_randiter[i])
-					delete _randiter[i];
-		}
+		MultiModRandIter(const MultiModRandIter &R) :
+			_field(R._field), _size(R._size), _seed(R._seed),
+			_generator(R._generator), _unit(R._unit)
+		{}
 
 		MultiModRandIter& operator= (const MultiModRandIter &R)
 		{
 			_seed  = R._seed;
 			_size  = R._size;
 			_field = R._field;
-			_randiter = R._randiter;
+			_generator = R._generator;
+			_unit = R._unit;
 			return *this;
 		}
 
 		std::vector<double>& random(std::vector<double> &x) const
 		{
-			for (size_t i=0;i<x.size();++i)
-				_randiter[i]->random(x[i]);
+			const size_t k = _field.size(), n = _field.paddedSize();
+			for (size_t i=0;i<k;++i)
+				_unit[i] = (double)(_generator() >> 11) * (1./9007199254740992.); // 53 bits in [0,1)
+			x.resize(n);
+			const double *P = _field.moduli();
+			for (size_t i=0;i<n;++i)
+				x[i] = std::floor(_unit[i] * P[i]);
 			return x;
 		}
 
@@ -431,7 +447,8 @@ namespace LinBox
 		MultiModDouble        _field;
 		integer                _size;
 		size_t                 _seed;
-		std::vector<Givaro::Modular<double>::RandIter*> _randiter;
+		mutable std::mt19937_64 _generator;
+		mutable std::vector<double> _unit;
 
 	}; // end of class MultiModRandIter
 
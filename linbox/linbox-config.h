@@ -72,6 +72,10 @@ using std::ptrdiff_t;
 #define __LINBOX_HAVE_AVX_INSTRUCTIONS2
 #endif
 
+#if defined(__FFLASFFPACK_HAVE_AVX512F_INSTRUCTIONS) && defined(__FFLASFFPACK_HAVE_AVX2_INSTRUCTIONS)
+#define __LINBOX_HAVE_AVX512F_INSTRUCTIONS
+#endif
+
 namespace LinBox {
 
 	typedef ptrdiff_t index_t;
@@ -77,11 +77,11 @@ namespace LinBox
 		//BlasMatrix () {}
 
 		BlasMatrix (const MultiModDouble& F) :
-			_field(F) , _rep(F.size()), _entry(F.size())
+			_field(F) , _rep(F.size()), _entry(F.paddedSize())
 		{}
 
 		BlasMatrix (const Field& F, size_t m, size_t n, bool alloc=true) :
-			_field(F), _row(m) , _col(n) , _rep(F.size()),  _entry(F.size())
+			_field(F), _row(m) , _col(n) , _rep(F.size()),  _entry(F.paddedSize())
 		{
 			for (size_t i=0;i<_rep.size();++i)
 				_rep[i] =  new BlasMatrix<Givaro::Modular<double> > (F.getBase(i), m, n);
@@ -60,7 +60,28 @@ namespace LinBox {
 
 	protected:
 		template <class Vector1, class Matrix, class Vector2>
-		inline Vector1 &mulColDense (const VectorDomain<Field> &VD, Vector1 &w, const Matrix &A, const Vector2 &v) const;
+		inline Vector1 &mulColDense (const VectorDomain<Field> &VD, Vector1 &w, const Matrix &A, const Vector2 &v) const
+		{
+			return mulColDenseSpecialized (VD, w, A, v, typename VectorTraits<typename Matrix::Column>::VectorCategory ());
+		}
+
+	private:
+		template <class Vector1, class Matrix, class Vector2>
+		Vector1 &mulColDenseSpecialized (const VectorDomain<Field> &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
+						 VectorCategories::GenericVectorTag) const;
+		//! sparse columns: the products are accumulated by row of w and reduced once
+		template <class Vector1, class Matrix, class Vector2>
+		Vector1 &mulColDenseSpecialized (const VectorDomain<Field> &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
+						 VectorCategories::SparseSequenceVectorTag) const;
+		template <class Vector1, class Matrix, class Vector2>
+		Vector1 &mulColDenseSpecialized (const VectorDomain<Field> &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
+						 VectorCategories::SparseAssociativeVectorTag) const;
+		template <class Vector1, class Matrix, class Vector2>
+		Vector1 &mulColDenseSpecialized (const VectorDomain<Field> &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
+						 VectorCategories::SparseParallelVectorTag) const;
+		//! sparse sequence and associative columns, both iterated as (index, element) pairs
+		template <class Vector1, class ColIterator, class Vector2>
+		Vector1 &mulColDenseSparse (const VectorDomain<Field> &VD, Vector1 &w, ColIterator i, const Vector2 &v) const;
 	};
 }
 
@@ -336,6 +336,7 @@ namespace LinBox
 
 			D=C;
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -359,6 +360,7 @@ namespace LinBox
 			linbox_check( C.rowdim() == A.rowdim());
 			linbox_check( C.coldim() == B.coldim());
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -402,6 +404,7 @@ namespace LinBox
 			constSubMatrixType C_v(C);
 			subMatrixType D_v(D);
 
+                        LINBOX_PERF_GEMM(C.field(), C_v.rowdim(), C_v.coldim(), A_v.coldim());
                         FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C_v.rowdim(), C_v.coldim(), A_v.coldim(),
 				     alpha,
@@ -428,6 +431,7 @@ namespace LinBox
 			constSubMatrixType B_v(B);
 			subMatrixType C_v(C);
 
+			LINBOX_PERF_GEMM(C.field(), C_v.rowdim(), C_v.coldim(), A_v.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C_v.rowdim(), C_v.coldim(), A_v.coldim(),
 				     alpha,
@@ -463,6 +467,7 @@ namespace LinBox
 
 			D.copy(C);
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -485,6 +490,7 @@ namespace LinBox
 			linbox_check( C.rowdim() == A.rowdim());
 			linbox_check( C.coldim() == B.coldim());
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -516,6 +522,7 @@ namespace LinBox
 
 			D.copy(C);
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -538,6 +545,7 @@ namespace LinBox
 			linbox_check( C.rowdim() == A.rowdim());
 			linbox_check( C.coldim() == B.coldim());
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -569,6 +577,7 @@ namespace LinBox
 
 			D=C;
 
+			LINBOX_PERF_GEMM(B.field(), C.rowdim(), C.coldim(), B.rowdim());
 			FFLAS::fgemm( B.field(), FFLAS::FflasTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), B.rowdim(),
 				     alpha,
@@ -592,6 +601,7 @@ namespace LinBox
 			linbox_check( C.rowdim() == A.getMatrix().coldim());
 			linbox_check( C.coldim() == B.coldim());
 
+			LINBOX_PERF_GEMM(B.field(), C.rowdim(), C.coldim(), B.rowdim());
 			FFLAS::fgemm( B.field(), FFLAS::FflasTrans, FFLAS::FflasNoTrans,
 				     C.rowdim(), C.coldim(), B.rowdim(),
 				     alpha,
@@ -622,6 +632,7 @@ namespace LinBox
 
 			D=C;
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.getMatrix().rowdim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasTrans, FFLAS::FflasTrans,
 				     C.rowdim(), C.coldim(), A.getMatrix().rowdim(),
 				     alpha,
@@ -644,6 +655,7 @@ namespace LinBox
 			linbox_check( C.rowdim() == A.getMatrix().coldim());
 			linbox_check( C.coldim() == B.getMatrix().rowdim());
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.getMatrix().rowdim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasTrans, FFLAS::FflasTrans,
 				     C.rowdim(), C.coldim(), A.getMatrix().rowdim(),
 				     alpha,
@@ -673,6 +685,7 @@ namespace LinBox
 			linbox_check( D.coldim() == C.coldim());
 
 			D=C;
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -695,6 +708,7 @@ namespace LinBox
 			linbox_check( C.rowdim() == A.rowdim());
 			linbox_check( C.coldim() == B.getMatrix().rowdim());
 
+			LINBOX_PERF_GEMM(C.field(), C.rowdim(), C.coldim(), A.coldim());
 			FFLAS::fgemm( C.field(), FFLAS::FflasNoTrans, FFLAS::FflasTrans,
 				     C.rowdim(), C.coldim(), A.coldim(),
 				     alpha,
@@ -762,8 +762,9 @@ namespace LinBox
 
 	template<class Field>
 	template <class Vector1, class Matrix_, class Vector2>
-	Vector1 &MVProductDomain<Field>::mulColDense
-	(const VectorDomain<Field> &VD, Vector1 &w, const Matrix_ &A, const Vector2 &v) const
+	Vector1 &MVProductDomain<Field>::mulColDenseSpecialized
+	(const VectorDomain<Field> &VD, Vector1 &w, const Matrix_ &A, const Vector2 &v,
+	 VectorCategories::GenericVectorTag) const
 	{
 		linbox_check (A.coldim () == v.size ());
 		linbox_check (A.rowdim () == w.size ());
@@ -779,6 +780,78 @@ namespace LinBox
 		return w;
 	}
 
+	template<class Field>
+	template <class Vector1, class ColIterator, class Vector2>
+	Vector1 &MVProductDomain<Field>::mulColDenseSparse
+	(const VectorDomain<Field> &VD, Vector1 &w, ColIterator i, const Vector2 &v) const
+	{
+		typename Vector2::const_iterator j = v.begin ();
+		decltype (i->begin ()) k;
+
+		const FieldAXPY<Field> accu0 (VD.field ());
+		std::vector<FieldAXPY<Field> > W (w.size (), accu0);
+
+		for (; j != v.end (); ++j, ++i)
+			for (k = i->begin (); k != i->end (); ++k)
+				W[k->first].mulacc (k->second, *j);
+
+		for (size_t l = 0; l < w.size (); ++l)
+			W[l].get (w[l]);
+
+		return w;
+	}
+
+	template<class Field>
+	template <class Vector1, class Matrix_, class Vector2>
+	Vector1 &MVProductDomain<Field>::mulColDenseSpecialized
+	(const VectorDomain<Field> &VD, Vector1 &w, const Matrix_ &A, const Vector2 &v,
+	 VectorCategories::SparseSequenceVectorTag) const
+	{
+		linbox_check (A.coldim () == v.size ());
+		linbox_check (A.rowdim () == w.size ());
+
+		return mulColDenseSparse (VD, w, A.colBegin (), v);
+	}
+
+	template<class Field>
+	template <class Vector1, class Matrix_, class Vector2>
+	Vector1 &MVProductDomain<Field>::mulColDenseSpecialized
+	(const VectorDomain<Field> &VD, Vector1 &w, const Matrix_ &A, const Vector2 &v,
+	 VectorCategories::SparseAssociativeVectorTag) const
+	{
+		linbox_check (A.coldim () == v.size ());
+		linbox_check (A.rowdim () == w.size ());
+
+		return mulColDenseSparse (VD, w, A.colBegin (), v);
+	}
+
+	template<class Field>
+	template <class Vector1, class Matrix_, class Vector2>
+	Vector1 &MVProductDomain<Field>::mulColDenseSpecialized
+	(const VectorDomain<Field> &VD, Vector1 &w, const Matrix_ &A, const Vector2 &v,
+	 VectorCategories::SparseParallelVectorTag) const
+	{
+		linbox_check (A.coldim () == v.size ());
+		linbox_check (A.rowdim () == w.size ());
+
+		typename Matrix_::ConstColIterator i = A.colBegin ();
+		typename Vector2::const_iterator j = v.begin ();
+		typename Matrix_::Column::first_type::const_iterator k_idx;
+		typename Matrix_::Column::second_type::const_iterator k_elt;
+
+		const FieldAXPY<Field> accu0 (VD.field ());
+		std::vector<FieldAXPY<Field> > W (w.size (), accu0);
+
+		for (; j != v.end (); ++j, ++i)
+			for (k_idx = i->first.begin (), k_elt = i->second.begin (); k_idx != i->first.end (); ++k_idx, ++k_elt)
+				W[*k_idx].mulacc (*k_elt, *j);
+
+		for (size_t l = 0; l < w.size (); ++l)
+			W[l].get (w[l]);
+
+		return w;
+	}
+
 	template<class Field>
 	template <class Vector1, class Matrix_, class Vector2>
 	Vector1 &MatrixDomain<Field>::mulColSpecialized (Vector1 &w, const Matrix_ &A, const Vector2 &v,
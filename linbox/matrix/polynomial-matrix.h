@@ -47,6 +47,11 @@ uint64_t max_memory=0, cur_memory=0;
 
 #define COPY_BLOCKSIZE 32
 
+// bytes kept by each thread for the buffers of the polfirst matrices (0 disables the pool)
+#ifndef PMATRIX_POOL_MAXBYTES
+#define PMATRIX_POOL_MAXBYTES (64UL<<20)
+#endif
+
 namespace LinBox{
 
 	enum PMType {polfirst, matfirst};
@@ -56,6 +61,75 @@ namespace LinBox{
 	template<size_t type, size_t storage, class Field>
 	class PolynomialMatrix;
 
+	/* Per thread pool of coefficient buffers.
+	 * The temporary polfirst matrices of the FFT products (padding of the
+	 * operands, evaluations) have the same sizes from one call to the
+	 * next: their buffers are given back to the pool of the thread which
+	 * frees them and reused by the next allocations of the thread, up to
+	 * PMATRIX_POOL_MAXBYTES (the oldest buffers are freed first).
+	 */
+	template<class Element>
+	class PolynomialMatrixPool {
+	public:
+		typedef std::vector<Element,AlignedAllocator<Element, Alignment::DEFAULT>> VECT;
+
+		// v (empty) gets a buffer of n elements, with unspecified values
+		static void acquire(VECT& v, size_t n){
+			std::vector<VECT>& P=pool();
+			size_t best=P.size();
+			for (size_t i=0;i<P.size();i++)
+				if (P[i].capacity()>=n && (best==P.size() || P[i].capacity()<P[best].capacity()))
+					best=i;
+			if (best<P.size()){
+				bytes()-=P[best].capacity()*sizeof(Element);
+				v.swap(P[best]);
+				P.erase(P.begin()+best);
+			}
+			v.resize(n);
+		}
+
+		// v is given back to the pool and left empty
+		static void release(VECT& v){
+			size_t b=v.capacity()*sizeof(Element);
+			if (b==0 || b>PMATRIX_POOL_MAXBYTES) {VECT().swap(v); return;}
+			std::vector<VECT>& P=pool();
+			while (bytes()+b>PMATRIX_POOL_MAXBYTES){
+				bytes()-=P.front().capacity()*sizeof(Element);
+				P.erase(P.begin());
+			}
+			P.push_back(VECT());
+			P.back().swap(v);
+			bytes()+=b;
+		}
+
+		// scratch buffer of n elements taken from the pool
+		class Buffer {
+		public:
+			Buffer(size_t n){acquire(_v,n);}
+			Buffer(const Buffer&) = delete;
+			~Buffer(){release(_v);}
+			Element*       data()      {return _v.data();}
+			const Element* data() const{return _v.data();}
+		private:
+			VECT _v;
+		};
+
+	private:
+		static std::vector<VECT>& pool(){static thread_local std::vector<VECT> P; return P;}
+		static size_t& bytes(){static thread_local size_t B=0; return B;}
+	};
+
+	// dst[j*ldd+i] = src[i*lds+j] for i<rows, j<cols, by blocks of COPY_BLOCKSIZE
+	template<class Element>
+	void blockedTranspose(Element* dst, size_t ldd, const Element* src, size_t lds, size_t rows, size_t cols){
+		const size_t ls = COPY_BLOCKSIZE;
+		for (size_t i = 0; i < rows; i+=ls)
+			for (size_t j = 0; j < cols; j+=ls)
+				for (size_t _i = i; _i < std::min(rows, i + ls); _i++)
+					for (size_t _j = j; _j < std::min(cols, j + ls); _j++)
+						dst[_j*ldd+_i]=src[_i*lds+_j];
+	}
+
 	template<typename Field> uint64_t element_storage(const Field& F)      { integer p;F.characteristic(p); return length(p);}
 	template<> uint64_t element_storage(const Givaro::Modular<Givaro::Integer> &F) { integer p;F.characteristic(p); return length(p)+sizeof(Givaro::Integer);}
 	
@@ -75,12 +149,16 @@ namespace LinBox{
 		typedef Subvector<Iterator,ConstIterator>   Polynomial;
 		typedef PolynomialMatrix<PMType::polfirst,PMStorage::plain,_Field>  Self_t;
 		typedef PolynomialMatrix<PMType::matfirst,PMStorage::plain,_Field> Other_t;
+		typedef PolynomialMatrixPool<Element>  Pool;
+		typedef typename Pool::Buffer        Buffer;
 
 		//PolynomialMatrix() {}
 
 		// construct a polynomial matrix in f[x]^(m x n) of degree (s-1)
 		PolynomialMatrix(const Field& f, size_t r, size_t c, size_t s, size_t stor=0) :
-			_store((stor?stor:s)), _repview(r*c),_rep(r*c*_store,f.zero), _row(r), _col(c), _size(s), _fld(&f) {
+			_store((stor?stor:s)), _repview(r*c), _row(r), _col(c), _size(s), _fld(&f) {
+			Pool::acquire(_rep,r*c*_store);
+			std::fill(_rep.begin(),_rep.end(),f.zero);
 			for (size_t i=0;i<_row;i++)
 				for (size_t j=0;j<_col;j++)
 					_repview[i*_col+j]= Polynomial(_rep.begin()+(i*_col+j)*_store,_size);
@@ -94,7 +172,7 @@ namespace LinBox{
 		
 		~PolynomialMatrix(){
 			DEL_MEM(realmeminfo());
-			_rep.clear();
+			Pool::release(_rep);
 			//std::cout<<"(FREE) PolynomialMatrix<polfirst> at "<<this<<" : "<<_row<<"x"<<_col<<" - size= "<<_store<<" ==> "<<MB(realmeminfo())<<" Mo   "<<STR_MEMINFO<<std::endl;
 
 			//integer p;
@@ -191,13 +269,8 @@ namespace LinBox{
 		// copy elt from M[beg..end], _size must be >= j-i
 		void copy(const Self_t& M, size_t beg, size_t end){
 			//cout<<"copying.....polfirst to polfirst.....same field"<<endl;
-			for (size_t k=0;k<_row*_col;k++){
-				size_t j=0;
-				for (size_t i=beg;i<=end;i++){
-					ref(k,j)=M.get(k,i);
-					j++;
-				}
-			}
+			for (size_t k=0;k<_row*_col;k++)
+				std::copy(M._rep.begin()+k*M._store+beg, M._rep.begin()+k*M._store+end+1, _rep.begin()+k*_store);
 		}
 		template<typename OtherField>
 		void copy(const PolynomialMatrix<PMType::polfirst,PMStorage::plain,OtherField> & M, size_t beg, size_t end){
@@ -246,6 +319,18 @@ namespace LinBox{
 			copy(M,0,M.size()-1);
 		}
 
+		// write the coefficients of degree beg..end as consecutive row major matrices in B:
+		// B[(k-beg)*rowdim*coldim+i] = get(i,k) (blocked transposition, no matfirst copy)
+		void getMatrices(Element* B, size_t beg, size_t end) const {
+			blockedTranspose(B, _row*_col, &_rep[0]+beg, _store, _row*_col, end-beg+1);
+		}
+
+		// inverse of getMatrices: the coefficients of degree start..start+end-beg are
+		// set from the matrices beg..end of B
+		void setMatrices(const Element* B, size_t beg, size_t end, size_t start=0) {
+			blockedTranspose(&_rep[0]+start, _store, B+beg*_row*_col, _row*_col, end-beg+1, _row*_col);
+		}
+
 		// rebind functor to change base field (e.g. apply modulo reduction)
 		template<typename _Tp1>
 		struct rebind {
@@ -75,6 +75,7 @@ namespace LinBox {
 // #include "sparsematrix/sparse-csr-1-matrix.h"
 #include "sparsematrix/sparse-ell-matrix.h"
 #include "sparsematrix/sparse-ellr-matrix.h"
+#include "sparsematrix/sparse-sym-matrix.h"
 // #include "sparsematrix/sparse-ellr-1-matrix.h"
 // #include "sparsematrix/sparse-bcsr-matrix.h"
 // #include "sparsematrix/sparse-dia-matrix.h"
@@ -33,6 +33,9 @@
 #define __LINBOX_sparse_matrix_sparse_csr_matrix_H
 
 #include <utility>
+#include <memory>
+#include <mutex>
+#include <functional>
 #include <iostream>
 #include <algorithm>
 
@@ -374,6 +377,7 @@ namespace LinBox {
 			_colid.resize(nn);
 			_data.resize(nn);
 			_nbnz = nn ;
+			_helper.reset();
 		}
 
 		void resize(const size_t & mm, const size_t & nn, const size_t & zz = 0)
@@ -641,6 +645,7 @@ namespace LinBox {
 				linbox_check(_start[rowdim()] == _nbnz);
 			}
 			_triples.reset();
+			_helper.reset();
 
 		} // end construction after a sequence of setEntry calls.
 
@@ -677,6 +682,7 @@ namespace LinBox {
 				_colid.insert(_colid.begin()+ibeg,j);
 				_data.insert( _data.begin() +ibeg,e);
 				++_nbnz;
+				_helper.reset();
 				return ;
 			}
 			// element may exist
@@ -692,6 +698,7 @@ namespace LinBox {
 				_colid.insert(_colid.begin() + (ptrdiff_t)ibeg,j);
 				_data.insert (_data. begin() + (ptrdiff_t)ibeg,e);
 				++_nbnz;
+				_helper.reset();
 				return ;
 			}
 			// replace
@@ -793,6 +800,7 @@ namespace LinBox {
 				_colid.erase(_colid.begin()+(ptrdiff_t)la);
 				_data. erase(_data. begin()+(ptrdiff_t)la);
 				--_nbnz;
+				_helper.reset();
 				return  ;
 			}
 		}
@@ -813,6 +821,7 @@ namespace LinBox {
 				else
 					++i ;
 			}
+			_helper.reset();
 			return ;
 		}
 
@@ -833,7 +842,7 @@ namespace LinBox {
 				for (index_t k = _start[i] ; k < _start[i+1] ; ++k)
 					// field().axpyin( y[i], _data[k], x[_colid[k]] ); //! @todo delay !!!
 					accu.mulacc(_data[k],x[_colid[k]]);
-				accu.get(y[i]);
+				addAccumulated(field(),y[i],accu);
 			}
 
 			return y;
@@ -846,12 +855,12 @@ namespace LinBox {
 		outVector& applyTranspose(outVector &y, const inVector& x, const Element & a) const
 		{
 			linbox_check(consistent());
+			prepare(field(),y,a);
+
 			if (_helper.optimized(*this)) {
-				return _helper.matrix().apply(y,x,a) ; // NEVER use applyTranspose on that thing.
+				return _helper.applyTranspose(y,x,*this) ;
 			}
 
-			prepare(field(),y,a);
-
 			const FieldAXPY<Field> accu0(field());
 			std::vector<FieldAXPY<Field> > Y(_colnb, accu0);
 
@@ -861,7 +870,7 @@ namespace LinBox {
 				}
 
 			for (size_t i = 0 ; i < _colnb ; ++i)
-				Y[i].get(y[i]) ;
+				addAccumulated(field(),y[i],Y[i]) ;
 
 			return y;
 		}
@@ -903,50 +912,98 @@ namespace LinBox {
 
 	private :
 
+		/* Column major shadow of the matrix, built on the first call to
+		 * applyTranspose when the matrix is large enough (once, under a
+		 * std::call_once, as applies may run concurrently).  Only the
+		 * structure is stored (column starts, row indices and position of
+		 * each entry in _data), values are shared with the matrix so the
+		 * shadow stays valid as long as the pattern does not change.
+		 */
 		class Helper {
-			bool _useable ;
+			std::unique_ptr<std::once_flag> _once ;
+			bool _built ;     // getHelp was called since the last reset
 			bool _optimized ;
-			bool blackbox_usage ;
-			Self_t *_AT ;
+			svector_t _cstart ; // start of each column in _rowid
+			svector_t _rowid ;  // row index of each entry, column by column
+			svector_t _pos ;    // position of each entry in A._data
 		public:
 
 			Helper() :
-				_useable(false)
+				_once(new std::once_flag)
+				,_built(false)
+				,_optimized(false)
+			{}
+
+			// a copy builds its own shadow when it needs it
+			Helper(const Helper &) :
+				_once(new std::once_flag)
+				,_built(false)
 				,_optimized(false)
-				, blackbox_usage(true)
-				, _AT(NULL)
 			{}
 
-			~Helper()
+			Helper & operator=(const Helper &)
 			{
-				if ( _AT ) {
-					delete _AT ;
-				}
+				_built = true ;
+				reset();
+				return *this ;
 			}
 
+			// concurrent applies may get here together: the shadow is built once
 			bool optimized(const Self_t & A)
 			{
-				if (!_useable) {
-					getHelp(A);
-					_useable = true;
-				}
+				std::call_once(*_once, &Helper::getHelp, this, std::cref(A));
 				return	_optimized;
 			}
 
+			//! forget the shadow (pattern of the matrix changed)
+			void reset()
+			{
+				if (!_built)
+					return ;
+				_once.reset(new std::once_flag);
+				_built = false ;
+				_optimized = false ;
+				svector_t().swap(_cstart);
+				svector_t().swap(_rowid);
+				svector_t().swap(_pos);
+			}
+
 			void getHelp(const Self_t & A)
 			{
+				_built = true ;
 				if ( A.size() > LINBOX_CSR_TRANSPOSE ) { // and/or A.rowDensity(), A.coldim(),...
-					// std::cout << "optimizing..." ;
 					_optimized = true ;
-					_AT = new Self_t(A.field(),A.coldim(),A.rowdim());
-					A.transpose(*_AT);
-					// std::cout << "done!" << std::endl;
+					_cstart.assign(A._colnb+1,0);
+					_rowid.resize(A._nbnz);
+					_pos.resize(A._nbnz);
+					for (size_t k = 0 ; k < A._nbnz ; ++k)
+						++_cstart[A._colid[k]+1] ;
+					for (size_t j = 0 ; j < A._colnb ; ++j)
+						_cstart[j+1] += _cstart[j] ;
+					svector_t fill(_cstart.begin(),_cstart.end()-1);
+					for (size_t i = 0 ; i < A._rownb ; ++i)
+						for (index_t k = A._start[i] ; k < A._start[i+1] ; ++k) {
+							index_t l = fill[A._colid[k]]++ ;
+							_rowid[l] = (index_t)i ;
+							_pos[l]   = k ;
+						}
 				}
 			}
 
-			const Self_t & matrix() const
+			// y = A^T x as a gather over the columns of A, in parallel.
+			template<class inVector, class outVector>
+			outVector& applyTranspose(outVector &y, const inVector& x, const Self_t & A) const
 			{
-				return *_AT ;
+				const long n = (long)A._colnb ;
+#pragma omp parallel for schedule(static)
+				for (long j = 0 ; j < n ; ++j) {
+					FieldAXPY<Field> accu(A.field());
+					accu.reset();
+					for (index_t l = _cstart[(size_t)j] ; l < _cstart[(size_t)j+1] ; ++l)
+						accu.mulacc(A._data[_pos[l]], x[_rowid[l]]);
+					addAccumulated(A.field(),y[(size_t)j],accu);
+				}
+				return y;
 			}
 
 		};
@@ -968,12 +1025,14 @@ namespace LinBox {
 		{
 			if (i > _rownb) this->resize(i,_colnb,_nbnz);
 			_start[i] = j ;
+			_helper.reset();
 		}
 
 		void setStart(const svector_t &  new_start)
 		{
 			// linbox_check(_start.size() == new_start.size());
 			_start = new_start ;
+			_helper.reset();
 		}
 
 		svector_t  getStart( ) const
@@ -1008,11 +1067,13 @@ namespace LinBox {
 			if (i>=_nbnz) this->resize(i+1);
 			linbox_check(i <= _colid.size())
 			_colid[i]=(index_t)j;
+			_helper.reset();
 		}
 
 		void setColid(svector_t new_colid)
 		{
 			_colid = new_colid ;
+			_helper.reset();
 		}
 
 		svector_t  getColid( ) const
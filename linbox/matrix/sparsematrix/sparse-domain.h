@@ -33,6 +33,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/field-axpy.h"
 
 namespace LinBox {
 
@@ -57,6 +58,19 @@ namespace LinBox {
 		return y ;
 	}
 
+	/** y <- y + the sum accumulated in accu.
+	 * The sparse applies accumulate the products of a row (or a column
+	 * for the transpose) without reduction in a FieldAXPY and reduce
+	 * once here, on top of the y prepared by prepare().
+	 */
+	template<class Field>
+	typename Field::Element & addAccumulated(const Field & F, typename Field::Element & y, FieldAXPY<Field> & accu) {
+		typename Field::Element t;
+		F.init(t);
+		accu.get(t);
+		return F.addin(y,t);
+	}
+
 } // LinBox
 
 #endif // __LINBOX_matrix_sparsematrix_sparse_domain_H
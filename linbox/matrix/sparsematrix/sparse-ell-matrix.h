@@ -33,6 +33,9 @@
 #define __LINBOX_matrix_sparsematrix_sparse_ell_matrix_H
 
 #include <utility>
+#include <memory>
+#include <mutex>
+#include <functional>
 #include <iostream>
 #include <algorithm>
 
@@ -780,7 +783,7 @@ namespace LinBox
 					else {
 						break;
 					}
-				accu.get(y[i]);
+				addAccumulated(field(),y[i],accu);
 			}
 
 			return y;
@@ -820,7 +823,7 @@ namespace LinBox
 						break;
 
 			for (size_t i = 0 ; i < _colnb ; ++i)
-				Y[i].get(y[i]) ;
+				addAccumulated(field(),y[i],Y[i]) ;
 #endif
 
 			return y;
@@ -891,19 +894,36 @@ namespace LinBox
 	private :
 
 		class Helper {
-			bool _useable ;
+			std::unique_ptr<std::once_flag> _once ;
 			bool _optimized ;
 			bool blackbox_usage ;
 			Self_t *_AT ;
 		public:
 
 			Helper() :
-				_useable(false)
+				_once(new std::once_flag)
 				,_optimized(false)
 				, blackbox_usage(true)
 				, _AT(NULL)
 			{}
 
+			// a copy builds its own transpose when it needs it
+			Helper(const Helper &) :
+				_once(new std::once_flag)
+				,_optimized(false)
+				, blackbox_usage(true)
+				, _AT(NULL)
+			{}
+
+			Helper & operator=(const Helper &)
+			{
+				delete _AT ;
+				_AT = NULL ;
+				_optimized = false ;
+				_once.reset(new std::once_flag);
+				return *this ;
+			}
+
 			~Helper()
 			{
 				if ( _AT ) {
@@ -911,12 +931,10 @@ namespace LinBox
 				}
 			}
 
+			// concurrent applies may get here together: the transpose is built once
 			bool optimized(const Self_t & A)
 			{
-				if (!_useable) {
-					getHelp(A);
-					_useable = true;
-				}
+				std::call_once(*_once, &Helper::getHelp, this, std::cref(A));
 				return	_optimized;
 			}
 
@@ -0,0 +1,463 @@
+/* linbox/matrix/sparsematrix/sparse-sym-matrix.h
+ * Copyright (C) 2016 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/sparsematrix/sparse-sym-matrix.h
+ * @ingroup sparsematrix
+ * @brief Symmetric sparse matrix, only the upper triangle is stored.
+ */
+
+
+#ifndef __LINBOX_matrix_sparsematrix_sparse_sym_matrix_H
+#define __LINBOX_matrix_sparsematrix_sparse_sym_matrix_H
+
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/field-axpy.h"
+#include "linbox/util/matrix-stream.h"
+#include "linbox/util/write-mm.h"
+#include "sparse-domain.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef LINBOX_SYM_PARALLEL
+/// number of stored entries above which apply uses all OpenMP threads
+#define LINBOX_SYM_PARALLEL 100000
+#endif
+
+namespace LinBox
+{
+
+	/** Sparse symmetric matrix, upper triangle in CSR storage.
+	 *
+	 * Entry \f$a_{ij}\f$, \f$i\leq j\f$, is stored once in row \f$i\f$.
+	 * The apply makes one pass over the stored entries, each contributing
+	 * to \f$y_i\f$ and to the mirrored \f$y_j\f$, so memory and bandwidth
+	 * are about half of those of a full storage (or of
+	 * <code>Compose<A,Transpose<A> ></code>).
+	 *
+	 * When compiled with OpenMP, large matrices are applied in parallel,
+	 * each thread accumulating into its own result buffer, and the
+	 * buffers being summed afterwards.
+	 *
+	 * \ingroup matrix
+	 * \ingroup sparse
+	 */
+	template<class _Field>
+	class SparseMatrix<_Field, SparseMatrixFormat::SYM > {
+	private :
+		typedef std::vector<index_t> svector_t ;
+	public :
+		typedef _Field                             Field ; //!< Field
+		typedef typename _Field::Element         Element ; //!< Element
+		typedef const Element               constElement ; //!< const Element
+		typedef SparseMatrixFormat::SYM          Storage ; //!< Matrix Storage Format
+		typedef SparseMatrix<_Field,Storage>     Self_t ; //!< Self type
+		typedef typename Vector<Field>::SparseSeq    Row ; //!< @warning this is not the row type. Just used for streams.
+
+		/*! Constructors.
+		 */
+		//@{
+		SparseMatrix<_Field, SparseMatrixFormat::SYM> (const _Field & F) :
+			_n(0)
+			,_nbnz(0)
+			,_start(1,0)
+			,_colid(0)
+			,_data(0)
+			,_field(F)
+		{}
+
+		SparseMatrix<_Field, SparseMatrixFormat::SYM> (const _Field & F, size_t m, size_t n) :
+			_n(n)
+			,_nbnz(0)
+			,_start(n+1,0)
+			,_colid(0)
+			,_data(0)
+			,_field(F)
+		{
+			linbox_check(m == n);
+		}
+
+		SparseMatrix<_Field, SparseMatrixFormat::SYM> (const SparseMatrix<_Field, SparseMatrixFormat::SYM> & S) :
+			_n(S._n)
+			,_nbnz(S._nbnz)
+			,_start(S._start)
+			,_colid(S._colid)
+			,_data(S._data)
+			,_field(S._field)
+		{}
+
+		SparseMatrix<_Field, SparseMatrixFormat::SYM> ( MatrixStream<Field>& ms ) :
+			_n(0)
+			,_nbnz(0)
+			,_start(1,0)
+			,_colid(0)
+			,_data(0)
+			,_field(ms.field())
+		{
+			read(ms);
+		}
+		//@}
+
+		size_t rowdim() const
+		{
+			return _n ;
+		}
+
+		size_t coldim() const
+		{
+			return _n ;
+		}
+
+		/*! Number of stored entries (upper triangle, diagonal included).
+		 */
+		size_t size() const
+		{
+			return _nbnz ;
+		}
+
+		const Field & field()  const
+		{
+			return _field ;
+		}
+
+		void resize(const size_t & mm, const size_t & nn, const size_t & zz = 0)
+		{
+			linbox_check(mm == nn);
+			_n = nn ;
+			_start.assign(nn+1,0);
+			_colid.clear();
+			_data.clear();
+			_colid.reserve(zz);
+			_data.reserve(zz);
+			_nbnz = 0 ;
+		}
+
+		/** Get a read-only individual entry from the matrix.
+		 * @param i Row index
+		 * @param j Column index
+		 * @return Const reference to matrix entry
+		 */
+		constElement &getEntry(const size_t &i, const size_t &j) const
+		{
+			linbox_check(i<_n);
+			linbox_check(j<_n);
+			const size_t r = std::min(i,j), c = std::max(i,j);
+			typename svector_t::const_iterator beg = _colid.begin() + _start[r] ;
+			typename svector_t::const_iterator end = _colid.begin() + _start[r+1] ;
+			typename svector_t::const_iterator low = std::lower_bound (beg, end, (index_t)c);
+			if ( low == end || *low != (index_t)c )
+				return field().zero;
+			return _data[(size_t)(low-_colid.begin())] ;
+		}
+
+		Element      &getEntry (Element &x, size_t i, size_t j) const
+		{
+			return x = getEntry (i, j);
+		}
+
+		/** Set an individual entry.
+		 * Sets both \f$a_{ij}\f$ and \f$a_{ji}\f$.
+		 * Setting the entry to 0 removes it from the matrix.
+		 */
+		void setEntry(const size_t &i, const size_t &j, const Element& e)
+		{
+			linbox_check(i<_n);
+			linbox_check(j<_n);
+			const size_t r = std::min(i,j), c = std::max(i,j);
+			typename svector_t::iterator beg = _colid.begin() + _start[r] ;
+			typename svector_t::iterator end = _colid.begin() + _start[r+1] ;
+			typename svector_t::iterator low = std::lower_bound (beg, end, (index_t)c);
+			const ptrdiff_t k = low-_colid.begin() ;
+			if ( low != end && *low == (index_t)c ) {
+				if (field().isZero(e)) {
+					_colid.erase(low);
+					_data.erase(_data.begin()+k);
+					for (size_t l = r+1 ; l <= _n ; ++l)
+						_start[l] -= 1 ;
+					--_nbnz ;
+				}
+				else
+					field().assign(_data[(size_t)k],e);
+				return ;
+			}
+			if (field().isZero(e))
+				return ;
+			_colid.insert(low,(index_t)c);
+			_data.insert(_data.begin()+k,e);
+			for (size_t l = r+1 ; l <= _n ; ++l)
+				_start[l] += 1 ;
+			++_nbnz ;
+		}
+
+		void clearEntry(const size_t &i, const size_t &j)
+		{
+			setEntry(i,j,field().zero);
+		}
+
+		/// make matrix ready to use after a sequence of setEntry calls (nothing to do).
+		void finalize()
+		{}
+
+		/** y = A x.
+		 * One pass over the stored entries: \f$a_{ij}\f$ adds
+		 * \f$a_{ij}x_j\f$ to \f$y_i\f$ and \f$a_{ij}x_i\f$ to \f$y_j\f$.
+		 */
+		template<class inVector, class outVector>
+		outVector& apply(outVector &y, const inVector& x) const
+		{
+#ifdef _OPENMP
+			if (_nbnz > LINBOX_SYM_PARALLEL && omp_get_max_threads() > 1)
+				return applyOMP(y,x);
+#endif
+			const FieldAXPY<Field> accu0(field());
+			std::vector<FieldAXPY<Field> > Y(_n, accu0);
+			accumulate(Y, x, 0, _n);
+			for (size_t i = 0 ; i < _n ; ++i)
+				Y[i].get(y[i]);
+			return y;
+		}
+
+		//! y = A^T x = A x
+		template<class inVector, class outVector>
+		outVector& applyTranspose(outVector &y, const inVector& x) const
+		{
+			return apply(y,x);
+		}
+
+#ifdef _OPENMP
+		/** y = A x, with OpenMP.
+		 * Rows are shared among threads, each thread accumulating its
+		 * row and mirrored contributions into its own buffer, allocated
+		 * by the call (applies of one matrix may run concurrently); the
+		 * buffers are summed at the end.
+		 */
+		template<class inVector, class outVector>
+		outVector& applyOMP(outVector &y, const inVector& x) const
+		{
+			const FieldAXPY<Field> accu0(field());
+			const long n = (long)_n ;
+			std::vector<std::vector<FieldAXPY<Field> > > tacc((size_t)omp_get_max_threads());
+			size_t nthr = 1 ;
+#pragma omp parallel shared(nthr,tacc)
+			{
+#pragma omp single
+				nthr = (size_t)omp_get_num_threads();
+
+				// allocated by its thread
+				std::vector<FieldAXPY<Field> > & Y = tacc[(size_t)omp_get_thread_num()];
+				Y.assign(_n, accu0);
+#pragma omp for schedule(dynamic,64)
+				for (long i = 0 ; i < n ; ++i)
+					accumulate(Y, x, (size_t)i, (size_t)i+1);
+
+#pragma omp for schedule(static)
+				for (long i = 0 ; i < n ; ++i) {
+					Element s, t ;
+					field().init(s);
+					field().init(t);
+					tacc[0][(size_t)i].get(s);
+					for (size_t l = 1 ; l < nthr ; ++l)
+						field().addin(s, tacc[l][(size_t)i].get(t));
+					field().assign(y[(size_t)i],s);
+				}
+			}
+			return y;
+		}
+#endif
+
+		/** Materialise \f$A A^T\f$ (upper triangle) into this matrix.
+		 * A symbolic pass first counts the stored entries of the product;
+		 * when they exceed \p maxnnz nothing is built and false is
+		 * returned, in which case <code>Compose<A,Transpose<A> ></code>
+		 * is the better blackbox. By default \p maxnnz is the number of
+		 * non zero entries of \p A, i.e. the product is built when one
+		 * apply of it costs no more than the two applies of \f$A\f$ and
+		 * \f$A^T\f$.
+		 * @param A a CSR matrix
+		 * @param maxnnz bound on the number of stored entries
+		 * @return true if the product was built
+		 */
+		bool buildAAT(const SparseMatrix<_Field, SparseMatrixFormat::CSR> & A, size_t maxnnz = 0)
+		{
+			if (maxnnz == 0)
+				maxnnz = A.size();
+
+			const size_t m = A.rowdim(), n = A.coldim();
+
+			// column index of A
+			svector_t cstart(n+1,0), rowid(A.size()), pos(A.size());
+			for (size_t i = 0 ; i < m ; ++i)
+				for (index_t k = A.getStart(i) ; k < A.getEnd(i) ; ++k)
+					++cstart[(size_t)A.getColid((size_t)k)+1];
+			for (size_t j = 0 ; j < n ; ++j)
+				cstart[j+1] += cstart[j];
+			{
+				svector_t fill(cstart.begin(),cstart.end()-1);
+				for (size_t i = 0 ; i < m ; ++i)
+					for (index_t k = A.getStart(i) ; k < A.getEnd(i) ; ++k) {
+						index_t l = fill[(size_t)A.getColid((size_t)k)]++ ;
+						rowid[(size_t)l] = (index_t)i;
+						pos[(size_t)l] = k;
+					}
+			}
+
+			// symbolic: pattern of row i of the upper triangle of A A^T
+			std::vector<size_t> mark(m, m);
+			size_t nbnz = 0 ;
+			for (size_t i = 0 ; i < m ; ++i) {
+				for (index_t k = A.getStart(i) ; k < A.getEnd(i) ; ++k) {
+					const size_t c = (size_t)A.getColid((size_t)k);
+					for (index_t l = cstart[c] ; l < cstart[c+1] ; ++l) {
+						const size_t j = (size_t)rowid[(size_t)l];
+						if (j >= i && mark[j] != i) {
+							mark[j] = i ;
+							++nbnz ;
+						}
+					}
+				}
+				if (nbnz > maxnnz)
+					return false;
+			}
+
+			// numeric
+			resize(m, m, nbnz);
+			const FieldAXPY<Field> accu0(field());
+			std::vector<FieldAXPY<Field> > acc(m, accu0);
+			std::vector<size_t> touched ;
+			std::fill(mark.begin(), mark.end(), m);
+			Element e ;
+			field().init(e);
+			for (size_t i = 0 ; i < m ; ++i) {
+				touched.clear();
+				for (index_t k = A.getStart(i) ; k < A.getEnd(i) ; ++k) {
+					const size_t c = (size_t)A.getColid((size_t)k);
+					for (index_t l = cstart[c] ; l < cstart[c+1] ; ++l) {
+						const size_t j = (size_t)rowid[(size_t)l];
+						if (j < i)
+							continue ;
+						if (mark[j] != i) {
+							mark[j] = i ;
+							acc[j].reset();
+							touched.push_back(j);
+						}
+						acc[j].mulacc(A.getData((size_t)k), A.getData((size_t)pos[(size_t)l]));
+					}
+				}
+				std::sort(touched.begin(), touched.end());
+				for (size_t t = 0 ; t < touched.size() ; ++t) {
+					acc[touched[t]].get(e);
+					if (field().isZero(e))
+						continue ;
+					_colid.push_back((index_t)touched[t]);
+					_data.push_back(e);
+				}
+				_start[i+1] = (index_t)_colid.size();
+			}
+			_nbnz = _colid.size();
+			return true;
+		}
+
+		/** Write the full matrix (both triangles), MatrixMarket format.
+		 */
+		std::ostream & write(std::ostream &os) const
+		{
+			size_t nnz = 0 ;
+			for (size_t i = 0 ; i < _n ; ++i)
+				for (index_t k = _start[i] ; k < _start[i+1] ; ++k)
+					nnz += ((size_t)_colid[(size_t)k] == i) ? 1 : 2 ;
+			writeMMCoordHeader(os, *this, nnz, "SparseMatrix<SYM>");
+			for (size_t i = 0 ; i < _n ; ++i)
+				for (index_t k = _start[i] ; k < _start[i+1] ; ++k) {
+					const size_t j = (size_t)_colid[(size_t)k] ;
+					field().write(os << i+1 << ' ' << j+1 << ' ', _data[(size_t)k]) << std::endl;
+					if (j != i)
+						field().write(os << j+1 << ' ' << i+1 << ' ', _data[(size_t)k]) << std::endl;
+				}
+			return os;
+		}
+
+		/** Read a matrix, the entries below the diagonal are ignored.
+		 */
+		std::istream& read (std::istream &is)
+		{
+			MatrixStream<Field> ms(field(), is);
+			read(ms);
+			return is;
+		}
+
+	protected :
+
+		void read (MatrixStream<Field>& ms)
+		{
+			size_t m, n, i, j ;
+			if( !ms.getDimensions(m, n) || m != n )
+				throw ms.reportError(__FUNCTION__,__LINE__);
+			resize(m, n);
+			Element x ;
+			field().init(x);
+			while (ms.nextTriple(i, j, x))
+				if (i <= j)
+					setEntry(i, j, x);
+		}
+
+		// Y_i += sum a_ij x_j, Y_j += a_ij x_i, for rows ibeg..iend-1
+		template<class inVector>
+		void accumulate(std::vector<FieldAXPY<Field> > & Y, const inVector & x,
+				size_t ibeg, size_t iend) const
+		{
+			for (size_t i = ibeg ; i < iend ; ++i)
+				for (index_t k = _start[i] ; k < _start[i+1] ; ++k) {
+					const size_t j = (size_t)_colid[(size_t)k] ;
+					Y[i].mulacc(_data[(size_t)k], x[j]);
+					if (j != i)
+						Y[j].mulacc(_data[(size_t)k], x[i]);
+				}
+		}
+
+		size_t               _n ;
+		size_t            _nbnz ;
+
+		svector_t _start ;
+		svector_t _colid ;
+		std::vector<Element> _data ;
+
+		const _Field & _field;
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_matrix_sparsematrix_sparse_sym_matrix_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
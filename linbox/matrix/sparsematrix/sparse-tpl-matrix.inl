@@ -179,11 +179,14 @@ OutVector & SparseMatrix<Field_,SparseMatrixFormat::TPL>::apply(OutVector & y, c
 {
 	linbox_check( rowdim() == y.size() );
 	linbox_check( coldim() == x.size() );
-	for (Index i = 0; i < y.size(); ++i) field().assign(y[i], field().zero);
+	// the products are accumulated by row and reduced once
+	const FieldAXPY<Field> accu0(field());
+	std::vector<FieldAXPY<Field> > Y(y.size(), accu0);
 	for (Index k = 0; k < data_.size(); ++k) {
-		Triple t = data_[k];
-		field().axpyin(y[t.row], t.elt, x[t.col]);
+		const Triple& t = data_[k];
+		Y[t.row].mulacc(t.elt, x[t.col]);
 	}
+	for (Index i = 0; i < y.size(); ++i) Y[i].get(y[i]);
 	return y;
 }
 
@@ -194,11 +197,13 @@ OutVector & SparseMatrix<Field_,SparseMatrixFormat::TPL>::applyTranspose(OutVect
 {
 	linbox_check( coldim() == y.size() );
 	linbox_check( rowdim() == x.size() );
-	for (Index i = 0; i < y.size(); ++i) field().assign(y[i], field().zero);
+	const FieldAXPY<Field> accu0(field());
+	std::vector<FieldAXPY<Field> > Y(y.size(), accu0);
 	for (Index k = 0; k < data_.size(); ++k) {
 		const Triple& t = data_[k];
-		field().axpyin(y[t.col], t.elt, x[t.row]);
+		Y[t.col].mulacc(t.elt, x[t.row]);
 	}
+	for (Index i = 0; i < y.size(); ++i) Y[i].get(y[i]);
 	return y;
 }
 
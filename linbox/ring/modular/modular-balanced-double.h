@@ -99,7 +99,7 @@ namespace LinBox
 		inline Element& accumulate (const Element &tmp)
 		{
 			_y += tmp;
-			if (_y > _bound)
+			if (std::fabs(_y) > _bound)
 				return _y = fmod (_y, field().characteristic());
 			else
 				return _y;
@@ -115,7 +115,7 @@ namespace LinBox
 
 		inline Element& get (Element &y) {
 			_y = fmod (_y, field().characteristic());
-			return y=_y ;
+			return field().init(y, _y);
 		}
 
 		inline FieldAXPY &assign (const Element y) {
@@ -129,7 +129,7 @@ namespace LinBox
 
 		inline Element& set (const Element &tmp) {
 			_y = tmp;
-			if (_y > _bound)
+			if (std::fabs(_y) > _bound)
 				return _y = fmod (_y, field().characteristic());
 			else
 				return _y;
@@ -150,12 +150,14 @@ namespace LinBox
 	private:
 		double _bound;
 		size_t _nmax;
+		VectorSIMD::ModDouble _simd;
 
 	public:
 		typedef double Element;
 		DotProductDomain(){}
 		DotProductDomain (const Givaro::ModularBalanced<double> &F) :
 			VectorDomainBase<Givaro::ModularBalanced<double> > (F), _bound( (double) ( (1ULL<<53) - (unsigned long) (field().characteristic()*field().characteristic())))
+			, _simd(F.characteristic())
 		{
 			_nmax= (size_t)floor((double(1<<26)* double(1<<26)*2.)/ (field().characteristic() * field().characteristic()));
 		}
@@ -165,6 +167,10 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		inline Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
+			const double *x1 = VectorSIMD::typed<double>(VectorSIMD::contiguous(v1));
+			const double *x2 = VectorSIMD::typed<double>(VectorSIMD::contiguous(v2));
+			if (x1 && x2)
+				return field().init(res, VectorSIMD::dot(_simd, x1, x2, v1.size()));
 
 			double y = 0.;
 			if (v1.size() < _nmax) {
@@ -194,6 +200,11 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		inline Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
+			const size_t *idx = VectorSIMD::typed<size_t>(VectorSIMD::contiguous(v1.first));
+			const double *val = VectorSIMD::typed<double>(VectorSIMD::contiguous(v1.second));
+			const double *x = VectorSIMD::typed<double>(VectorSIMD::contiguous(v2));
+			if (idx && val && x)
+				return field().init(res, VectorSIMD::dotGather(_simd, val, 1, idx, 1, x, v1.first.size()));
 
 			double y = 0.;
 
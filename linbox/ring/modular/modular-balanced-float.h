@@ -66,12 +66,12 @@ namespace LinBox
 	class FieldAXPY<Givaro::ModularBalanced<float> > {
 	public:
 		typedef float Element;
-		typedef float Abnormal;
+		typedef double Abnormal; // the products are summed exactly in double
 		typedef Givaro::ModularBalanced<Element> Field;
 
 		FieldAXPY (const Field &F) :
 			_field (&F),
-			_y(0.) , _bound( (Element) (((1UL << 24) - (unsigned long) (field().characteristic()*field().characteristic()))))
+			_y(0.) , _bound( (Abnormal) (((1ULL << 53) - (unsigned long) (field().characteristic()*field().characteristic()))))
 		{}
 
 		FieldAXPY (const FieldAXPY &faxpy) :
@@ -86,20 +86,18 @@ namespace LinBox
 			return *this;
 		}
 
-		inline Element& mulacc (const Element &a, const Element &x) {
-			//                 Element tmp= a*x;
-			//                 return accumulate(tmp);
-			return accumulate(a*x);
+		inline Abnormal& mulacc (const Element &a, const Element &x) {
+			return accumulate((Abnormal)a*(Abnormal)x);
 		}
 
-		inline Element& accumulate (const Element &tmp) {
+		inline Abnormal& accumulate (const Abnormal &tmp) {
 			_y += tmp;
-			if (_y > _bound)
-				return _y = fmodf (_y, field().characteristic());
+			if (std::fabs(_y) > _bound)
+				return _y = fmod (_y, (Abnormal)field().characteristic());
 			else
 				return _y;
 		}
-		inline Element& subumulate (const Element &tmp) {
+		inline Abnormal& subumulate (const Abnormal &tmp) {
 			_y -= tmp;
 			if (_y < 0)
 				return _y += field().characteristic();
@@ -108,8 +106,8 @@ namespace LinBox
 		}
 
 		inline Element& get (Element &y) {
-			_y =  fmodf (_y, field().characteristic());
-			return y=_y ;
+			_y =  fmod (_y, (Abnormal)field().characteristic());
+			return field().init(y, _y);
 		}
 
 		inline FieldAXPY &assign (const Element y) {
@@ -121,10 +119,10 @@ namespace LinBox
 			_y = 0.;
 		}
 
-		inline Element& set (const Element &tmp) {
+		inline Abnormal& set (const Abnormal &tmp) {
 			_y = tmp;
-			if (_y > _bound)
-				return _y =  fmodf (_y, field().characteristic());
+			if (std::fabs(_y) > _bound)
+				return _y =  fmod (_y, (Abnormal)field().characteristic());
 			else
 				return _y;
 		}
@@ -133,8 +131,8 @@ namespace LinBox
 
 	private:
 		const Field *_field;
-		Element _y;
-		Element _bound;
+		Abnormal _y;
+		Abnormal _bound;
 	};
 
 
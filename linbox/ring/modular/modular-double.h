@@ -156,6 +156,7 @@ namespace LinBox
 		// double _bound; // BB : not used
 		size_t _nmax;
 		//double _invmod;
+		VectorSIMD::ModDouble _simd;
 
 	public:
 		//DotProductDomain () { /*std::cerr << "DPD-Md def cstor" << std::endl;*/ }
@@ -164,6 +165,7 @@ namespace LinBox
 			VectorDomainBase<Givaro::Modular<double> > (F)
 			// , _bound( (double) ( (1ULL<<53) - (unsigned long int) (F.characteristic()*F.characteristic())))
 			, _nmax(0)//, _invmod(1./field().characteristic())
+			, _simd(F.fcharacteristic())
 		{
 			_nmax= (size_t)floor((double(1<<26)* double(1<<26)*2.)/ (F.fcharacteristic() * F.fcharacteristic()));
 			_nmax = (_nmax>0?_nmax:1);
@@ -175,6 +177,10 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		 Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
+			const double *x1 = VectorSIMD::typed<double>(VectorSIMD::contiguous(v1));
+			const double *x2 = VectorSIMD::typed<double>(VectorSIMD::contiguous(v2));
+			if (x1 && x2)
+				return res = VectorSIMD::dot(_simd, x1, x2, v1.size());
 
 			double y = 0.;
 			if (v1.size() < _nmax) {
@@ -203,6 +209,11 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		 Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
+			const size_t *idx = VectorSIMD::typed<size_t>(VectorSIMD::contiguous(v1.first));
+			const double *val = VectorSIMD::typed<double>(VectorSIMD::contiguous(v1.second));
+			const double *x = VectorSIMD::typed<double>(VectorSIMD::contiguous(v2));
+			if (idx && val && x)
+				return res = VectorSIMD::dotGather(_simd, val, 1, idx, 1, x, v1.first.size());
 
 			double y = 0.;
 
@@ -63,12 +63,12 @@ namespace LinBox
 	public:
 
 		typedef float Element;
-		typedef float Abnormal;
+		typedef double Abnormal; // the products are summed exactly in double
 		typedef Givaro::Modular<float> Field;
 
 		FieldAXPY (const Field &F) :
 			_field (&F) , //_invmod(1./field().fcharacteristic()),
-			_y(0.) , _bound( (float) ( (1_i32 << 23) - (uint32_t) (field().characteristic()*field().characteristic())))
+			_y(0.) , _bound( (double) ( (1_i64 << 53) - (uint64_t) (field().characteristic()*field().characteristic())))
 		{}
 
 		FieldAXPY (const FieldAXPY &faxpy) :
@@ -76,25 +76,24 @@ namespace LinBox
 			_y(faxpy._y), _bound(faxpy._bound)
 		{}
 
-		inline Element& mulacc (const Element &a, const Element &x)
+		inline Abnormal& mulacc (const Element &a, const Element &x)
 		{
-			Element tmp= a*x;
-			return accumulate(tmp);
+			return accumulate((Abnormal)a*(Abnormal)x);
 		}
 
-		inline Element& accumulate (const Element &tmp)
+		inline Abnormal& accumulate (const Abnormal &tmp)
 		{
 			_y += tmp;
 			if (_y > _bound)
-				return _y = fmodf (_y, field().fcharacteristic());
+				return _y = fmod (_y, (Abnormal)field().fcharacteristic());
 			else
 				return _y;
 		}
 
 		inline Element& get (Element &y)
 		{
-			_y = fmodf (_y, field().fcharacteristic());
-			return y=_y ;
+			_y = fmod (_y, (Abnormal)field().fcharacteristic());
+			return y=(Element)_y ;
 		}
 
 		inline FieldAXPY &assign (const Element y)
@@ -114,8 +113,8 @@ namespace LinBox
 
 		const Field *_field;
 		//float _invmod;
-		float _y;
-		float _bound;
+		Abnormal _y;
+		Abnormal _bound;
 	};
 
 
@@ -125,6 +124,7 @@ namespace LinBox
 		float _bound;
 		size_t _nmax;
 		//float _invmod;
+		VectorSIMD::ModDouble _simd;
 
 	public:
 		typedef float Element;
@@ -132,6 +132,7 @@ namespace LinBox
 			VectorDomainBase<Givaro::Modular<float> > (F)
 			, _bound( (float) ( (1<<23) - (uint32_t) (F.characteristic()*F.characteristic())))
 			//, _invmod(1./field().fcharacteristic())
+			, _simd(F.fcharacteristic())
 		{
 			_nmax= (size_t)floor((double(1<<11)* double(1<<12))/ double(F.fcharacteristic() * F.fcharacteristic()));
 		}
@@ -141,6 +142,10 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		inline Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
+			const float *x1 = VectorSIMD::typed<float>(VectorSIMD::contiguous(v1));
+			const float *x2 = VectorSIMD::typed<float>(VectorSIMD::contiguous(v2));
+			if (x1 && x2)
+				return res = (float) VectorSIMD::dot(_simd, x1, x2, v1.size());
 
 			float y = 0.;
 			if (v1.size() < _nmax) {
@@ -151,6 +151,11 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		 Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
+			const int32_t *x1 = VectorSIMD::typed<int32_t>(VectorSIMD::contiguous(v1));
+			const int32_t *x2 = VectorSIMD::typed<int32_t>(VectorSIMD::contiguous(v2));
+			if (x1 && x2)
+				return res = Element(VectorSIMD::dotU32((uint64_t) faxpy()._two_64, x1, x2, v1.size())
+						     % (uint64_t) field().characteristic());
 
 			typename Vector1::const_iterator i;
 			typename Vector2::const_iterator j;
@@ -175,6 +180,13 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		 Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
+			const size_t *idx = VectorSIMD::typed<size_t>(VectorSIMD::contiguous(v1.first));
+			const int32_t *val = VectorSIMD::typed<int32_t>(VectorSIMD::contiguous(v1.second));
+			const int32_t *x = VectorSIMD::typed<int32_t>(VectorSIMD::contiguous(v2));
+			if (idx && val && x)
+				return res = Element(VectorSIMD::dotGatherU32((uint64_t) faxpy()._two_64, val, 1, idx, 1, x, v1.first.size())
+						     % (uint64_t) field().characteristic());
+
 			typename Vector1::first_type::const_iterator i_idx;
 			typename Vector1::second_type::const_iterator i_elt;
 
@@ -294,7 +306,7 @@ namespace LinBox
                         typedef typename Vector1::value_type val_t;
 
                         for (w_j = w.begin (), l = _tmp.begin (); w_j != w.end (); ++w_j, ++l)
-                                *w_j = (val_t)( (int32_t)(*l) % VD.field ().characteristic() );
+                                *w_j = (val_t)( *l % (uint64_t) VD.field ().characteristic() );
 
                         return w;
                 }
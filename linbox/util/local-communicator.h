@@ -0,0 +1,202 @@
+/* linbox/util/local-communicator.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+#ifndef __LINBOX_local_communicator_H
+#define __LINBOX_local_communicator_H
+
+#include <vector>
+#include <cerrno>
+#include <type_traits>
+#include <stdint.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "linbox/util/error.h"
+#include "linbox/util/perf-counters.h"
+
+namespace LinBox
+{
+	/** \brief Stand-in for Communicator on a single host, without MPI.
+	 *
+	 * The constructor forks np-1 worker processes, each connected to the
+	 * root (rank 0) by a unix socket; every process returns from it with
+	 * its own rank(). Only root <-> worker messages are supported, which
+	 * is what the gather based drivers need. Messages between two
+	 * processes are received in the order they were sent, the tag is
+	 * only checked. The data is sent as raw bytes, it must be trivially
+	 * copyable.
+	 *
+	 * The worker processes exit when their communicator is destroyed.
+	 * It must be created before any thread is started (e.g. by OpenMP).
+	 */
+	class LocalCommunicator {
+	public:
+		LocalCommunicator (int np) :
+			_size(np), _rank(0), _fd((size_t)np,-1)
+		{
+			for (int i = 1; i < np; ++i) {
+				int sv[2];
+				if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+					reap();
+					throw LinboxError("LocalCommunicator: socketpair failed");
+				}
+				pid_t pid = fork();
+				if (pid < 0) {
+					close(sv[0]);
+					close(sv[1]);
+					reap();
+					throw LinboxError("LocalCommunicator: fork failed");
+				}
+				if (pid == 0) {
+					// worker i: only keep the link to the root
+					close(sv[0]);
+					for (int j = 1; j < i; ++j)
+						close(_fd[(size_t)j]);
+					_fd.assign((size_t)np,-1);
+					_fd[0] = sv[1];
+					_rank = i;
+					_pids.clear();
+					return;
+				}
+				close(sv[1]);
+				_fd[(size_t)i] = sv[0];
+				_pids.push_back(pid);
+			}
+		}
+
+		LocalCommunicator (const LocalCommunicator&) = delete;
+		LocalCommunicator &operator= (const LocalCommunicator&) = delete;
+
+		~LocalCommunicator ()
+		{
+			for (size_t i = 0; i < _fd.size(); ++i)
+				if (_fd[i] >= 0)
+					close(_fd[i]);
+			if (_rank != 0)
+				_exit(0);
+			for (size_t i = 0; i < _pids.size(); ++i)
+				waitpid(_pids[i], NULL, 0);
+		}
+
+		// accessors
+		int size () const { return _size; }
+
+		int rank () const { return _rank; }
+
+		// peer to peer communication
+		template < class X >
+		void send (X *b, X *e, int dest, int tag = 0)
+		{
+			static_assert(std::is_trivially_copyable<X>::value, "LocalCommunicator: data is sent as raw bytes");
+			uint64_t head[2] = { (uint64_t)tag, (uint64_t)(e-b)*sizeof(X) };
+			write_all(link(dest), head, sizeof(head));
+			write_all(link(dest), b, head[1]);
+			LINBOX_PERF_COUNT(PERF_BYTES, head[1]);
+		}
+
+		template < class X >
+		void recv (X *b, X *e, int src, int tag = 0)
+		{
+			static_assert(std::is_trivially_copyable<X>::value, "LocalCommunicator: data is received as raw bytes");
+			uint64_t head[2];
+			read_all(link(src), head, sizeof(head));
+			if (head[0] != (uint64_t)tag || head[1] != (uint64_t)(e-b)*sizeof(X))
+				throw LinboxError("LocalCommunicator: unexpected message");
+			read_all(link(src), b, head[1]);
+		}
+
+		// whole object send and recv
+		template < class X >
+		void send (X &b, int dest) { send(&b, &b+1, dest, 0); }
+
+		template < class X >
+		void recv (X &b, int src) { recv(&b, &b+1, src, 0); }
+
+	protected:
+		int                      _size;
+		int                      _rank;
+		std::vector<int>           _fd; // socket to each process (-1 if none)
+		std::vector<pid_t>       _pids; // workers, on the root
+
+		// on the root, when the constructor fails: kill and wait for the
+		// workers already forked
+		void reap ()
+		{
+			for (size_t i = 0; i < _fd.size(); ++i)
+				if (_fd[i] >= 0) {
+					close(_fd[i]);
+					_fd[i] = -1;
+				}
+			for (size_t i = 0; i < _pids.size(); ++i) {
+				kill(_pids[i], SIGKILL);
+				while (waitpid(_pids[i], NULL, 0) < 0 && errno == EINTR) ;
+			}
+			_pids.clear();
+		}
+
+		int link (int p) const
+		{
+			if (p < 0 || p >= _size || _fd[(size_t)p] < 0)
+				throw LinboxError("LocalCommunicator: only root <-> worker messages");
+			return _fd[(size_t)p];
+		}
+
+		static void write_all (int fd, const void *p, size_t len)
+		{
+			const char *c = (const char *)p;
+			while (len > 0) {
+				ssize_t k = ::write(fd, c, len);
+				if (k < 0 && errno == EINTR) continue;
+				if (k <= 0)
+					throw LinboxError("LocalCommunicator: write failed");
+				c += k; len -= (size_t)k;
+			}
+		}
+
+		static void read_all (int fd, void *p, size_t len)
+		{
+			char *c = (char *)p;
+			while (len > 0) {
+				ssize_t k = ::read(fd, c, len);
+				if (k < 0 && errno == EINTR) continue;
+				if (k <= 0)
+					throw LinboxError("LocalCommunicator: read failed");
+				c += k; len -= (size_t)k;
+			}
+		}
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_local_communicator_H
+
+
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,:0,t0,+0,=s
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
@@ -0,0 +1,274 @@
+/* linbox/util/perf-counters.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file util/perf-counters.h
+ * @ingroup util
+ * @brief Work counters and phase timers of the algorithms.
+ */
+
+#ifndef __LINBOX_perf_counters_H
+#define __LINBOX_perf_counters_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <type_traits>
+
+namespace LinBox
+{
+
+	/// What is counted (see PerfCounters)
+	enum PerfCounterId {
+		PERF_BLACKBOX_APPLY = 0, //!< blackbox applies (a block of k vectors counts k)
+		PERF_CRA_PRIME,          //!< primes used by the chinese remaindering
+		PERF_LIFTING_DIGIT,      //!< p-adic digits computed by the lifting containers
+		PERF_FIELD_OPS,          //!< estimated field operations (2mnk for a matrix product)
+		PERF_BYTES,              //!< estimated bytes read and written by the counted products, and sent
+		PERF_NB_COUNTERS
+	};
+
+	/// number of calls and accumulated time of a phase
+	struct PerfTime {
+		PerfTime () : count(0), seconds(0) {}
+		uint64_t   count;
+		double   seconds;
+	};
+
+	/** \brief Values of the counters and timers at some point.
+	 * The work done between two points is the difference of their
+	 * snapshots.
+	 */
+	struct PerfReport {
+		PerfReport () { for (size_t i = 0; i < PERF_NB_COUNTERS; ++i) counters[i] = 0; }
+
+		uint64_t                        counters[PERF_NB_COUNTERS];
+		std::map<std::string,PerfTime>  timers;
+
+		uint64_t operator[] (PerfCounterId c) const { return counters[c]; }
+
+		PerfReport operator- (const PerfReport &b) const
+		{
+			PerfReport r(*this);
+			for (size_t i = 0; i < PERF_NB_COUNTERS; ++i)
+				r.counters[i] -= b.counters[i];
+			for (std::map<std::string,PerfTime>::const_iterator it = b.timers.begin(); it != b.timers.end(); ++it) {
+				PerfTime &t = r.timers[it->first];
+				t.count -= it->second.count;
+				t.seconds -= it->second.seconds;
+			}
+			return r;
+		}
+
+		static const char *name (size_t c)
+		{
+			static const char *names[PERF_NB_COUNTERS] = {
+				"blackbox applies", "CRA primes", "lifting digits", "field ops (est.)", "bytes (est.)" };
+			return names[c];
+		}
+
+		std::ostream &write (std::ostream &os) const
+		{
+			for (size_t i = 0; i < PERF_NB_COUNTERS; ++i)
+				os << std::left << std::setw(36) << name(i) << std::right << std::setw(20) << counters[i] << std::endl;
+			for (std::map<std::string,PerfTime>::const_iterator it = timers.begin(); it != timers.end(); ++it)
+				os << std::left << std::setw(36) << it->first << std::right << std::setw(20) << it->second.count
+				   << std::fixed << std::setprecision(6) << std::setw(16) << it->second.seconds << " s" << std::endl;
+			return os;
+		}
+	};
+
+	/** \brief Registry of the work counters and of the phase timers.
+	 *
+	 * Compiled in with -DLINBOX_PERF_COUNTERS only: otherwise the
+	 * LINBOX_PERF_COUNT and LINBOX_PERF_TIMER macros used by the
+	 * algorithms expand to nothing and snapshot() stays at zero.
+	 *
+	 * Each thread increments its own counters (no atomic read-modify-write
+	 * nor shared cache line); snapshot() sums them over the threads, past
+	 * and present. Timers accumulate under a lock and are meant for
+	 * phases, not for inner loops.
+	 \code
+	 PerfReport before = PerfCounters::snapshot();
+	 det(d, A);
+	 PerfReport work = PerfCounters::snapshot() - before;
+	 std::cout << work[PERF_BLACKBOX_APPLY] << " applies" << std::endl;
+	 \endcode
+	 */
+	class PerfCounters {
+	public:
+#ifdef LINBOX_PERF_COUNTERS
+		static const bool enabled = true;
+#else
+		static const bool enabled = false;
+#endif
+
+		static void add (PerfCounterId c, uint64_t n)
+		{
+			std::atomic<uint64_t> &v = local().counters[c];
+			v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+
+		static void addTime (const std::string &name, double seconds)
+		{
+			Registry &R = registry();
+			std::lock_guard<std::mutex> lock(R.mutex);
+			PerfTime &t = R.timers[name];
+			++t.count;
+			t.seconds += seconds;
+		}
+
+		/// current values (since the last reset)
+		static PerfReport snapshot ()
+		{
+			Registry &R = registry();
+			std::lock_guard<std::mutex> lock(R.mutex);
+			PerfReport r;
+			for (size_t t = 0; t < R.shards.size(); ++t)
+				for (size_t i = 0; i < PERF_NB_COUNTERS; ++i)
+					r.counters[i] += R.shards[t]->counters[i].load(std::memory_order_relaxed);
+			r.timers = R.timers;
+			return r - R.base;
+		}
+
+		/// start again from zero
+		static void reset ()
+		{
+			PerfReport r = snapshot();
+			Registry &R = registry();
+			std::lock_guard<std::mutex> lock(R.mutex);
+			for (size_t i = 0; i < PERF_NB_COUNTERS; ++i)
+				R.base.counters[i] += r.counters[i];
+			R.timers.clear();
+		}
+
+	private:
+		struct Shard {
+			Shard () { for (size_t i = 0; i < PERF_NB_COUNTERS; ++i) counters[i].store(0); }
+			std::atomic<uint64_t> counters[PERF_NB_COUNTERS];
+		};
+
+		struct Registry {
+			std::mutex                                mutex;
+			std::vector<std::unique_ptr<Shard> >     shards; // one per thread, kept after its exit
+			std::map<std::string,PerfTime>           timers;
+			PerfReport                                 base; // counters at the last reset
+		};
+
+		static Registry &registry ()
+		{
+			static Registry R;
+			return R;
+		}
+
+		static Shard &local ()
+		{
+			static thread_local Shard *shard = NULL;
+			if (!shard) {
+				Registry &R = registry();
+				std::lock_guard<std::mutex> lock(R.mutex);
+				R.shards.push_back(std::unique_ptr<Shard>(new Shard));
+				shard = R.shards.back().get();
+			}
+			return *shard;
+		}
+	};
+
+	/// adds its lifetime to the timer name
+	class PerfTimerScope {
+	public:
+		PerfTimerScope (const char *name) : _name(name), _start(std::chrono::steady_clock::now()) {}
+		~PerfTimerScope ()
+		{
+			std::chrono::duration<double> d = std::chrono::steady_clock::now() - _start;
+			PerfCounters::addTime(_name, d.count());
+		}
+	private:
+		const char                                 *_name;
+		std::chrono::steady_clock::time_point      _start;
+	};
+
+	/** \brief Successive phases of a thread: lap(level,name) adds the time
+	 * since the previous lap (or start) of the same level to the timer name.
+	 */
+	class PerfLapTimer {
+	public:
+		static void start (size_t level) { last(level) = std::chrono::steady_clock::now(); }
+
+		static void lap (size_t level, const char *name)
+		{
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			std::chrono::duration<double> d = now - last(level);
+			PerfCounters::addTime(name, d.count());
+			last(level) = now;
+		}
+
+	private:
+		static std::chrono::steady_clock::time_point &last (size_t level)
+		{
+			static thread_local std::chrono::steady_clock::time_point t[4];
+			return t[level & 3];
+		}
+	};
+
+} // namespace LinBox
+
+#define LINBOX_PERF_CAT_(a,b) a##b
+#define LINBOX_PERF_CAT(a,b) LINBOX_PERF_CAT_(a,b)
+
+#ifdef LINBOX_PERF_COUNTERS
+#define LINBOX_PERF_COUNT(c,n) LinBox::PerfCounters::add(LinBox::c, (uint64_t)(n))
+#define LINBOX_PERF_TIMER(name) LinBox::PerfTimerScope LINBOX_PERF_CAT(linbox_perf_timer_,__LINE__)(name)
+#define LINBOX_PERF_LAP_START(lvl) LinBox::PerfLapTimer::start(lvl)
+#define LINBOX_PERF_LAP(lvl,name) LinBox::PerfLapTimer::lap(lvl,name)
+// product of m x k by k x n matrices over F: 2mnk operations, reads A, B and C, writes C
+#define LINBOX_PERF_GEMM(F,m,n,k)							\
+	do {										\
+		uint64_t linbox_perf_m = (m), linbox_perf_n = (n), linbox_perf_k = (k);	\
+		LINBOX_PERF_COUNT(PERF_FIELD_OPS, 2*linbox_perf_m*linbox_perf_n*linbox_perf_k); \
+		LINBOX_PERF_COUNT(PERF_BYTES, (linbox_perf_m*linbox_perf_k+linbox_perf_k*linbox_perf_n+2*linbox_perf_m*linbox_perf_n) \
+				  *sizeof(typename std::decay<decltype(F)>::type::Element)); \
+	} while(0)
+#else
+#define LINBOX_PERF_COUNT(c,n)
+#define LINBOX_PERF_TIMER(name)
+#define LINBOX_PERF_LAP_START(lvl)
+#define LINBOX_PERF_LAP(lvl,name)
+#define LINBOX_PERF_GEMM(F,m,n,k)
+#endif
+
+#endif // __LINBOX_perf_counters_H
+
+
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,:0,t0,+0,=s
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
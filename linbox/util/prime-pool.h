@@ -0,0 +1,391 @@
+/* linbox/util/prime-pool.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file util/prime-pool.h
+ * @ingroup primes
+ * @brief Distinct primes generated ahead by a background thread and
+ * claimed concurrently.
+ */
+
+#ifndef __LINBOX_prime_pool_H
+#define __LINBOX_prime_pool_H
+
+#include <vector>
+#include <set>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdint>
+
+#include <givaro/givintprime.h>
+#include "linbox/integer.h"
+#include "linbox/util/timer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+
+namespace LinBox
+{
+
+	/** \brief Pool of distinct primes of a given bit size, shared by threads.
+	 * @ingroup primes
+	 *
+	 * A background thread generates the primes ahead of their use (up
+	 * to \p lookahead primes not yet claimed) and publishes them in an
+	 * append only table. claim() is reentrant and lock free while the
+	 * pool is not empty: one atomic increment gives the index of the
+	 * claimed primes. A thread finding the pool empty wakes the
+	 * generator and yields until its primes are published.
+	 *
+	 * All the primes of a pool are distinct and have exactly bits()
+	 * bits, as those of RandomPrimeIterator. They are certified: by a
+	 * deterministic Miller-Rabin test up to 64 bits, and by 25 rounds of
+	 * Miller-Rabin above.
+	 *
+	 * The generator has its own random state (the GMP one of
+	 * Integer::random is not touched), seeded by \p seed.
+	 *
+	 * An optional table file keeps primes across runs: a text file,
+	 * one prime by line ('#' starts a comment). Its primes of the
+	 * requested size are checked and served first, in a random order;
+	 * the primes generated by the pool are added to it when the pool is
+	 * destroyed (see save()).
+	 *
+	 * When no new prime is found after 1000 candidates (small bit
+	 * sizes), the pool is exhausted: claim() returns false once the
+	 * published primes are claimed.
+	 \code
+	 PrimePool pool(27);
+	 PrimePool::Iterator genprime(pool);  // a PrimeIterator, one by thread
+	 ChineseRemainder<EarlySingleCRA<Givaro::Modular<double> > > cra(4);
+	 cra(d, iteration, genprime);         // with OpenMP, the workers claim their primes
+	 \endcode
+	 */
+	class PrimePool {
+	public:
+		typedef integer Prime_Type;
+
+		/*! Starts the generating thread.
+		 * @param bits size of the primes (in bits, > 1)
+		 * @param seed if \c 0 a seed will be generated
+		 * @param table file of primes to start from and to update, none if empty
+		 * @param lookahead primes generated in advance
+		 */
+		PrimePool (uint64_t bits = 27, uint64_t seed = 0, const std::string &table = std::string(), size_t lookahead = 1024) :
+			_bits(bits), _table(table), _lookahead(std::max(lookahead, (size_t)1)),
+			_next(0), _ready(0), _loaded(0), _stop(false), _done(false),
+			_generator(seed ? seed : (uint64_t)BaseTimer::seed())
+		{
+			linbox_check(bits > 1);
+			for (size_t c = 0; c < _maxChunks; ++c)
+				_chunks[c].store(NULL, std::memory_order_relaxed);
+			if (! _table.empty())
+				load(_table);
+			_thread = std::thread(&PrimePool::produce, this);
+		}
+
+		PrimePool (const PrimePool&) = delete;
+		PrimePool &operator= (const PrimePool&) = delete;
+
+		/// stops the generating thread and updates the table file
+		~PrimePool ()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stop.store(true, std::memory_order_relaxed);
+			}
+			_wake.notify_one();
+			_thread.join();
+			if (! _table.empty() && _ready.load(std::memory_order_acquire) > _loaded)
+				save(_table);
+			for (size_t c = 0; c < _maxChunks; ++c)
+				delete[] _chunks[c].load(std::memory_order_relaxed);
+		}
+
+		/** A new prime of the pool, never given before.
+		 * @return false if the pool is exhausted
+		 */
+		bool claim (integer &p)
+		{
+			size_t i = _next.fetch_add(1, std::memory_order_relaxed);
+			if (! wait(i)) return false;
+			p = at(i);
+			return true;
+		}
+
+		/** k new primes, appended to primes.
+		 * @return the number of primes appended, less than k if the pool is exhausted
+		 */
+		size_t claim (std::vector<integer> &primes, size_t k)
+		{
+			size_t i = _next.fetch_add(k, std::memory_order_relaxed);
+			size_t j = 0;
+			for (; j < k && wait(i+j); ++j)
+				primes.push_back(at(i+j));
+			return j;
+		}
+
+		uint64_t bits () const { return _bits; }
+
+		/// number of primes claimed so far
+		size_t claimed () const { return std::min(_next.load(std::memory_order_relaxed), published()); }
+
+		/// number of primes published so far
+		size_t published () const { return _ready.load(std::memory_order_acquire); }
+
+		/** Writes the published primes to file, keeping the primes of
+		 * other sizes already there. The file is replaced at once.
+		 * @return false if it could not be written
+		 */
+		bool save (const std::string &file) const
+		{
+			std::vector<integer> others;
+			std::set<integer> mine;
+			size_t r = published();
+			for (size_t i = 0; i < r; ++i)
+				mine.insert(at(i));
+			readTable(file, others);
+			const std::string tmp = file + ".tmp";
+			{
+				std::ofstream out(tmp.c_str());
+				if (! out) return false;
+				out << "# LinBox prime table" << std::endl;
+				for (size_t i = 0; i < others.size(); ++i)
+					if ((uint64_t)others[i].bitsize() != _bits || ! mine.count(others[i]))
+						out << others[i] << std::endl;
+				for (std::set<integer>::const_iterator it = mine.begin(); it != mine.end(); ++it)
+					out << *it << std::endl;
+				if (! out) return false;
+			}
+			return std::rename(tmp.c_str(), file.c_str()) == 0;
+		}
+
+		/** \brief PrimeIterator claiming its primes from a pool.
+		 *
+		 * Each thread uses its own iterator; ChineseRemainderOMP claims
+		 * the primes of its workers from pool() directly.
+		 */
+		class Iterator {
+		public:
+			typedef integer Prime_Type;
+
+			Iterator (PrimePool &P) : _pool(&P) { ++(*this); }
+
+			/// claims a new prime, throws if the pool is exhausted
+			Iterator &operator++ ()
+			{
+				if (! _pool->claim(_prime))
+					throw LinboxError("PrimePool: no more primes of this size");
+				return *this;
+			}
+
+			const Prime_Type &operator* () const { return _prime; }
+			const Prime_Type &randomPrime () const { return _prime; }
+
+			PrimePool &pool () const { return *_pool; }
+
+		private:
+			PrimePool *_pool;
+			integer   _prime;
+		};
+
+	protected:
+		static const size_t _chunkSize = 1024;
+		static const size_t _maxChunks = 4096;
+		static const int  _maxFailures = 1000;
+
+		const integer &at (size_t i) const
+		{
+			return _chunks[i / _chunkSize].load(std::memory_order_relaxed)[i % _chunkSize];
+		}
+
+		// waits until prime i is published, false if it never will be
+		bool wait (size_t i)
+		{
+			while (i >= _ready.load(std::memory_order_acquire)) {
+				if (_done.load(std::memory_order_acquire))
+					return i < _ready.load(std::memory_order_acquire);
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+				}
+				_wake.notify_one();
+				std::this_thread::yield();
+			}
+			if (i + _lookahead / 2 >= _ready.load(std::memory_order_relaxed))
+				_wake.notify_one();
+			return true;
+		}
+
+		// the generating thread
+		void produce ()
+		{
+			std::set<integer> seen;
+			size_t r = 0, t = 0;
+			integer p;
+			while (! _stop.load(std::memory_order_relaxed)) {
+				if (r >= _next.load(std::memory_order_relaxed) + _lookahead) {
+					std::unique_lock<std::mutex> lock(_mutex);
+					_wake.wait_for(lock, std::chrono::milliseconds(10), [&]{
+						return _stop.load(std::memory_order_relaxed) || r < _next.load(std::memory_order_relaxed) + _lookahead; });
+					continue;
+				}
+				if (r == _chunkSize * _maxChunks) break;
+				if (t < _start.size()) {
+					p = _start[t++];
+					if ((uint64_t)p.bitsize() != _bits || seen.count(p) || ! certify(p)) continue;
+				}
+				else if (! generate(p, seen)) break;
+				seen.insert(p);
+				size_t c = r / _chunkSize;
+				if (r % _chunkSize == 0)
+					_chunks[c].store(new integer[_chunkSize], std::memory_order_relaxed);
+				_chunks[c].load(std::memory_order_relaxed)[r % _chunkSize] = p;
+				_ready.store(++r, std::memory_order_release);
+			}
+			_done.store(true, std::memory_order_release);
+		}
+
+		// a random prime of _bits bits, not in seen
+		bool generate (integer &p, const std::set<integer> &seen)
+		{
+			for (int f = 0; f < _maxFailures; ++f) {
+				if (_bits < 64) {
+					const uint64_t top = (uint64_t)1 << _bits;
+					uint64_t c = (top - (_generator() & ((top >> 1) - 1))) | 1;
+					while (c < top && ! isprime(c)) c += 2;
+					if (c >= top) continue;
+					p = c;
+				}
+				else {
+					integer r = 0;
+					for (uint64_t b = 0; b < _bits; b += 64) {
+						r <<= 64;
+						r += integer((uint64_t)_generator());
+					}
+					const integer top = integer(1) << _bits;
+					p = top - (r % (top >> 1));
+					_IPD.nextprimein(p);
+					if ((uint64_t)p.bitsize() != _bits || ! certify(p)) continue;
+				}
+				if (! seen.count(p)) return true;
+			}
+			return false;
+		}
+
+		bool certify (const integer &p) const
+		{
+			if (p.bitsize() <= 64) return isprime((uint64_t)p);
+			return _IPD.isprime(p, 25);
+		}
+
+		// deterministic Miller-Rabin: these bases suffice below 3.3 10^24
+		static bool isprime (uint64_t n)
+		{
+			static const uint64_t bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+			if (n < 2) return false;
+			for (size_t i = 0; i < 12; ++i)
+				if (n % bases[i] == 0) return n == bases[i];
+			uint64_t d = n - 1;
+			int s = 0;
+			while (! (d & 1)) { d >>= 1; ++s; }
+			for (size_t i = 0; i < 12; ++i) {
+				uint64_t x = powmod(bases[i], d, n);
+				if (x == 1 || x == n - 1) continue;
+				int j = 1;
+				for (; j < s; ++j) {
+					x = (uint64_t)((unsigned __int128)x * x % n);
+					if (x == n - 1) break;
+				}
+				if (j == s) return false;
+			}
+			return true;
+		}
+
+		static uint64_t powmod (uint64_t a, uint64_t e, uint64_t n)
+		{
+			uint64_t r = 1;
+			for (; e; e >>= 1) {
+				if (e & 1) r = (uint64_t)((unsigned __int128)r * a % n);
+				a = (uint64_t)((unsigned __int128)a * a % n);
+			}
+			return r;
+		}
+
+		// the primes of the table of the right size, shuffled
+		void load (const std::string &file)
+		{
+			std::vector<integer> primes;
+			readTable(file, primes);
+			for (size_t i = 0; i < primes.size(); ++i)
+				if ((uint64_t)primes[i].bitsize() == _bits)
+					_start.push_back(primes[i]);
+			std::shuffle(_start.begin(), _start.end(), _generator);
+			_loaded = _start.size();
+		}
+
+		static void readTable (const std::string &file, std::vector<integer> &primes)
+		{
+			std::ifstream in(file.c_str());
+			std::string line;
+			while (std::getline(in, line)) {
+				std::istringstream is(line.substr(0, line.find('#')));
+				integer p;
+				if (is >> p)
+					primes.push_back(p);
+			}
+		}
+
+		const uint64_t                           _bits;
+		const std::string                       _table;
+		const size_t                        _lookahead;
+		std::atomic<integer*>  _chunks[_maxChunks]; //!< the published primes, by chunks
+		std::atomic<size_t>                      _next; //!< index of the next prime to claim
+		std::atomic<size_t>                     _ready; //!< number of published primes
+		size_t                                 _loaded; //!< primes read from the table
+		std::atomic<bool>                        _stop;
+		std::atomic<bool>                        _done; //!< nothing more will be published
+		std::mutex                              _mutex; //!< only for the generator to sleep
+		std::condition_variable                  _wake;
+		std::mt19937_64                     _generator;
+		std::vector<integer>                    _start; //!< primes of the table, served first
+		Givaro::IntPrimeDom                       _IPD;
+		std::thread                            _thread;
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_prime_pool_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,462 @@
+/* linbox/util/tracer.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file util/tracer.h
+ * @ingroup util
+ * @brief Thread safe activity tracing (timing of nested activities per thread).
+ */
+
+#ifndef __LINBOX_tracer_H
+#define __LINBOX_tracer_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdint>
+
+// events kept by each thread before they are collected (rounded up to a power of 2)
+#ifndef TRACER_BUFFER_SIZE
+#define TRACER_BUFFER_SIZE 16384
+#endif
+
+namespace LinBox
+{
+
+	/// One timestamped event of a thread.
+	struct TraceEvent {
+		enum Kind { START, STOP, PROGRESS };
+		uint64_t      time; // ns since the creation of the tracer
+		const char   *name; // activity (started, stopped or progressing)
+		long             k; // progress: steps done
+		long           len; // progress: number of steps (-1 if unknown)
+		int           kind;
+	};
+
+	/** \brief Ring buffer of the events of one thread.
+	 *
+	 * Single producer (the thread) and single consumer (Tracer::collect,
+	 * serialized by the tracer): push and drain do not lock.
+	 */
+	class TraceBuffer {
+	public:
+		TraceBuffer (size_t capacity) :
+			_ev(roundup(capacity)), _mask(_ev.size()-1), _head(0), _tail(0)
+		{}
+
+		/// false if the buffer is full
+		bool push (const TraceEvent &e)
+		{
+			size_t h = _head.load(std::memory_order_relaxed);
+			if (h - _tail.load(std::memory_order_acquire) > _mask)
+				return false;
+			_ev[h & _mask] = e;
+			_head.store(h+1, std::memory_order_release);
+			return true;
+		}
+
+		/// move the pending events to the end of out
+		void drain (std::vector<TraceEvent> &out)
+		{
+			size_t t = _tail.load(std::memory_order_relaxed);
+			size_t h = _head.load(std::memory_order_acquire);
+			for (; t != h; ++t)
+				out.push_back(_ev[t & _mask]);
+			_tail.store(t, std::memory_order_release);
+		}
+
+	private:
+		static size_t roundup (size_t n)
+		{
+			size_t c = 2;
+			while (c < n) c <<= 1;
+			return c;
+		}
+
+		std::vector<TraceEvent>   _ev;
+		size_t                  _mask;
+		std::atomic<size_t>     _head;
+		std::atomic<size_t>     _tail;
+	};
+
+	/** \brief Thread safe replacement of the activity part of Commentator.
+	 *
+	 * Each thread has its own stack of activities and its own ring buffer
+	 * of start/stop/progress events: recording an event only touches
+	 * data of the calling thread. When the tracer is disabled (the
+	 * default) every call returns after a relaxed atomic load.
+	 *
+	 * collect() merges the buffers into per-thread event lists; it may be
+	 * called at any time, e.g. periodically during a long computation. A
+	 * thread whose buffer is full collects it itself (this is the only
+	 * place where a recording thread can wait).
+	 *
+	 * The events can then be exported as a hierarchical timing report
+	 * (report()) or as a Chrome trace (writeChromeTrace(), to be loaded
+	 * in chrome://tracing or Perfetto).
+	 *
+	 * Names are not copied: they must outlive the tracer (string
+	 * literals).
+	 *
+	 * If the environment variable LINBOX_TRACE is set to a file name the
+	 * default tracer() is enabled at its first use, and the trace is
+	 * written to this file at exit (see setOutputFile).
+	 \code
+	 tracer().enable();
+	 {
+	     TraceActivity act("Doing important work");
+	     for (long i = 0; i < 100; ++i) {
+	         ...
+	         tracer().progress(i+1,100);
+	     }
+	 }
+	 tracer().report(std::cout);
+	 \endcode
+	 */
+	class Tracer {
+	public:
+		/** env: name of an environment variable giving the output file;
+		 * the tracer is enabled if it is set (see setOutputFile).
+		 */
+		Tracer (size_t capacity = TRACER_BUFFER_SIZE, const char *env = NULL) :
+			_enabled(false), _capacity(capacity), _serial(newSerial()),
+			_epoch(std::chrono::steady_clock::now())
+		{
+			const char *file = env ? std::getenv(env) : NULL;
+			if (file && *file) {
+				_output = file;
+				enable();
+			}
+		}
+
+		Tracer (const Tracer&) = delete;
+		Tracer &operator= (const Tracer&) = delete;
+
+		~Tracer ()
+		{
+			if (!_output.empty()) {
+				std::ofstream out(_output.c_str());
+				if (_output.size() >= 5 && _output.compare(_output.size()-5,5,".json") == 0)
+					writeChromeTrace(out);
+				else
+					report(out);
+			}
+		}
+
+		/// to be changed outside of the traced activities
+		void enable (bool on = true) { _enabled.store(on, std::memory_order_relaxed); }
+		bool enabled () const { return _enabled.load(std::memory_order_relaxed); }
+
+		/** write the trace to file when the tracer is destroyed (empty: do
+		 * not), a Chrome trace if the name ends with ".json", the timing
+		 * report otherwise
+		 */
+		void setOutputFile (const std::string &file) { _output = file; }
+
+		/// start an activity of the calling thread, nested in the current one
+		void start (const char *name)
+		{
+			if (!enabled()) return;
+			State &S = local();
+			S.stack.push_back(name);
+			record(S, TraceEvent::START, name);
+		}
+
+		/// stop the current activity of the calling thread
+		void stop ()
+		{
+			if (!enabled()) return;
+			State &S = local();
+			if (S.stack.empty()) return;
+			const char *name = S.stack.back();
+			S.stack.pop_back();
+			record(S, TraceEvent::STOP, name);
+		}
+
+		/// k steps out of len of the current activity are done (-1: unknown)
+		void progress (long k = -1, long len = -1)
+		{
+			if (!enabled()) return;
+			State &S = local();
+			record(S, TraceEvent::PROGRESS, S.stack.empty() ? "" : S.stack.back(), k, len);
+		}
+
+		/// number of activities of the calling thread in progress
+		size_t depth ()
+		{
+			return enabled() ? local().stack.size() : 0;
+		}
+
+		/// merge the buffers of all the threads into the event lists
+		void collect ()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (size_t i = 0; i < _threads.size(); ++i)
+				_threads[i]->buffer.drain(_threads[i]->events);
+		}
+
+		/// forget all the collected events (activities in progress stay open)
+		void clear ()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (size_t i = 0; i < _threads.size(); ++i) {
+				_threads[i]->buffer.drain(_threads[i]->events);
+				_threads[i]->events.clear();
+			}
+		}
+
+		/// number of threads which recorded events (their ids are 0,1,...)
+		size_t threads () const
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			return _threads.size();
+		}
+
+		/// collected events of thread tid, in order
+		std::vector<TraceEvent> events (size_t tid) const
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			return tid < _threads.size() ? _threads[tid]->events : std::vector<TraceEvent>();
+		}
+
+		/** \brief Hierarchical timing report, one tree per thread.
+		 * Every line gives the number of calls of the activity in this
+		 * context, the total time spent in it and the time not spent in
+		 * its sub-activities. Activities still running are closed at the
+		 * last event of their thread.
+		 */
+		std::ostream &report (std::ostream &os)
+		{
+			collect();
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (size_t t = 0; t < _threads.size(); ++t) {
+				std::vector<Node> tree(1);
+				buildTree(tree, _threads[t]->events);
+				os << "thread " << t << std::endl;
+				for (std::map<std::string,size_t>::const_iterator it = tree[0].children.begin(); it != tree[0].children.end(); ++it)
+					writeNode(os, tree, it->second, 1);
+			}
+			return os;
+		}
+
+		/// Chrome trace event format (JSON), one track per thread
+		std::ostream &writeChromeTrace (std::ostream &os)
+		{
+			collect();
+			std::lock_guard<std::mutex> lock(_mutex);
+			os << "{\"traceEvents\":[";
+			bool first = true;
+			for (size_t t = 0; t < _threads.size(); ++t) {
+				const std::vector<TraceEvent> &E = _threads[t]->events;
+				for (size_t i = 0; i < E.size(); ++i) {
+					os << (first ? "\n" : ",\n") << "{\"name\":\"";
+					first = false;
+					escape(os, E[i].name);
+					os << "\",\"ph\":\"" << (E[i].kind == TraceEvent::START ? "B" : (E[i].kind == TraceEvent::STOP ? "E" : "i"))
+					   << "\",\"ts\":" << std::fixed << std::setprecision(3) << 1e-3*(double)E[i].time
+					   << ",\"pid\":0,\"tid\":" << t;
+					if (E[i].kind == TraceEvent::PROGRESS)
+						os << ",\"s\":\"t\",\"args\":{\"k\":" << E[i].k << ",\"len\":" << E[i].len << "}";
+					os << "}";
+				}
+			}
+			os << "\n]}" << std::endl;
+			return os;
+		}
+
+	private:
+		// what the tracer knows of one thread
+		struct State {
+			State (size_t capacity) : buffer(capacity) {}
+			TraceBuffer                   buffer; // written by the thread only
+			std::vector<const char *>      stack; // idem
+			std::vector<TraceEvent>       events; // collected, under _mutex
+			std::thread::id                   id;
+		};
+
+		// one activity in the context of its parents
+		struct Node {
+			Node () : name(""), calls(0), total(0), children_time(0), open(0) {}
+			const char                        *name;
+			size_t                            calls;
+			uint64_t                          total;
+			uint64_t                  children_time;
+			uint64_t                           open; // start of the running call
+			std::map<std::string,size_t>  children;
+		};
+
+		static size_t newSerial ()
+		{
+			static std::atomic<size_t> serial(0);
+			return ++serial;
+		}
+
+		uint64_t now () const
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _epoch).count();
+		}
+
+		// the state of the calling thread, registered at its first event
+		State &local ()
+		{
+			// cache of the last tracer used by the thread
+			static thread_local size_t serial = 0;
+			static thread_local State *state = NULL;
+			if (serial == _serial)
+				return *state;
+			std::lock_guard<std::mutex> lock(_mutex);
+			std::thread::id id = std::this_thread::get_id();
+			state = NULL;
+			for (size_t i = 0; i < _threads.size() && !state; ++i)
+				if (_threads[i]->id == id)
+					state = _threads[i].get();
+			if (!state) {
+				_threads.push_back(std::unique_ptr<State>(new State(_capacity)));
+				state = _threads.back().get();
+				state->id = id;
+			}
+			serial = _serial;
+			return *state;
+		}
+
+		void record (State &S, int kind, const char *name, long k = -1, long len = -1)
+		{
+			TraceEvent e;
+			e.time = now(); e.name = name; e.k = k; e.len = len; e.kind = kind;
+			if (!S.buffer.push(e)) {
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					S.buffer.drain(S.events);
+				}
+				S.buffer.push(e);
+			}
+		}
+
+		static void buildTree (std::vector<Node> &tree, const std::vector<TraceEvent> &E)
+		{
+			std::vector<size_t> path(1,0);
+			for (size_t i = 0; i < E.size(); ++i) {
+				if (E[i].kind == TraceEvent::START) {
+					std::string key(E[i].name);
+					size_t p = path.back(), c;
+					std::map<std::string,size_t>::iterator it = tree[p].children.find(key);
+					if (it == tree[p].children.end()) {
+						c = tree.size();
+						tree.push_back(Node());
+						tree[c].name = E[i].name;
+						tree[p].children[key] = c;
+					}
+					else c = it->second;
+					tree[c].open = E[i].time;
+					path.push_back(c);
+				}
+				else if (E[i].kind == TraceEvent::STOP && path.size() > 1)
+					close(tree, path, E[i].time);
+			}
+			uint64_t last = E.empty() ? 0 : E.back().time;
+			while (path.size() > 1)
+				close(tree, path, last);
+		}
+
+		static void close (std::vector<Node> &tree, std::vector<size_t> &path, uint64_t time)
+		{
+			Node &N = tree[path.back()];
+			uint64_t d = time - N.open;
+			++N.calls;
+			N.total += d;
+			path.pop_back();
+			tree[path.back()].children_time += d;
+		}
+
+		static void writeNode (std::ostream &os, const std::vector<Node> &tree, size_t n, size_t depth)
+		{
+			const Node &N = tree[n];
+			os << std::string(2*depth,' ') << std::left << std::setw((int)(40 > 2*depth ? 40-2*depth : 1)) << N.name << std::right
+			   << std::setw(8) << N.calls << (N.calls > 1 ? " calls " : " call  ")
+			   << std::fixed << std::setprecision(6) << std::setw(14) << 1e-9*(double)N.total << " s"
+			   << " (self " << 1e-9*(double)(N.total-N.children_time) << " s)" << std::endl;
+			for (std::map<std::string,size_t>::const_iterator it = N.children.begin(); it != N.children.end(); ++it)
+				writeNode(os, tree, it->second, depth+1);
+		}
+
+		static void escape (std::ostream &os, const char *s)
+		{
+			for (; *s; ++s) {
+				if (*s == '"' || *s == '\\') os << '\\' << *s;
+				else if ((unsigned char)*s < 0x20) os << ' ';
+				else os << *s;
+			}
+		}
+
+		std::atomic<bool>                      _enabled;
+		size_t                                _capacity;
+		size_t                                  _serial;
+		std::chrono::steady_clock::time_point    _epoch;
+		std::string                             _output;
+		mutable std::mutex                       _mutex;
+		std::vector<std::unique_ptr<State> >   _threads;
+	};
+
+	/// Default tracer (see Tracer for the LINBOX_TRACE environment variable)
+	inline Tracer &tracer ()
+	{
+		static Tracer internal_static_tracer(TRACER_BUFFER_SIZE, "LINBOX_TRACE");
+		return internal_static_tracer;
+	}
+
+	/// Activity of the calling thread for the lifetime of the object
+	class TraceActivity {
+	public:
+		TraceActivity (const char *name, Tracer &T = tracer()) :
+			_tracer(T), _on(T.enabled())
+		{ if (_on) _tracer.start(name); }
+
+		~TraceActivity () { if (_on) _tracer.stop(); }
+
+		TraceActivity (const TraceActivity&) = delete;
+		TraceActivity &operator= (const TraceActivity&) = delete;
+
+	private:
+		Tracer  &_tracer;
+		bool         _on;
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_tracer_H
+
+
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,:0,t0,+0,=s
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End:
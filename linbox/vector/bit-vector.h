@@ -72,7 +72,19 @@ namespace LinBox
 #else
 #pragma message "error SIZEOF_LONG not defined !"
 #endif
- 
+
+	/** Number of bits set in a word (Hamming weight).
+	*/
+	inline unsigned int PopCount(unsigned long t) {
+#ifdef __GNUC__
+		return (unsigned int) __builtin_popcountl(t);
+#else
+		unsigned int c = 0;
+		for ( ; t; t &= t - 1) ++c;
+		return c;
+#endif
+	}
+
 	/** A vector of boolean 0-1 values, stored compactly to save space.
 	 *
 	 * BitVector provides an additional iterator, word_iterator, that gives
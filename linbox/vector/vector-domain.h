@@ -66,6 +66,7 @@
 #include "linbox/util/debug.h"
 #include "linbox/vector/vector-traits.h"
 #include "linbox/util/field-axpy.h"
+#include "linbox/vector/vector-simd.h"
 
 namespace LinBox
 { /*  VectorDomainBase */
@@ -1952,6 +1952,9 @@ namespace LinBox
 
 		linbox_check (y.size () == x.size ());
 
+		if (VectorSIMD::Kernels<Field>::axpyin (field(), y, a, x))
+			return y;
+
 		for (i = y.begin (), j = x.begin (); i != y.end (); ++i, ++j)
 			field().axpyin (*i, a, *j);
 
@@ -2103,6 +2106,9 @@ namespace LinBox
 	{
 		typename Vector1::const_iterator i;
 
+		if (VectorSIMD::Kernels<Field>::dotSparseSeq (field(), res, v1, v2))
+			return res;
+
 		FieldAXPY<Field> accu(field());
 		//VectorDomainBase<Field>::accu.reset();
 
@@ -0,0 +1,786 @@
+/* linbox/vector/vector-simd.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file vector/vector-simd.h
+ * @ingroup vector
+ * @brief Vectorized dot products and axpy over word size prime fields.
+ *
+ * The kernels work on contiguous arrays of elements of
+ * Givaro::Modular<double>, Givaro::ModularBalanced<double>,
+ * Givaro::Modular<float> and Givaro::Modular<int32_t>. The floating
+ * point ones accumulate exactly in double and reduce once every \c nmax
+ * products by lane (block-wise delayed reduction); the int32_t ones
+ * accumulate in 64 bits and correct the overflows with 2^64 mod p, as
+ * FieldAXPY does.
+ *
+ * The AVX2 and AVX-512 versions are compiled whatever the compilation
+ * flags and chosen at run time from the processor (the environment
+ * variable LINBOX_SIMD=scalar|avx2 lowers the choice).
+ * -D__LINBOX_NO_SIMD_DISPATCH keeps the scalar code only.
+ *
+ * DotProductDomain (dense/dense and dense/sparse parallel dot products)
+ * and VectorDomain (sparse sequence/dense dot products and dense axpyin)
+ * use them when the vectors are contiguous: std::vector, BlasVector and
+ * BlasSubvector of stride 1.
+ *
+ * The *Lanes kernels have a modulus by lane instead: they are the
+ * arithmetic of MultiModDouble, across its primes.
+ */
+
+#ifndef __LINBOX_vector_simd_H
+#define __LINBOX_vector_simd_H
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <givaro/modular.h>
+#include <givaro/modular-balanced.h>
+
+#if !defined(__LINBOX_NO_SIMD_DISPATCH) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define __LINBOX_VECTOR_SIMD_X86
+#include <immintrin.h>
+#define __LINBOX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define __LINBOX_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+
+namespace LinBox
+{
+	template<class _Field, class _Rep> class BlasVector ;
+	template<class _Vector> class BlasSubvector ;
+
+	namespace VectorSIMD
+	{
+		/// instruction sets of the kernels
+		enum Level { SCALAR = 0, AVX2 = 1, AVX512 = 2 };
+
+		/// best level of the processor, lowered by LINBOX_SIMD
+		inline Level detectLevel ()
+		{
+			Level L = SCALAR;
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				L = AVX2;
+			if (L == AVX2 && __builtin_cpu_supports("avx512f"))
+				L = AVX512;
+#endif
+			const char *env = std::getenv("LINBOX_SIMD");
+			if (env && std::strcmp(env, "scalar") == 0) L = SCALAR;
+			if (env && std::strcmp(env, "avx2") == 0 && L > AVX2) L = AVX2;
+			return L;
+		}
+
+		inline Level &currentLevel ()
+		{
+			static Level L = detectLevel();
+			return L;
+		}
+
+		/// level of the kernels used
+		inline Level level () { return currentLevel(); }
+
+		/// uses at most L (e.g. to compare the kernels)
+		inline void setLevel (Level L) { currentLevel() = std::min(L, detectLevel()); }
+
+		/** @name Contiguous storage
+		 * pointer to the elements of v if they are contiguous, NULL otherwise
+		 */
+		//@{
+		template<class Vector>
+		inline const void *contiguous (const Vector &) { return NULL; }
+
+		template<class Element, class Alloc>
+		inline const Element *contiguous (const std::vector<Element,Alloc> &v) { return v.data(); }
+
+		template<class Field, class Rep>
+		inline const typename Field::Element *contiguous (const BlasVector<Field,Rep> &v)
+		{
+			return (v.getStride() == 1) ? v.getPointer() : NULL;
+		}
+
+		template<class Vector>
+		inline const typename Vector::Element *contiguous (const BlasSubvector<Vector> &v)
+		{
+			return (v.getStride() == 1) ? v.getPointer() : NULL;
+		}
+
+		template<class Vector>
+		inline void *mutableContiguous (Vector &) { return NULL; }
+
+		template<class Element, class Alloc>
+		inline Element *mutableContiguous (std::vector<Element,Alloc> &v) { return v.data(); }
+
+		template<class Field, class Rep>
+		inline typename Field::Element *mutableContiguous (BlasVector<Field,Rep> &v)
+		{
+			return (v.getStride() == 1) ? v.getPointer() : NULL;
+		}
+
+		/// p as a pointer to T if the elements are of type T, NULL otherwise
+		template<class T, class U>
+		inline const T *typed (const U *p) { return std::is_same<T,U>::value ? (const T*)p : NULL; }
+
+		template<class T, class U>
+		inline T *typed (U *p) { return std::is_same<T,U>::value ? (T*)p : NULL; }
+		//@}
+
+		/// modulus stored as a double, with the number of products a lane can accumulate
+		struct ModDouble {
+			double        p;
+			double     invp;
+			double     half; //!< (p-1)/2, largest balanced element
+			size_t     nmax; //!< p + nmax (p-1)^2 < 2^53
+
+			ModDouble (double pp = 2.) : p(pp), invp(1./pp), half(std::floor((pp-1)/2))
+			{
+				double m = std::floor((9007199254740992. - p)/((p-1)*(p-1)));
+				nmax = (m < 1) ? 1 : ((m > 1099511627776.) ? (size_t)1099511627776ULL : (size_t)m);
+			}
+		};
+
+		/// a mod p in [0,p), for |a| <= 2^53
+		inline double reduce (const ModDouble &M, double a)
+		{
+			double r = a - std::floor(a*M.invp)*M.p;
+			if (r < 0) r += M.p;
+			else if (r >= M.p) r -= M.p;
+			return r;
+		}
+
+		// the scalar kernels, also used for the ends of the vectors
+
+		template<class T>
+		inline double dotScalar (const ModDouble &M, double acc, const T *x, const T *y, size_t n)
+		{
+			for (size_t i = 0; i < n; ) {
+				size_t e = i + std::min(M.nmax, n-i);
+				for (; i < e; ++i)
+					acc += (double)x[i]*(double)y[i];
+				acc = reduce(M, acc);
+			}
+			return reduce(M, acc);
+		}
+
+		template<class T>
+		inline double dotGatherScalar (const ModDouble &M, double acc, const T *val, size_t vs,
+					       const size_t *idx, size_t is, const T *x, size_t n)
+		{
+			for (size_t i = 0; i < n; ) {
+				size_t e = i + std::min(M.nmax, n-i);
+				for (; i < e; ++i)
+					acc += (double)val[i*vs]*(double)x[idx[i*is]];
+				acc = reduce(M, acc);
+			}
+			return reduce(M, acc);
+		}
+
+		template<class T>
+		inline void axpyinScalar (const ModDouble &M, bool balanced, T *y, double a, const T *x, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				double r = reduce(M, (double)y[i] + a*(double)x[i]);
+				if (balanced && r > M.half) r -= M.p;
+				y[i] = (T)r;
+			}
+		}
+
+		// y+t, plus 2^64 mod p if it overflowed
+		inline uint64_t addU64 (uint64_t y, uint64_t t, uint64_t two64)
+		{
+			y += t;
+			return (y < t) ? y + two64 : y;
+		}
+
+		inline uint64_t dotU32Scalar (uint64_t acc, uint64_t two64, const int32_t *x, const int32_t *y, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				acc = addU64(acc, (uint64_t)x[i]*(uint64_t)y[i], two64);
+			return acc;
+		}
+
+		inline uint64_t dotGatherU32Scalar (uint64_t acc, uint64_t two64, const int32_t *val, size_t vs,
+						    const size_t *idx, size_t is, const int32_t *x, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				acc = addU64(acc, (uint64_t)val[i*vs]*(uint64_t)x[idx[i*is]], two64);
+			return acc;
+		}
+
+		// a modulus by lane (residue number systems): lane i modulo P[i] < 2^26.5, I[i] = 1/P[i]
+
+		inline double reduceLane (double a, double P, double I)
+		{
+			double r = a - std::floor(a*I)*P;
+			r += (r < 0) ? P : 0.;
+			return r - ((r >= P) ? P : 0.);
+		}
+
+		inline void addLanesScalar (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				double s = a[i] + b[i];
+				r[i] = s - ((s >= P[i]) ? P[i] : 0.);
+			}
+		}
+
+		inline void subLanesScalar (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				double s = a[i] - b[i];
+				r[i] = s + ((s < 0) ? P[i] : 0.);
+			}
+		}
+
+		inline void negLanesScalar (double *r, const double *a, const double *P, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				r[i] = (a[i] == 0.) ? 0. : P[i] - a[i];
+		}
+
+		inline void mulLanesScalar (double *r, const double *a, const double *b, const double *P, const double *I, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				r[i] = reduceLane(a[i]*b[i], P[i], I[i]);
+		}
+
+		inline void axpyLanesScalar (double *r, const double *a, const double *x, const double *y,
+					     const double *P, const double *I, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				r[i] = reduceLane(a[i]*x[i] + y[i], P[i], I[i]);
+		}
+
+		inline void reduceLanesScalar (double *r, const double *a, const double *P, const double *I, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				r[i] = reduceLane(a[i], P[i], I[i]);
+		}
+
+#ifdef __LINBOX_VECTOR_SIMD_X86
+		// AVX2: 4 lanes of doubles
+
+		__LINBOX_TARGET_AVX2 inline __m256d load4 (const double *x) { return _mm256_loadu_pd(x); }
+		__LINBOX_TARGET_AVX2 inline __m256d load4 (const float *x) { return _mm256_cvtps_pd(_mm_loadu_ps(x)); }
+
+		// lanes mod p, in [0,p)
+		__LINBOX_TARGET_AVX2 inline __m256d reduce4 (__m256d a, __m256d P, __m256d I)
+		{
+			__m256d q = _mm256_floor_pd(_mm256_mul_pd(a, I));
+			__m256d r = _mm256_fnmadd_pd(q, P, a);
+			r = _mm256_add_pd(r, _mm256_and_pd(P, _mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ)));
+			return _mm256_sub_pd(r, _mm256_and_pd(P, _mm256_cmp_pd(r, P, _CMP_GE_OQ)));
+		}
+
+		__LINBOX_TARGET_AVX2 inline double hsum4 (__m256d a)
+		{
+			__m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+		}
+
+		template<class T>
+		__LINBOX_TARGET_AVX2 double dotAVX2 (const ModDouble &M, const T *x, const T *y, size_t n)
+		{
+			const __m256d P = _mm256_set1_pd(M.p), I = _mm256_set1_pd(M.invp);
+			__m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+			size_t i = 0, n8 = n & ~(size_t)7;
+			size_t blk = (M.nmax < (((size_t)1)<<40)) ? 8*M.nmax : n8;
+			while (i < n8) {
+				size_t e = i + std::min(blk, n8-i);
+				for (; i < e; i += 8) {
+					a0 = _mm256_fmadd_pd(load4(x+i), load4(y+i), a0);
+					a1 = _mm256_fmadd_pd(load4(x+i+4), load4(y+i+4), a1);
+				}
+				a0 = reduce4(a0, P, I);
+				a1 = reduce4(a1, P, I);
+			}
+			double acc = reduce(M, hsum4(_mm256_add_pd(a0, a1)));
+			return dotScalar(M, acc, x+i, y+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline double dotGatherAVX2 (const ModDouble &M, const double *val, size_t vs,
+								   const size_t *idx, size_t is, const double *x, size_t n)
+		{
+			const __m256d P = _mm256_set1_pd(M.p), I = _mm256_set1_pd(M.invp);
+			const __m256i io = _mm256_set_epi64x(3*(long long)is, 2*(long long)is, (long long)is, 0);
+			const __m256i vo = _mm256_set_epi64x(3*(long long)vs, 2*(long long)vs, (long long)vs, 0);
+			__m256d a = _mm256_setzero_pd();
+			size_t i = 0, n4 = n & ~(size_t)3;
+			size_t blk = (M.nmax < (((size_t)1)<<40)) ? 4*M.nmax : n4;
+			while (i < n4) {
+				size_t e = i + std::min(blk, n4-i);
+				for (; i < e; i += 4) {
+					__m256i j = (is == 1) ? _mm256_loadu_si256((const __m256i*)(idx+i))
+						: _mm256_i64gather_epi64((const long long*)(idx+i*is), io, 8);
+					__m256d v = (vs == 1) ? _mm256_loadu_pd(val+i) : _mm256_i64gather_pd(val+i*vs, vo, 8);
+					a = _mm256_fmadd_pd(v, _mm256_i64gather_pd(x, j, 8), a);
+				}
+				a = reduce4(a, P, I);
+			}
+			double acc = reduce(M, hsum4(a));
+			return dotGatherScalar(M, acc, val+i*vs, vs, idx+i*is, is, x, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline void axpyinAVX2 (const ModDouble &M, bool balanced, double *y, double a, const double *x, size_t n)
+		{
+			const __m256d P = _mm256_set1_pd(M.p), I = _mm256_set1_pd(M.invp), H = _mm256_set1_pd(M.half);
+			const __m256d A = _mm256_set1_pd(a);
+			size_t i = 0;
+			for (; i+4 <= n; i += 4) {
+				__m256d r = reduce4(_mm256_fmadd_pd(A, _mm256_loadu_pd(x+i), _mm256_loadu_pd(y+i)), P, I);
+				if (balanced)
+					r = _mm256_sub_pd(r, _mm256_and_pd(P, _mm256_cmp_pd(r, H, _CMP_GT_OQ)));
+				_mm256_storeu_pd(y+i, r);
+			}
+			axpyinScalar(M, balanced, y+i, a, x+i, n-i);
+		}
+
+		// unsigned 64 bits lanes: s = acc+t, plus 2^64 mod p where it overflowed
+		__LINBOX_TARGET_AVX2 inline __m256i addU64x4 (__m256i acc, __m256i t, __m256i T)
+		{
+			const __m256i S = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+			__m256i s = _mm256_add_epi64(acc, t);
+			__m256i o = _mm256_cmpgt_epi64(_mm256_xor_si256(t, S), _mm256_xor_si256(s, S));
+			return _mm256_add_epi64(s, _mm256_and_si256(o, T));
+		}
+
+		__LINBOX_TARGET_AVX2 inline uint64_t foldU64x4 (__m256i a, uint64_t two64)
+		{
+			uint64_t l[4], acc = 0;
+			_mm256_storeu_si256((__m256i*)l, a);
+			for (size_t k = 0; k < 4; ++k)
+				acc = addU64(acc, l[k], two64);
+			return acc;
+		}
+
+		__LINBOX_TARGET_AVX2 inline uint64_t dotU32AVX2 (uint64_t two64, const int32_t *x, const int32_t *y, size_t n)
+		{
+			const __m256i T = _mm256_set1_epi64x((long long)two64);
+			__m256i a = _mm256_setzero_si256();
+			size_t i = 0;
+			for (; i+4 <= n; i += 4) {
+				__m256i u = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(x+i)));
+				__m256i v = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(y+i)));
+				a = addU64x4(a, _mm256_mul_epu32(u, v), T);
+			}
+			return dotU32Scalar(foldU64x4(a, two64), two64, x+i, y+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline uint64_t dotGatherU32AVX2 (uint64_t two64, const int32_t *val, size_t vs,
+									const size_t *idx, size_t is, const int32_t *x, size_t n)
+		{
+			const __m256i T = _mm256_set1_epi64x((long long)two64);
+			const __m256i io = _mm256_set_epi64x(3*(long long)is, 2*(long long)is, (long long)is, 0);
+			const __m256i vo = _mm256_set_epi64x(3*(long long)vs, 2*(long long)vs, (long long)vs, 0);
+			__m256i a = _mm256_setzero_si256();
+			size_t i = 0;
+			for (; i+4 <= n; i += 4) {
+				__m256i j = (is == 1) ? _mm256_loadu_si256((const __m256i*)(idx+i))
+					: _mm256_i64gather_epi64((const long long*)(idx+i*is), io, 8);
+				__m128i v = (vs == 1) ? _mm_loadu_si128((const __m128i*)(val+i))
+					: _mm256_i64gather_epi32((const int*)(val+i*vs), vo, 4);
+				__m128i w = _mm256_i64gather_epi32((const int*)x, j, 4);
+				a = addU64x4(a, _mm256_mul_epu32(_mm256_cvtepu32_epi64(v), _mm256_cvtepu32_epi64(w)), T);
+			}
+			return dotGatherU32Scalar(foldU64x4(a, two64), two64, val+i*vs, vs, idx+i*is, is, x, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline void addLanesAVX2 (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+			size_t i = 0;
+			for (; i+4 <= n; i += 4) {
+				__m256d p = _mm256_loadu_pd(P+i), s = _mm256_add_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i));
+				_mm256_storeu_pd(r+i, _mm256_sub_pd(s, _mm256_and_pd(p, _mm256_cmp_pd(s, p, _CMP_GE_OQ))));
+			}
+			addLanesScalar(r+i, a+i, b+i, P+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline void subLanesAVX2 (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+			size_t i = 0;
+			for (; i+4 <= n; i += 4) {
+				__m256d p = _mm256_loadu_pd(P+i), s = _mm256_sub_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i));
+				_mm256_storeu_pd(r+i, _mm256_add_pd(s, _mm256_and_pd(p, _mm256_cmp_pd(s, _mm256_setzero_pd(), _CMP_LT_OQ))));
+			}
+			subLanesScalar(r+i, a+i, b+i, P+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline void negLanesAVX2 (double *r, const double *a, const double *P, size_t n)
+		{
+			size_t i = 0;
+			for (; i+4 <= n; i += 4) {
+				__m256d x = _mm256_loadu_pd(a+i);
+				_mm256_storeu_pd(r+i, _mm256_andnot_pd(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_EQ_OQ), _mm256_sub_pd(_mm256_loadu_pd(P+i), x)));
+			}
+			negLanesScalar(r+i, a+i, P+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline void mulLanesAVX2 (double *r, const double *a, const double *b, const double *P, const double *I, size_t n)
+		{
+			size_t i = 0;
+			for (; i+4 <= n; i += 4)
+				_mm256_storeu_pd(r+i, reduce4(_mm256_mul_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i)),
+							      _mm256_loadu_pd(P+i), _mm256_loadu_pd(I+i)));
+			mulLanesScalar(r+i, a+i, b+i, P+i, I+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline void axpyLanesAVX2 (double *r, const double *a, const double *x, const double *y,
+								const double *P, const double *I, size_t n)
+		{
+			size_t i = 0;
+			for (; i+4 <= n; i += 4)
+				_mm256_storeu_pd(r+i, reduce4(_mm256_fmadd_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(x+i), _mm256_loadu_pd(y+i)),
+							      _mm256_loadu_pd(P+i), _mm256_loadu_pd(I+i)));
+			axpyLanesScalar(r+i, a+i, x+i, y+i, P+i, I+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX2 inline void reduceLanesAVX2 (double *r, const double *a, const double *P, const double *I, size_t n)
+		{
+			size_t i = 0;
+			for (; i+4 <= n; i += 4)
+				_mm256_storeu_pd(r+i, reduce4(_mm256_loadu_pd(a+i), _mm256_loadu_pd(P+i), _mm256_loadu_pd(I+i)));
+			reduceLanesScalar(r+i, a+i, P+i, I+i, n-i);
+		}
+
+		// AVX-512: 8 lanes of doubles
+
+		__LINBOX_TARGET_AVX512 inline __m512d load8 (const double *x) { return _mm512_loadu_pd(x); }
+		__LINBOX_TARGET_AVX512 inline __m512d load8 (const float *x) { return _mm512_cvtps_pd(_mm256_loadu_ps(x)); }
+
+		__LINBOX_TARGET_AVX512 inline __m512d reduce8 (__m512d a, __m512d P, __m512d I)
+		{
+			__m512d q = _mm512_roundscale_pd(_mm512_mul_pd(a, I), _MM_FROUND_TO_NEG_INF|_MM_FROUND_NO_EXC);
+			__m512d r = _mm512_fnmadd_pd(q, P, a);
+			r = _mm512_mask_add_pd(r, _mm512_cmp_pd_mask(r, _mm512_setzero_pd(), _CMP_LT_OQ), r, P);
+			return _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(r, P, _CMP_GE_OQ), r, P);
+		}
+
+		template<class T>
+		__LINBOX_TARGET_AVX512 double dotAVX512 (const ModDouble &M, const T *x, const T *y, size_t n)
+		{
+			const __m512d P = _mm512_set1_pd(M.p), I = _mm512_set1_pd(M.invp);
+			__m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+			size_t i = 0, n16 = n & ~(size_t)15;
+			size_t blk = (M.nmax < (((size_t)1)<<40)) ? 16*M.nmax : n16;
+			while (i < n16) {
+				size_t e = i + std::min(blk, n16-i);
+				for (; i < e; i += 16) {
+					a0 = _mm512_fmadd_pd(load8(x+i), load8(y+i), a0);
+					a1 = _mm512_fmadd_pd(load8(x+i+8), load8(y+i+8), a1);
+				}
+				a0 = reduce8(a0, P, I);
+				a1 = reduce8(a1, P, I);
+			}
+			double acc = reduce(M, _mm512_reduce_add_pd(_mm512_add_pd(a0, a1)));
+			return dotScalar(M, acc, x+i, y+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline double dotGatherAVX512 (const ModDouble &M, const double *val, size_t vs,
+								       const size_t *idx, size_t is, const double *x, size_t n)
+		{
+			const __m512d P = _mm512_set1_pd(M.p), I = _mm512_set1_pd(M.invp);
+			const long long i1 = (long long)is, v1 = (long long)vs;
+			const __m512i io = _mm512_set_epi64(7*i1, 6*i1, 5*i1, 4*i1, 3*i1, 2*i1, i1, 0);
+			const __m512i vo = _mm512_set_epi64(7*v1, 6*v1, 5*v1, 4*v1, 3*v1, 2*v1, v1, 0);
+			__m512d a = _mm512_setzero_pd();
+			size_t i = 0, n8 = n & ~(size_t)7;
+			size_t blk = (M.nmax < (((size_t)1)<<40)) ? 8*M.nmax : n8;
+			while (i < n8) {
+				size_t e = i + std::min(blk, n8-i);
+				for (; i < e; i += 8) {
+					__m512i j = (is == 1) ? _mm512_loadu_si512((const void*)(idx+i))
+						: _mm512_i64gather_epi64(io, (const void*)(idx+i*is), 8);
+					__m512d v = (vs == 1) ? _mm512_loadu_pd(val+i) : _mm512_i64gather_pd(vo, (const void*)(val+i*vs), 8);
+					a = _mm512_fmadd_pd(v, _mm512_i64gather_pd(j, (const void*)x, 8), a);
+				}
+				a = reduce8(a, P, I);
+			}
+			double acc = reduce(M, _mm512_reduce_add_pd(a));
+			return dotGatherScalar(M, acc, val+i*vs, vs, idx+i*is, is, x, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline void axpyinAVX512 (const ModDouble &M, bool balanced, double *y, double a, const double *x, size_t n)
+		{
+			const __m512d P = _mm512_set1_pd(M.p), I = _mm512_set1_pd(M.invp), H = _mm512_set1_pd(M.half);
+			const __m512d A = _mm512_set1_pd(a);
+			size_t i = 0;
+			for (; i+8 <= n; i += 8) {
+				__m512d r = reduce8(_mm512_fmadd_pd(A, _mm512_loadu_pd(x+i), _mm512_loadu_pd(y+i)), P, I);
+				if (balanced)
+					r = _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(r, H, _CMP_GT_OQ), r, P);
+				_mm512_storeu_pd(y+i, r);
+			}
+			axpyinScalar(M, balanced, y+i, a, x+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline void addLanesAVX512 (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+			size_t i = 0;
+			for (; i+8 <= n; i += 8) {
+				__m512d p = _mm512_loadu_pd(P+i), s = _mm512_add_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i));
+				_mm512_storeu_pd(r+i, _mm512_mask_sub_pd(s, _mm512_cmp_pd_mask(s, p, _CMP_GE_OQ), s, p));
+			}
+			addLanesScalar(r+i, a+i, b+i, P+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline void subLanesAVX512 (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+			size_t i = 0;
+			for (; i+8 <= n; i += 8) {
+				__m512d p = _mm512_loadu_pd(P+i), s = _mm512_sub_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i));
+				_mm512_storeu_pd(r+i, _mm512_mask_add_pd(s, _mm512_cmp_pd_mask(s, _mm512_setzero_pd(), _CMP_LT_OQ), s, p));
+			}
+			subLanesScalar(r+i, a+i, b+i, P+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline void negLanesAVX512 (double *r, const double *a, const double *P, size_t n)
+		{
+			size_t i = 0;
+			for (; i+8 <= n; i += 8) {
+				__m512d x = _mm512_loadu_pd(a+i);
+				_mm512_storeu_pd(r+i, _mm512_maskz_sub_pd(_mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_NEQ_OQ), _mm512_loadu_pd(P+i), x));
+			}
+			negLanesScalar(r+i, a+i, P+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline void mulLanesAVX512 (double *r, const double *a, const double *b, const double *P, const double *I, size_t n)
+		{
+			size_t i = 0;
+			for (; i+8 <= n; i += 8)
+				_mm512_storeu_pd(r+i, reduce8(_mm512_mul_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i)),
+							      _mm512_loadu_pd(P+i), _mm512_loadu_pd(I+i)));
+			mulLanesScalar(r+i, a+i, b+i, P+i, I+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline void axpyLanesAVX512 (double *r, const double *a, const double *x, const double *y,
+								    const double *P, const double *I, size_t n)
+		{
+			size_t i = 0;
+			for (; i+8 <= n; i += 8)
+				_mm512_storeu_pd(r+i, reduce8(_mm512_fmadd_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(x+i), _mm512_loadu_pd(y+i)),
+							      _mm512_loadu_pd(P+i), _mm512_loadu_pd(I+i)));
+			axpyLanesScalar(r+i, a+i, x+i, y+i, P+i, I+i, n-i);
+		}
+
+		__LINBOX_TARGET_AVX512 inline void reduceLanesAVX512 (double *r, const double *a, const double *P, const double *I, size_t n)
+		{
+			size_t i = 0;
+			for (; i+8 <= n; i += 8)
+				_mm512_storeu_pd(r+i, reduce8(_mm512_loadu_pd(a+i), _mm512_loadu_pd(P+i), _mm512_loadu_pd(I+i)));
+			reduceLanesScalar(r+i, a+i, P+i, I+i, n-i);
+		}
+#endif // __LINBOX_VECTOR_SIMD_X86
+
+		/** @name Dispatched kernels
+		 * The elements are in [0,p) or balanced, the results in [0,p) (but
+		 * for axpyin with balanced).
+		 */
+		//@{
+		/// sum x[i] y[i] mod p
+		template<class T>
+		inline double dot (const ModDouble &M, const T *x, const T *y, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return dotAVX512(M, x, y, n);
+			if (level() == AVX2) return dotAVX2(M, x, y, n);
+#endif
+			return dotScalar(M, 0., x, y, n);
+		}
+
+		/// sum val[i vs] x[idx[i is]] mod p
+		inline double dotGather (const ModDouble &M, const double *val, size_t vs,
+					 const size_t *idx, size_t is, const double *x, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return dotGatherAVX512(M, val, vs, idx, is, x, n);
+			if (level() == AVX2) return dotGatherAVX2(M, val, vs, idx, is, x, n);
+#endif
+			return dotGatherScalar(M, 0., val, vs, idx, is, x, n);
+		}
+
+		/// y <- y + a x mod p
+		inline void axpyin (const ModDouble &M, bool balanced, double *y, double a, const double *x, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return axpyinAVX512(M, balanced, y, a, x, n);
+			if (level() == AVX2) return axpyinAVX2(M, balanced, y, a, x, n);
+#endif
+			axpyinScalar(M, balanced, y, a, x, n);
+		}
+
+		/// sum x[i] y[i], congruent mod p, over elements in [0,p)
+		inline uint64_t dotU32 (uint64_t two64, const int32_t *x, const int32_t *y, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() >= AVX2) return dotU32AVX2(two64, x, y, n);
+#endif
+			return dotU32Scalar(0, two64, x, y, n);
+		}
+
+		/// sum val[i vs] x[idx[i is]], congruent mod p, over elements in [0,p)
+		inline uint64_t dotGatherU32 (uint64_t two64, const int32_t *val, size_t vs,
+					      const size_t *idx, size_t is, const int32_t *x, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() >= AVX2) return dotGatherU32AVX2(two64, val, vs, idx, is, x, n);
+#endif
+			return dotGatherU32Scalar(0, two64, val, vs, idx, is, x, n);
+		}
+		//@}
+
+		/** @name Dispatched kernels with a modulus by lane
+		 * r[i] = a[i] op b[i] mod P[i], for residues in [0,P[i]) and
+		 * P[i] < 2^26.5. The result may be one of the operands.
+		 */
+		//@{
+		inline void addLanes (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return addLanesAVX512(r, a, b, P, n);
+			if (level() == AVX2) return addLanesAVX2(r, a, b, P, n);
+#endif
+			addLanesScalar(r, a, b, P, n);
+		}
+
+		inline void subLanes (double *r, const double *a, const double *b, const double *P, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return subLanesAVX512(r, a, b, P, n);
+			if (level() == AVX2) return subLanesAVX2(r, a, b, P, n);
+#endif
+			subLanesScalar(r, a, b, P, n);
+		}
+
+		/// r = -a
+		inline void negLanes (double *r, const double *a, const double *P, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return negLanesAVX512(r, a, P, n);
+			if (level() == AVX2) return negLanesAVX2(r, a, P, n);
+#endif
+			negLanesScalar(r, a, P, n);
+		}
+
+		inline void mulLanes (double *r, const double *a, const double *b, const double *P, const double *I, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return mulLanesAVX512(r, a, b, P, I, n);
+			if (level() == AVX2) return mulLanesAVX2(r, a, b, P, I, n);
+#endif
+			mulLanesScalar(r, a, b, P, I, n);
+		}
+
+		/// r = a x + y
+		inline void axpyLanes (double *r, const double *a, const double *x, const double *y,
+				       const double *P, const double *I, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return axpyLanesAVX512(r, a, x, y, P, I, n);
+			if (level() == AVX2) return axpyLanesAVX2(r, a, x, y, P, I, n);
+#endif
+			axpyLanesScalar(r, a, x, y, P, I, n);
+		}
+
+		/// r = a mod P, for |a| <= 2^52
+		inline void reduceLanes (double *r, const double *a, const double *P, const double *I, size_t n)
+		{
+#ifdef __LINBOX_VECTOR_SIMD_X86
+			if (level() == AVX512) return reduceLanesAVX512(r, a, P, I, n);
+			if (level() == AVX2) return reduceLanesAVX2(r, a, P, I, n);
+#endif
+			reduceLanesScalar(r, a, P, I, n);
+		}
+		//@}
+
+		/// strides (in elements) of the indices and values of a sparse sequence vector
+		template<class Element>
+		struct PairLayout {
+			typedef std::pair<size_t,Element> Pair;
+			static const bool value = (sizeof(Pair) % sizeof(size_t) == 0) && (sizeof(Pair) % sizeof(Element) == 0);
+			static const size_t is = sizeof(Pair)/sizeof(size_t);
+			static const size_t vs = sizeof(Pair)/sizeof(Element);
+		};
+
+		/** \brief Kernels of VectorDomain for a field.
+		 * The functions return false when they do not apply (the caller
+		 * then runs its generic code).
+		 */
+		template<class Field>
+		struct Kernels {
+			template<class Vector1, class Vector2>
+			static bool dotSparseSeq (const Field &, typename Field::Element &, const Vector1 &, const Vector2 &) { return false; }
+			template<class Vector1, class Vector2>
+			static bool axpyin (const Field &, Vector1 &, const typename Field::Element &, const Vector2 &) { return false; }
+		};
+
+		template<bool Balanced, class Field>
+		struct KernelsDouble {
+			template<class Vector1, class Vector2>
+			static bool dotSparseSeq (const Field &, double &, const Vector1 &, const Vector2 &) { return false; }
+
+			template<class Alloc, class Vector2>
+			static bool dotSparseSeq (const Field &F, double &res, const std::vector<std::pair<size_t,double>,Alloc> &v1, const Vector2 &v2)
+			{
+				typedef PairLayout<double> L;
+				const double *x = typed<double>(contiguous(v2));
+				if (!L::value || !x) return false;
+				if (v1.empty()) {
+					F.assign(res, F.zero);
+					return true;
+				}
+				ModDouble M(F.characteristic());
+				F.init(res, dotGather(M, &(v1[0].second), L::vs, &(v1[0].first), L::is, x, v1.size()));
+				return true;
+			}
+
+			template<class Vector1, class Vector2>
+			static bool axpyin (const Field &F, Vector1 &y, const double &a, const Vector2 &x)
+			{
+				double *py = typed<double>(mutableContiguous(y));
+				const double *px = typed<double>(contiguous(x));
+				double p = F.characteristic();
+				if (!py || !px || (Balanced && std::fmod(p, 2.) == 0)) return false;
+				VectorSIMD::axpyin(ModDouble(p), Balanced, py, a, px, y.size());
+				return true;
+			}
+		};
+
+		template<> struct Kernels<Givaro::Modular<double> > : public KernelsDouble<false,Givaro::Modular<double> > {};
+		template<> struct Kernels<Givaro::ModularBalanced<double> > : public KernelsDouble<true,Givaro::ModularBalanced<double> > {};
+
+	} // VectorSIMD
+} // LinBox
+
+#endif // __LINBOX_vector_simd_H
+
+// vim:sts=8:sw=8:ts=8:noet:sr:cino=>s,f0,{0,g0,(0,:0,t0,+0,=s
+// Local Variables:
+// mode: C++
+// tab-width: 8
+// indent-tabs-mode: nil
+// c-basic-offset: 8
+// End: